@@ -0,0 +1,37 @@
+#version 430 core
+
+layout (location=0) in vec3 P;
+layout (location=1) in float T;
+layout (location=7) in uint drawIndex;
+
+#include "transforms.glsl"
+
+struct MeshParameters {
+    mat4 model;
+    vec4 color;
+    uint system;
+    uint first;
+    uint stride;
+    uint length;
+    uint mode;
+};
+
+layout (std430, binding=0) readonly buffer Meshes {
+    MeshParameters meshes[];
+};
+
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
+
+smooth out float segment;
+flat out vec4 tint;
+
+void main()
+{
+    segment = T;
+    tint = meshes[drawIndex].color;
+    gl_Position = MVP * meshes[drawIndex].model * vec4(toCartesian(meshes[drawIndex].system, P), 1.0);
+}
@@ -3,7 +3,11 @@
 layout (location=0) in vec3 P;
 layout (location=1) in float T;
 
-uniform mat4 MVP;
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
 
 smooth out float segment;
 
@@ -2,21 +2,22 @@
 
 layout (location=0) out vec4 fragColor;
 
+// Distance from the center of the grid at which lines fade to half
+uniform vec3 gridCenter;
+uniform float gridFade;
+
 in vec3 pos;
+flat in int normalAxis;
 
 void main()
 {
-    float d = 1.0 / (1.0 + length(pos));
-    if (pos.x == 0.0 && pos.y == 0.0)
-        fragColor = vec4(0.5, 0.5, 0.5, d)*d;
-    else if (pos.x == 0.0 && pos.z == 0.0)
-        fragColor = vec4(0.5, 0.5, 0.5, d)*d;
-    else if (pos.y == 0.0 && pos.z == 0.0)
+    float d = 1.0 / (1.0 + length(pos - gridCenter) / gridFade);
+    if (normalAxis < 0)
         fragColor = vec4(0.5, 0.5, 0.5, d)*d;
-    else if (pos.x == 0.0)
+    else if (normalAxis == 0)
         fragColor = vec4(0.7, 0.0, 0.0, d)*d;
-    else if (pos.y == 0.0)
+    else if (normalAxis == 1)
         fragColor = vec4(0.0, 0.7, 0.0, d)*d;
-    else if (pos.z == 0.0)
+    else
         fragColor = vec4(0.0, 0.5, 0.8, d)*d;
 }
@@ -1,13 +1,50 @@
 #version 420 core
 
-layout (location=0) in vec3 P;
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
 
-uniform mat4 MVP;
+// Lines at gridMin + i * gridSpacing up to gridMax on every axis, in the three planes through gridPlanes
+uniform vec3 gridMin;
+uniform vec3 gridMax;
+uniform vec3 gridPlanes;
+uniform float gridSpacing;
 
 out vec3 pos;
+flat out int normalAxis; // of the plane, -1 for lines on the intersection of two planes
 
 void main()
 {
+    const ivec3 lineCounts = ivec3(round((gridMax - gridMin) / gridSpacing)) + 1;
+
+    // Two vertices per line, per plane first the lines along u, then the ones along v
+    int line = gl_VertexID / 2;
+    const bool last = (gl_VertexID & 1) == 1;
+
+    vec3 P = vec3(0.0);
+    normalAxis = 0;
+    for (int k = 0; k < 3; k++) {
+        const int u = (k + 1) % 3;
+        const int v = (k + 2) % 3;
+        const int along = (line < lineCounts[v]) ? u : v;
+        const int across = (along == u) ? v : u;
+        const int index = (along == u) ? line : line - lineCounts[v];
+
+        if (index < lineCounts[across]) {
+            normalAxis = k;
+            P[k] = gridPlanes[k];
+            P[across] = gridMin[across] + float(index) * gridSpacing;
+            P[along] = last ? gridMax[along] : gridMin[along];
+
+            if (abs(P[across] - gridPlanes[across]) < 1e-3 * gridSpacing)
+                normalAxis = -1;
+            break;
+        }
+        line -= lineCounts[u] + lineCounts[v];
+    }
+
     pos = P;
     gl_Position = MVP * vec4(P, 1.0);
 }
@@ -0,0 +1,9 @@
+#version 430 core
+
+// Added up by the blending
+layout (location=0) out float count;
+
+void main()
+{
+    count = 1.0;
+}
@@ -0,0 +1,31 @@
+#version 430 core
+
+layout (location=0) in vec3 P;
+layout (location=7) in uint drawIndex;
+
+#include "transforms.glsl"
+
+struct MeshParameters {
+    mat4 model;
+    vec4 color;
+    uint system;
+    uint first;
+    uint stride;
+    uint length;
+    uint mode;
+};
+
+layout (std430, binding=0) readonly buffer Meshes {
+    MeshParameters meshes[];
+};
+
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
+
+void main()
+{
+    gl_Position = MVP * meshes[drawIndex].model * vec4(toCartesian(meshes[drawIndex].system, P), 1.0);
+}
@@ -0,0 +1,36 @@
+#version 430 core
+
+layout (location=0) out vec4 fragColor;
+
+layout (binding=0) uniform sampler2D counts;
+
+layout (std430, binding=3) readonly buffer Maximum {
+    uint maximum;
+};
+
+// Inferno-like, from few to most points
+const vec3 COLORMAP[5] = vec3[](
+    vec3(0.00, 0.00, 0.02),
+    vec3(0.34, 0.06, 0.43),
+    vec3(0.74, 0.22, 0.33),
+    vec3(0.98, 0.56, 0.04),
+    vec3(0.99, 1.00, 0.64)
+);
+
+vec3 colormap(float level)
+{
+    const float x = clamp(level, 0.0, 1.0) * 4.0;
+    const int i = min(int(x), 3);
+    return mix(COLORMAP[i], COLORMAP[i + 1], x - float(i));
+}
+
+void main()
+{
+    const float count = texelFetch(counts, ivec2(gl_FragCoord.xy), 0).r;
+    if (count <= 0.0)
+        discard;
+
+    // Logarithmic, so single points stay visible next to the densest pixel, lifted off the black background
+    const float level = log(1.0 + count) / log(1.0 + max(uintBitsToFloat(maximum), 1.0));
+    fragColor = vec4(colormap(0.2 + 0.8 * level), 1.0);
+}
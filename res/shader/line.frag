@@ -0,0 +1,37 @@
+#version 430 core
+
+layout (location=0) out vec4 fragColor;
+
+noperspective in vec2 local;
+flat in float segmentLength;
+flat in vec2 rounded;
+smooth in float segment;
+flat in vec4 tint;
+
+uniform float width; // in pixels
+
+
+vec3 hsv2rgb(vec3 c) {
+    vec4 K = vec4(1.0, 2.0 / 3.0, 1.0 / 3.0, 3.0);
+    vec3 p = abs(fract(c.xxx + K.xyz) * 6.0 - K.www);
+    return c.z * mix(K.xxx, clamp(p - K.xxx, 0.0, 1.0), c.y);
+}
+
+
+void main()
+{
+    // Distance to the segment in pixels, to its end points beyond round ends
+    float distance = abs(local.y);
+    if (rounded.x > 0.0 && local.x < 0.0)
+        distance = length(local);
+    else if (rounded.y > 0.0 && local.x > segmentLength)
+        distance = length(vec2(local.x - segmentLength, local.y));
+
+    // Covered part of a pixel centred at that distance from the edge
+    const float coverage = clamp(0.5 * width + 0.5 - distance, 0.0, 1.0);
+    if (coverage <= 0.0)
+        discard;
+
+    const vec4 color = vec4(hsv2rgb(vec3(segment, 1.0, 1.0)), 1.0) * tint;
+    fragColor = vec4(color.rgb, color.a * coverage);
+}
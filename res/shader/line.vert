@@ -0,0 +1,171 @@
+#version 430 core
+
+layout (location=7) in uint drawIndex;
+
+#include "transforms.glsl"
+
+struct MeshParameters {
+    mat4 model;
+    vec4 color;
+    uint system;
+    uint first;
+    uint stride;
+    uint length;
+    uint mode;
+};
+
+layout (std430, binding=0) readonly buffer Meshes {
+    MeshParameters meshes[];
+};
+
+layout (std430, binding=2) readonly buffer Arena {
+    float vertices[];
+};
+
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
+
+uniform float width; // in pixels
+
+noperspective out vec2 local; // along and across the segment, in pixels from its start
+flat out float segmentLength;
+flat out vec2 rounded;        // whether the start and the end are capped round
+smooth out float segment;
+flat out vec4 tint;
+
+const uint NONE = 0xFFFFFFFFu;
+const uint LINES = 0x0001u;
+const uint LINE_LOOP = 0x0002u;
+
+// Corners of the two triangles of a segment quad: end (0 start, 1 end) and side
+const uint ENDS[6] = uint[](0u, 1u, 0u, 0u, 1u, 1u);
+const float SIDES[6] = float[](-1.0, -1.0, 1.0, 1.0, -1.0, 1.0);
+
+// Neighbours turning sharper than this are joined round instead of mitered
+const float MITER_LIMIT = 2.0;
+
+
+vec4 project(MeshParameters mesh, uint index)
+{
+    const uint offset = mesh.first + index * mesh.stride;
+    const vec3 P = vec3(vertices[offset], vertices[offset + 1], vertices[offset + 2]);
+    return MVP * mesh.model * vec4(toCartesian(mesh.system, P), 1.0);
+}
+
+vec2 toPixels(vec4 clip)
+{
+    return (clip.xy / clip.w * 0.5 + 0.5) * viewport.xy;
+}
+
+/**
+ * Screen direction from a to b, or 0 if one of them is behind the camera or they coincide.
+ */
+vec2 direction(vec4 a, vec4 b)
+{
+    if (a.w <= 0.0 || b.w <= 0.0)
+        return vec2(0.0);
+    const vec2 d = toPixels(b) - toPixels(a);
+    return dot(d, d) > 1e-6 ? normalize(d) : vec2(0.0);
+}
+
+/**
+ * Whether the segment along d with normal n is joined to its neighbour along other by a miter, which points along
+ * the bisector of both normals and ends scale half widths away, so that both segments share its corners.
+ */
+bool isMitered(vec2 d, vec2 n, vec2 other, out vec2 miter, out float scale)
+{
+    miter = n;
+    scale = 1.0;
+    if (other == vec2(0.0) || dot(d, other) <= -0.99)
+        return false;
+
+    const vec2 tangent = normalize(d + other);
+    miter = vec2(-tangent.y, tangent.x);
+    scale = 1.0 / dot(miter, n);
+    return scale <= MITER_LIMIT;
+}
+
+
+void main()
+{
+    const MeshParameters mesh = meshes[drawIndex];
+    const uint s = uint(gl_VertexID) / 6u;
+    const uint corner = uint(gl_VertexID) % 6u;
+
+    // Vertices of the segment and the ones before and after it
+    uint a, b, before, after;
+    if (mesh.mode == LINES) {
+        a = 2u * s;
+        b = a + 1u;
+        before = NONE;
+        after = NONE;
+    }
+    else if (mesh.mode == LINE_LOOP) {
+        a = s;
+        b = (s + 1u) % mesh.length;
+        before = (s + mesh.length - 1u) % mesh.length;
+        after = (s + 2u) % mesh.length;
+    }
+    else {
+        a = s;
+        b = s + 1u;
+        before = s > 0u ? s - 1u : NONE;
+        after = b + 1u < mesh.length ? b + 1u : NONE;
+    }
+
+    vec4 A = project(mesh, a);
+    vec4 B = project(mesh, b);
+
+    // Clipped against w = epsilon, so the segment has a screen direction even if it leaves the view towards the camera
+    const float EPSILON = 1e-5;
+    if (A.w < EPSILON && B.w < EPSILON) {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        return;
+    }
+    if (A.w < EPSILON)
+        A = mix(A, B, (EPSILON - A.w) / (B.w - A.w));
+    if (B.w < EPSILON)
+        B = mix(B, A, (EPSILON - B.w) / (A.w - B.w));
+
+    const vec2 pa = toPixels(A);
+    const vec2 pb = toPixels(B);
+    segmentLength = length(pb - pa);
+    const vec2 d = segmentLength > 1e-3 ? (pb - pa) / segmentLength : vec2(1.0, 0.0);
+    const vec2 n = vec2(-d.y, d.x);
+
+    // Half the width plus a pixel for the antialiased edge
+    const float halfWidth = 0.5 * width + 1.0;
+
+    const uint end = ENDS[corner];
+    const float side = SIDES[corner];
+    const vec4 clip = end == 0u ? A : B;
+    const vec2 center = end == 0u ? pa : pb;
+
+    // Directions of the neighbouring segments, 0 at the ends of strips
+    const bool valid = segmentLength > 1e-3;
+    const vec2 previous = before == NONE || !valid ? vec2(0.0) : direction(project(mesh, before), A);
+    const vec2 next = after == NONE || !valid ? vec2(0.0) : direction(B, project(mesh, after));
+
+    vec2 miter;
+    float scale;
+    rounded = vec2(!isMitered(d, n, previous, miter, scale), !isMitered(d, n, next, miter, scale));
+
+    vec2 offset;
+    if (end == 0u ? rounded.x > 0.0 : rounded.y > 0.0)
+        offset = side * halfWidth * n + (end == 0u ? -halfWidth : halfWidth) * d;
+    else {
+        isMitered(d, n, end == 0u ? previous : next, miter, scale);
+        offset = side * halfWidth * scale * miter;
+    }
+
+    const vec2 position = center + offset;
+    local = vec2(dot(position - pa, d), dot(position - pa, n));
+
+    const uint index = end == 0u ? a : b;
+    segment = mesh.stride > 3u ? vertices[mesh.first + index * mesh.stride + 3u] : 0.0;
+    tint = mesh.color;
+    gl_Position = vec4((position / viewport.xy * 2.0 - 1.0) * clip.w, clip.zw);
+}
@@ -0,0 +1,18 @@
+#version 430 core
+
+layout (location=0) in vec3 P;
+layout (location=1) in float T;
+
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
+
+smooth out float segment;
+
+void main()
+{
+    segment = T;
+    gl_Position = MVP * vec4(P, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 430 core
+
+layout (location=0) out vec4 fragColor;
+
+smooth in float segment;
+smooth in vec3 normal;
+
+// In world space, from above and in front
+const vec3 LIGHT = normalize(vec3(0.4, 0.6, 0.7));
+
+
+vec3 hsv2rgb(vec3 c) {
+    vec4 K = vec4(1.0, 2.0 / 3.0, 1.0 / 3.0, 3.0);
+    vec3 p = abs(fract(c.xxx + K.xyz) * 6.0 - K.www);
+    return c.z * mix(K.xxx, clamp(p - K.xxx, 0.0, 1.0), c.y);
+}
+
+
+void main()
+{
+    // Two-sided, ribbons are seen from both sides
+    const float diffuse = abs(dot(normalize(normal), LIGHT));
+    fragColor = vec4(hsv2rgb(vec3(segment, 1.0, 1.0)) * (0.3 + 0.7 * diffuse), 1.0);
+}
@@ -0,0 +1,64 @@
+#version 430 core
+
+struct CurveFrame {
+    float x, y, z;
+    float t;
+    uint tangent;
+    uint normal;
+};
+
+layout (std430, binding=1) readonly buffer Frames {
+    CurveFrame frames[];
+};
+
+layout (std140, binding=0) uniform Frame {
+    mat4 MVP;
+    vec4 viewport;
+    float time;
+};
+
+uniform float radius;
+uniform uint sides; // around the tube, 0 for a ribbon
+
+smooth out float segment;
+smooth out vec3 normal;
+
+
+vec3 unpackDirection(uint bits)
+{
+    vec2 p = unpackSnorm2x16(bits);
+    vec3 v = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    if (v.z < 0.0)
+        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(v);
+}
+
+
+// Instance i is the segment from sample i to i + 1, a triangle strip alternating between both ends
+void main()
+{
+    const uint end = uint(gl_VertexID) & 1u;
+    const uint k = uint(gl_VertexID) >> 1;
+    const CurveFrame frame = frames[gl_InstanceID + end];
+
+    const vec3 T = unpackDirection(frame.tangent);
+    vec3 N = unpackDirection(frame.normal);
+    // The normal flips at inflection points, turn the far end by half a turn so the segment does not twist
+    if (end == 1u && dot(N, unpackDirection(frames[gl_InstanceID].normal)) < 0.0)
+        N = -N;
+    const vec3 B = cross(T, N);
+
+    vec3 offset;
+    if (sides == 0u) {
+        offset = (k == 0u ? -radius : radius) * N;
+        normal = B;
+    }
+    else {
+        const float angle = 6.28318530718 * float(k) / float(sides);
+        normal = cos(angle) * N + sin(angle) * B;
+        offset = radius * normal;
+    }
+
+    segment = frame.t;
+    gl_Position = MVP * vec4(vec3(frame.x, frame.y, frame.z) + offset, 1.0);
+}
@@ -0,0 +1,33 @@
+#include "Bounds.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <mutex>
+
+
+// Vertices per parallel chunk
+static constexpr u64 BOUNDS_GRAIN = 1 << 15;
+
+
+Bounds Bounds::compute( const f32 *vertices, const u64 count, const u32 stride )
+{
+    Bounds bounds;
+    std::mutex mutex;
+
+    ThreadPool::getShared().parallelFor(0, count, BOUNDS_GRAIN, [&]( const u64 first, const u64 last ) {
+        // Branchless compare and select per component, which the compiler turns into packed min/max
+        const Bounds empty;
+        f32 low[3] = { empty.min.x, empty.min.y, empty.min.z };
+        f32 high[3] = { empty.max.x, empty.max.y, empty.max.z };
+        for (u64 i = first; i < last; i++) {
+            const f32 *const v = vertices + i * stride;
+            for (u32 c = 0; c < 3; c++) {
+                low[c] = (v[c] < low[c]) ? v[c] : low[c];
+                high[c] = (v[c] > high[c]) ? v[c] : high[c];
+            }
+        }
+
+        std::lock_guard lock(mutex);
+        bounds.extend(Bounds{ { low[0], low[1], low[2] }, { high[0], high[1], high[2] } });
+    });
+
+    return bounds;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <limits>
+#include <glm/glm.hpp>
+#include "defines.hpp"
+
+
+/**
+ * Axis aligned bounding box, empty until extended by a point.
+ */
+struct Bounds {
+    glm::fvec3 min{ std::numeric_limits<f32>::max() };
+    glm::fvec3 max{ std::numeric_limits<f32>::lowest() };
+
+    bool isEmpty() const noexcept { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    void extend( const glm::fvec3 &point ) noexcept
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void extend( const Bounds &bounds ) noexcept
+    {
+        min = glm::min(min, bounds.min);
+        max = glm::max(max, bounds.max);
+    }
+
+    /**
+     * Bounds of the first three components of count vertices of stride floats, in parallel.
+     */
+    static Bounds compute( const f32 *vertices, u64 count, u32 stride );
+};
@@ -0,0 +1,129 @@
+#include "CoordinateSystem.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+// Vertices per parallel chunk
+static constexpr u64 TRANSFORM_GRAIN = 1 << 14;
+
+
+/*
+ * Each conversion as CPU function and, right below, as GLSL expression of P.
+ */
+struct Cartesian {
+    static void apply( f32 &, f32 &, f32 & ) { }
+    static constexpr const char *GLSL = "P";
+};
+
+struct Spherical {
+    static void apply( f32 &x, f32 &y, f32 &z )
+    {
+        const f32 radius = x;
+        const f32 elevation = y;
+        const f32 azimuth = z;
+        x = radius * std::cos(elevation) * std::cos(azimuth);
+        y = radius * std::cos(elevation) * std::sin(azimuth);
+        z = radius * std::sin(elevation);
+    }
+    static constexpr const char *GLSL = "vec3(P.x * cos(P.y) * cos(P.z), P.x * cos(P.y) * sin(P.z), P.x * sin(P.y))";
+};
+
+struct Cylindrical {
+    static void apply( f32 &x, f32 &y, f32 & )
+    {
+        const f32 radius = x;
+        const f32 angle = y;
+        x = radius * std::cos(angle);
+        y = radius * std::sin(angle);
+    }
+    static constexpr const char *GLSL = "vec3(P.x * cos(P.y), P.x * sin(P.y), P.z)";
+};
+
+struct Polar {
+    static void apply( f32 &x, f32 &y, f32 &z )
+    {
+        Cylindrical::apply(x, y, z);
+        z = 0.0f;
+    }
+    static constexpr const char *GLSL = "vec3(P.x * cos(P.y), P.x * sin(P.y), 0.0)";
+};
+
+struct Logarithmic {
+    static f32 scale( const f32 v ) { return std::copysign(std::log10(1.0f + std::abs(v)), v); }
+
+    static void apply( f32 &x, f32 &y, f32 &z )
+    {
+        x = scale(x);
+        y = scale(y);
+        z = scale(z);
+    }
+    static constexpr const char *GLSL = "sign(P) * log2(1.0 + abs(P)) * 0.30102999566";
+};
+
+
+template<typename System>
+static void convert( f32 *vertices, const u64 count, const u32 stride )
+{
+    for (u64 i = 0; i < count; i++) {
+        f32 *const v = vertices + i * stride;
+        System::apply(v[0], v[1], v[2]);
+    }
+}
+
+static constexpr CoordinateTransform TRANSFORMS[] = {
+    { CoordinateSystem::Cartesian, "cartesian", &convert<Cartesian>, Cartesian::GLSL },
+    { CoordinateSystem::Spherical, "spherical", &convert<Spherical>, Spherical::GLSL },
+    { CoordinateSystem::Cylindrical, "cylindrical", &convert<Cylindrical>, Cylindrical::GLSL },
+    { CoordinateSystem::Polar, "polar", &convert<Polar>, Polar::GLSL },
+    { CoordinateSystem::Logarithmic, "log", &convert<Logarithmic>, Logarithmic::GLSL }
+};
+
+static_assert([] {
+    for (u32 i = 0; i < std::size(TRANSFORMS); i++) {
+        if (static_cast<u32>(TRANSFORMS[i].system) != i)
+            return false;
+    }
+    return true;
+}(), "TRANSFORMS has to be in the order of CoordinateSystem");
+
+
+std::span<const CoordinateTransform> CoordinateTransforms::getAll() noexcept
+{
+    return TRANSFORMS;
+}
+
+const CoordinateTransform &CoordinateTransforms::get( const CoordinateSystem system ) noexcept
+{
+    return TRANSFORMS[static_cast<u32>(system)];
+}
+
+const CoordinateTransform *CoordinateTransforms::find( const std::string &name ) noexcept
+{
+    const auto it = std::find_if(std::begin(TRANSFORMS), std::end(TRANSFORMS), [&name]( const CoordinateTransform &transform ) {
+        return name == transform.name;
+    });
+    return (it == std::end(TRANSFORMS)) ? nullptr : &*it;
+}
+
+void CoordinateTransforms::toCartesian( const CoordinateSystem system, f32 *vertices, const u64 count, const u32 stride )
+{
+    if (system == CoordinateSystem::Cartesian)
+        return;
+
+    const auto kernel = get(system).toCartesian;
+    ThreadPool::getShared().parallelFor(0, count, TRANSFORM_GRAIN, [=]( const u64 first, const u64 last ) {
+        kernel(vertices + first * stride, last - first, stride);
+    });
+}
+
+std::string CoordinateTransforms::generateGLSL()
+{
+    std::string source = "vec3 toCartesian(uint system, vec3 P)\n{\n    switch (system) {\n";
+    for (const CoordinateTransform &transform : TRANSFORMS) {
+        source += "        case " + std::to_string(static_cast<u32>(transform.system)) + "u: return " + transform.glsl + "; // "
+                  + transform.name + '\n';
+    }
+    source += "    }\n    return P;\n}\n";
+    return source;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <span>
+#include <string>
+
+#include "defines.hpp"
+
+
+/**
+ * Coordinate system the three spatial columns of a mesh are given in. Values index CoordinateTransforms::getAll().
+ */
+enum class CoordinateSystem : u32 {
+    Cartesian,   // (x, y, z)
+    Spherical,   // (radius, elevation, azimuth), angles in radians
+    Cylindrical, // (radius, angle, z)
+    Polar,       // (radius, angle) in the xy-plane, the third column is ignored
+    Logarithmic  // sign(v) * log10(1 + |v|) on every axis, defined for negative values as well
+};
+
+
+/**
+ * Conversion of one CoordinateSystem into cartesian coordinates, on the CPU and on the GPU.
+ */
+struct CoordinateTransform {
+    CoordinateSystem system;
+    const char *name; // e.g. for the command line
+
+    /**
+     * Converts the first three components of count vertices of stride floats in place.
+     */
+    void (*toCartesian)( f32 *vertices, u64 count, u32 stride );
+
+    const char *glsl; // the same conversion as GLSL expression of vec3 P
+};
+
+
+/**
+ * Registry of all coordinate transforms.<br>
+ * Every transform is written once as CPU kernel and once as GLSL, side by side in CoordinateSystem.cpp.<br>
+ * plotty-bench transforms checks the CPU kernels, plotty-check transforms compares them with the GLSL.<br>
+ * Vertex shaders get all of them as <code>vec3 toCartesian(uint system, vec3 P)</code> through
+ * <code>#include "transforms.glsl"</code>, see Shader::defineInclude.
+ */
+class CoordinateTransforms {
+public:
+    static std::span<const CoordinateTransform> getAll() noexcept;
+
+    static const CoordinateTransform &get( CoordinateSystem system ) noexcept;
+
+    /**
+     * @return nullptr if there is no transform called name
+     */
+    static const CoordinateTransform *find( const std::string &name ) noexcept;
+
+    /**
+     * Converts vertices in place, in parallel on the shared ThreadPool.
+     */
+    static void toCartesian( CoordinateSystem system, f32 *vertices, u64 count, u32 stride );
+
+    /**
+     * Source of the GLSL function toCartesian(system, P), switching over all transforms.
+     */
+    static std::string generateGLSL();
+};
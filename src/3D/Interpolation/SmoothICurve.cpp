@@ -1,5 +1,21 @@
 #include "SmoothICurve.hpp"
+#include "3D/LocalFrames.hpp"
+#include "Memory/ScratchArena.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <limits>
+
+// Evenly spaced samples per segment the closest point search starts from, and its Newton iterations
+constexpr u32 CLOSEST_SAMPLES = 4;
+constexpr u32 CLOSEST_ITERATIONS = 6;
+
+// Squared deviation from the chord relative to its squared length, below which a segment counts as straight
+constexpr f32 CLOSEST_STRAIGHT = 1.0f / 64.0f;
+
+// Segments from which batches of queries are sorted first, smaller trees stay cached in any order
+constexpr u32 CLOSEST_SORTED = 1 << 14;
 
 u32 bisect( const std::vector<f32> &values, const f32 t )
 {
@@ -21,8 +37,9 @@ u32 bisect( const std::vector<f32> &values, const f32 t )
 SmoothICurve::SmoothICurve( const CSVFile &csv,
                             const std::vector<std::pair<std::string, f32>> &columns,
                             const std::pair<std::string, f32> &time_and_scale,
-                            const bool cyclic )
-    : Mesh(csv, columns, cyclic ? GL_LINE_LOOP : GL_LINE_STRIP)
+                            const bool cyclic,
+                            const CoordinateSystem system )
+    : Mesh(csv, columns, cyclic ? GL_LINE_LOOP : GL_LINE_STRIP, system)
     , t_start(0.0f), t_end(0.0f)
     , m_cyclic(cyclic)
 {
@@ -46,8 +63,9 @@ SmoothICurve::SmoothICurve( const CSVFile &csv,
                             const std::pair<std::string, f32> &Y,
                             const std::pair<std::string, f32> &Z,
                             const Mesh *mesh,
-                            const bool cyclic )
-    : Mesh(csv, T, X, Y, Z, mesh, cyclic ? GL_LINE_LOOP : GL_LINE_STRIP)
+                            const bool cyclic,
+                            const CoordinateSystem system )
+    : Mesh(csv, T, X, Y, Z, mesh, cyclic ? GL_LINE_LOOP : GL_LINE_STRIP, system)
     , t_start(0.0f), t_end(0.0f)
     , m_cyclic(cyclic)
 {
@@ -65,19 +83,31 @@ SmoothICurve::SmoothICurve( const CSVFile &csv,
         calculateNaturalSpline();
 }
 
+SmoothICurve::SmoothICurve( std::vector<f32> &&vertices, const u32 stride,
+                            std::vector<f32> &&time,
+                            std::vector<glm::fvec3> &&moments,
+                            const bool cyclic )
+    : Mesh(std::move(vertices), stride, cyclic ? GL_LINE_LOOP : GL_LINE_STRIP)
+    , m_time(std::move(time))
+    , spline_M(std::move(moments))
+    , t_start(m_time.empty() ? 0.0f : m_time.front())
+    , t_end(m_time.empty() ? 0.0f : m_time.back())
+    , m_cyclic(cyclic)
+{}
+
 
 void SmoothICurve::generateTime( const CSVFile &csv, const std::pair<std::string, f32> &T )
 {
     m_time.resize(csv.getRowCount());
-    if (auto *time_col = csv.getColumn(T.first)) {
+    if (auto *time_col = csv.getValues(T.first)) {
         // time_col exists
-        t_start = std::stof(time_col->at(0)) * T.second;
+        t_start = (*time_col)[0] * T.second;
         m_time[0] = t_start;
 
         for (u32 r = 1; r < csv.getRowCount() - 1; r++)
-            m_time[r] = std::stof(time_col->at(r)) * T.second;
+            m_time[r] = (*time_col)[r] * T.second;
 
-        t_end = std::stof(time_col->at(csv.getRowCount() - 1)) * T.second;
+        t_end = (*time_col)[csv.getRowCount() - 1] * T.second;
         m_time[csv.getRowCount() - 1] = t_end;
     }
     else {
@@ -91,12 +121,14 @@ void SmoothICurve::generateTime( const CSVFile &csv, const std::pair<std::string
 
 void SmoothICurve::calculateCyclicSpline()
 {
+    const ScratchArena scratch;
+
     // Representing the differences in the time
-    std::vector<f32> h;
+    std::pmr::vector<f32> h(scratch.getResource());
 
     // Representing tridiagonal symmetric momentum matrix (Diagonal, last row)
-    std::vector<f32> d;
-    std::vector<f32> bottom;
+    std::pmr::vector<f32> d(scratch.getResource());
+    std::pmr::vector<f32> bottom(scratch.getResource());
 
     const u32 n = m_time.size() - 1;
     d.resize(n - 1);
@@ -159,11 +191,13 @@ void SmoothICurve::calculateCyclicSpline()
 
 void SmoothICurve::calculateNaturalSpline()
 {
+    const ScratchArena scratch;
+
     // Representing the differences in the time
-    std::vector<f32> h;
+    std::pmr::vector<f32> h(scratch.getResource());
 
     // Representing tridiagonal symmetric momentum matrix (Diagonal)
-    std::vector<f32> d;
+    std::pmr::vector<f32> d(scratch.getResource());
 
     const u32 n = m_time.size() - 1;
     d.resize(n - 1);
@@ -401,3 +435,411 @@ glm::fvec4 SmoothICurve::transform( const f32 t, const glm::fvec4 &direction ) c
     const glm::fmat4 M = getOrthonormalFrame(t);
     return M * direction;
 }
+
+u32 SmoothICurve::placeRun( u32 &segment, const f32 *times, f32 *vertices, const u32 count, const u32 stride ) const
+{
+    f32 t = times[0];
+    if (!m_cyclic && (t < t_start || t > t_end))
+        return 1; // stays in local coordinates
+    if (t < 0.0f || t >= t_end)
+        t = fmodf(t, t_end);
+
+    // The segment bisect() finds: the last one starting at or before t, the first and last ones are open
+    const u32 last = m_length - 2;
+    const auto contains = [&]( const u32 s ) {
+        return (s == 0 || m_time[s] <= t) && (s == last || t < m_time[s + 1]);
+    };
+    if (segment > last || !contains(segment))
+        segment = (segment < last && contains(segment + 1)) ? segment + 1 : bisect(m_time, t);
+    const u32 low = segment;
+    const u32 high = (low + 1) % m_length;
+
+    // Following vertices join the run while they need neither wrapping nor another segment
+    const f32 begin = std::max((low == 0) ? 0.0f : m_time[low], m_cyclic ? 0.0f : t_start);
+    const f32 end = (low == last) ? t_end : std::min(m_time[high], t_end);
+    u32 run = 1;
+    while (run < count && begin <= times[run] && times[run] < end)
+        run++;
+
+    const glm::fvec3 y0(m_vertices[low * m_stride], m_vertices[low * m_stride + 1], m_vertices[low * m_stride + 2]);
+    const glm::fvec3 y1(m_vertices[high * m_stride], m_vertices[high * m_stride + 1], m_vertices[high * m_stride + 2]);
+
+    const f32 t0 = m_time[low];
+    const f32 t1 = m_time[high];
+    const f32 h = t1 - t0;
+    const f32 inv_h = 1.0f / h;
+
+    const glm::fvec3 &M0 = spline_M[low];
+    const glm::fvec3 &M1 = spline_M[high];
+    const glm::fvec3 C = y0 * inv_h - M0 * (h / 6.0f);
+    const glm::fvec3 D = y1 * inv_h - M1 * (h / 6.0f);
+
+    // P, P' and P'' as polynomials in dt0 and dt1
+    const glm::fvec3 M0_6 = M0 * (inv_h / 6.0f), M1_6 = M1 * (inv_h / 6.0f);
+    const glm::fvec3 M0_2 = M0 * (inv_h * 0.5f), M1_2 = M1 * (inv_h * 0.5f);
+    const glm::fvec3 M0_1 = M0 * inv_h, M1_1 = M1 * inv_h;
+    const glm::fvec3 DC = D - C;
+
+    for (u32 i = 0; i < run; i++) {
+        const f32 time = (i == 0) ? t : times[i];
+        const f32 dt0 = time - t0;
+        const f32 dt1 = t1 - time;
+
+        const glm::fvec3 P = M1_6 * (dt0 * dt0 * dt0) + M0_6 * (dt1 * dt1 * dt1) + D * dt0 + C * dt1;
+        const glm::fvec3 dP = M1_2 * (dt0 * dt0) - M0_2 * (dt1 * dt1) + DC;
+        const glm::fvec3 ddP = M1_1 * dt0 + M0_1 * dt1;
+
+        // The frame of getOrthonormalFrame(): B is normal to P' and P'', N completes it without normalizing
+        const glm::fvec3 T = dP * glm::inversesqrt(glm::dot(dP, dP));
+        const glm::fvec3 binormal = glm::cross(dP, ddP);
+        const glm::fvec3 B = binormal * glm::inversesqrt(glm::dot(binormal, binormal));
+        const glm::fvec3 N = glm::cross(B, T);
+
+        f32 *v = vertices + static_cast<size_t>(i) * stride;
+        const glm::fvec3 world = P + T * v[0] + N * v[1] + B * v[2];
+        v[0] = world.x;
+        v[1] = world.y;
+        v[2] = world.z;
+    }
+    return run;
+}
+
+void SmoothICurve::placeLocal( const f32 *times, f32 *vertices, const u32 count, const u32 stride ) const
+{
+    // Too few points for a spline
+    if (spline_M.size() != m_length) {
+        Mesh::placeLocal(times, vertices, count, stride);
+        return;
+    }
+    placeAlong(*this, times, vertices, count, stride);
+}
+
+void SmoothICurve::setTolerance( const f32 tolerance )
+{
+    m_sampleOffsets.clear();
+    if (tolerance <= 0.0f || spline_M.size() != m_length || m_length < 2)
+        return;
+
+    const u32 segments = m_length - 1;
+    m_sampleOffsets.resize(segments + 1);
+
+    f32 maxCurvature = 0.0f;
+    u32 offset = 0;
+    for (u32 i = 0; i < segments; i++) {
+        const f32 bound = std::max(glm::length(spline_M[i]), glm::length(spline_M[i + 1]));
+        const f32 h = m_time[i + 1] - m_time[i];
+        maxCurvature = std::max(maxCurvature, bound);
+
+        m_sampleOffsets[i] = offset;
+        offset += std::max(1u, static_cast<u32>(std::ceil(h * std::sqrt(bound / (8.0f * tolerance)))));
+    }
+    m_sampleOffsets[segments] = offset;
+
+    // For comparison: the same bound with uniform steps needs the worst segment's density everywhere
+    const f64 uniform = std::ceil((t_end - t_start) * std::sqrt(maxCurvature / (8.0 * tolerance))) + 1.0;
+    std::cout << "[  INFO  ][Curve  ] " << m_length << " points resampled to " << offset + 1 << " vertices at tolerance "
+              << tolerance << " (uniform sampling: " << std::max(uniform, static_cast<f64>(m_length)) << ')' << std::endl;
+}
+
+u32 SmoothICurve::getDrawLength() const
+{
+    return m_sampleOffsets.empty() ? m_length : m_sampleOffsets.back() + 1;
+}
+
+void SmoothICurve::writeDrawVertices( f32 *destination ) const
+{
+    if (m_sampleOffsets.empty()) {
+        Mesh::writeDrawVertices(destination);
+        return;
+    }
+
+    const u32 segments = m_length - 1;
+    ThreadPool::getShared().parallelFor(0, segments, 64, [this, destination]( const u64 first, const u64 last ) {
+        for (u64 i = first; i < last; i++) {
+            const f32 *v0 = &m_vertices[i * m_stride];
+            const f32 *v1 = &m_vertices[(i + 1) * m_stride];
+            const glm::fvec3 y0(v0[0], v0[1], v0[2]);
+            const glm::fvec3 y1(v1[0], v1[1], v1[2]);
+
+            const f32 h = m_time[i + 1] - m_time[i];
+            const f32 inv_h = 1.0f / h;
+            const f32 inv_h6 = inv_h / 6.0f;
+
+            const glm::fvec3 &M0 = spline_M[i];
+            const glm::fvec3 &M1 = spline_M[i + 1];
+
+            const glm::fvec3 C = y0 * inv_h - M0 * (h / 6.0f);
+            const glm::fvec3 D = y1 * inv_h - M1 * (h / 6.0f);
+
+            const u32 samples = m_sampleOffsets[i + 1] - m_sampleOffsets[i];
+            f32 *out = destination + static_cast<size_t>(m_sampleOffsets[i]) * m_stride;
+
+            for (u32 j = 0; j < samples; j++, out += m_stride) {
+                const f32 s = static_cast<f32>(j) / static_cast<f32>(samples);
+                const f32 dt0 = h * s;
+                const f32 dt1 = h - dt0;
+
+                const glm::fvec3 P = M1 * (dt0 * dt0 * dt0 * inv_h6) + M0 * (dt1 * dt1 * dt1 * inv_h6) + D * dt0 + C * dt1;
+                out[0] = P.x;
+                out[1] = P.y;
+                out[2] = P.z;
+
+                for (u32 k = 3; k < m_stride; k++)
+                    out[k] = v0[k] + (v1[k] - v0[k]) * s;
+            }
+        }
+    });
+
+    // The final data point closes the last segment
+    std::copy_n(&m_vertices[static_cast<size_t>(segments) * m_stride], m_stride,
+                destination + static_cast<size_t>(m_sampleOffsets.back()) * m_stride);
+}
+
+/**
+ * Octahedral mapping of the unit vector v onto [-1, 1]^2, as two snorm16 like GLSL packSnorm2x16.
+ */
+static u32 packDirection( const glm::fvec3 &v )
+{
+    const f32 norm = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+    f32 x = v.x / norm;
+    f32 y = v.y / norm;
+    if (v.z < 0.0f) {
+        const f32 folded = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+        y = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+        x = folded;
+    }
+
+    const auto toSnorm = []( const f32 value ) {
+        return static_cast<u32>(static_cast<u16>(static_cast<i16>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f))));
+    };
+    return toSnorm(x) | (toSnorm(y) << 16);
+}
+
+void SmoothICurve::writeFrames( CurveFrame *destination ) const
+{
+    if (m_length < 2)
+        return;
+
+    // Without a spline (too few points) the segments are straight
+    const bool hasSpline = spline_M.size() == m_length;
+    const u32 segments = m_length - 1;
+
+    const auto writeFrame = []( CurveFrame &frame, const glm::fvec3 &P, const f32 t, const glm::fvec3 &velocity, const glm::fvec3 &acceleration ) {
+        const glm::fvec3 T = glm::normalize(velocity);
+        glm::fvec3 N = acceleration - glm::dot(T, acceleration) * T;
+        if (glm::dot(N, N) <= 1e-12f * glm::dot(acceleration, acceleration) || glm::dot(N, N) < 1e-30f) {
+            // Any direction orthogonal to T, built from the axis least parallel to it
+            const glm::fvec3 axis = (std::abs(T.x) < 0.5f) ? glm::fvec3(1.0f, 0.0f, 0.0f) : glm::fvec3(0.0f, 1.0f, 0.0f);
+            N = glm::cross(T, axis);
+        }
+        N = glm::normalize(N);
+
+        frame.P[0] = P.x;
+        frame.P[1] = P.y;
+        frame.P[2] = P.z;
+        frame.t = t;
+        frame.tangent = packDirection(T);
+        frame.normal = packDirection(N);
+    };
+
+    ThreadPool::getShared().parallelFor(0, segments, 64, [&, this]( const u64 first, const u64 last ) {
+        for (u64 i = first; i < last; i++) {
+            const f32 *v0 = &m_vertices[i * m_stride];
+            const f32 *v1 = &m_vertices[(i + 1) * m_stride];
+            const glm::fvec3 y0(v0[0], v0[1], v0[2]);
+            const glm::fvec3 y1(v1[0], v1[1], v1[2]);
+
+            const f32 h = hasSpline ? m_time[i + 1] - m_time[i] : 1.0f;
+            const f32 inv_h = 1.0f / h;
+            const f32 inv_h2 = inv_h * 0.5f;
+            const f32 inv_h6 = inv_h / 6.0f;
+
+            const glm::fvec3 M0 = hasSpline ? spline_M[i] : glm::fvec3(0.0f);
+            const glm::fvec3 M1 = hasSpline ? spline_M[i + 1] : glm::fvec3(0.0f);
+
+            const glm::fvec3 C = y0 * inv_h - M0 * (h / 6.0f);
+            const glm::fvec3 D = y1 * inv_h - M1 * (h / 6.0f);
+
+            const u32 samples = m_sampleOffsets.empty() ? 1 : m_sampleOffsets[i + 1] - m_sampleOffsets[i];
+            // The last segment also writes its end, the final sample
+            const u32 written = samples + (i + 1 == segments);
+            CurveFrame *out = destination + (m_sampleOffsets.empty() ? i : m_sampleOffsets[i]);
+
+            for (u32 j = 0; j < written; j++, out++) {
+                const f32 s = static_cast<f32>(j) / static_cast<f32>(samples);
+                const f32 dt0 = h * s;
+                const f32 dt1 = h - dt0;
+
+                const glm::fvec3 P = M1 * (dt0 * dt0 * dt0 * inv_h6) + M0 * (dt1 * dt1 * dt1 * inv_h6) + D * dt0 + C * dt1;
+                const glm::fvec3 velocity = M1 * (dt0 * dt0 * inv_h2) - M0 * (dt1 * dt1 * inv_h2) + D - C;
+                const glm::fvec3 acceleration = M1 * (dt0 * inv_h) + M0 * (dt1 * inv_h);
+                const f32 t = (m_stride > 3) ? v0[3] + (v1[3] - v0[3]) * s : 0.0f;
+                writeFrame(*out, P, t, velocity, acceleration);
+            }
+        }
+    });
+}
+
+void SmoothICurve::closestOnSegment( const u32 segment, const glm::fvec3 &point, CurvePoint &best ) const
+{
+    // Too few points for a spline: straight segments over the vertex index
+    const bool hasSpline = spline_M.size() == m_length;
+    const f32 t0 = hasSpline ? m_time[segment] : static_cast<f32>(segment);
+    const f32 t1 = hasSpline ? m_time[segment + 1] : static_cast<f32>(segment + 1);
+
+    const f32 *v0 = &m_vertices[segment * m_stride];
+    const f32 *v1 = &m_vertices[(segment + 1) * m_stride];
+    const glm::fvec3 y0(v0[0], v0[1], v0[2]);
+    const glm::fvec3 y1(v1[0], v1[1], v1[2]);
+
+    const f32 h = t1 - t0;
+    const f32 inv_h = 1.0f / h;
+    const glm::fvec3 M0 = hasSpline ? spline_M[segment] : glm::fvec3(0.0f);
+    const glm::fvec3 M1 = hasSpline ? spline_M[segment + 1] : glm::fvec3(0.0f);
+    const glm::fvec3 C = y0 * inv_h - M0 * (h / 6.0f);
+    const glm::fvec3 D = y1 * inv_h - M1 * (h / 6.0f);
+
+    // The spline deviates at most max(|M0|, |M1|) h^2 / 8 from its chord, so the chord bounds the distance from below
+    const glm::fvec3 chord = y1 - y0;
+    const f32 chord2 = glm::dot(chord, chord);
+    const f32 along = (chord2 > 0.0f) ? std::clamp(glm::dot(point - y0, chord) / chord2, 0.0f, 1.0f) : 0.0f;
+    const f32 deviation = std::max(glm::length(M0), glm::length(M1)) * h * h / 8.0f;
+    const f32 bound = glm::length(y0 + chord * along - point) - deviation;
+    if (bound > 0.0f && bound * bound >= best.distance)
+        return;
+
+    // S(t0 + s) and its first two derivatives
+    const auto evaluate = [&]( const f32 s, glm::fvec3 &P, glm::fvec3 &dP, glm::fvec3 &ddP ) {
+        const f32 r = h - s;
+        P = M1 * (s * s * s * inv_h / 6.0f) + M0 * (r * r * r * inv_h / 6.0f) + D * s + C * r;
+        dP = M1 * (s * s * inv_h * 0.5f) - M0 * (r * r * inv_h * 0.5f) + D - C;
+        ddP = (M1 * s + M0 * r) * inv_h;
+    };
+
+    // Nearly straight segments start from the projection onto the chord, bent ones from the closest of a few samples
+    glm::fvec3 P, dP, ddP;
+    f32 sampled = along * h;
+    glm::fvec3 sampledP(0.0f);
+    f32 sampled2 = std::numeric_limits<f32>::infinity();
+    if (deviation * deviation > chord2 * CLOSEST_STRAIGHT) {
+        for (u32 k = 0; k <= CLOSEST_SAMPLES; k++) {
+            const f32 s = h * static_cast<f32>(k) / CLOSEST_SAMPLES;
+            evaluate(s, P, dP, ddP);
+            const f32 d2 = glm::dot(P - point, P - point);
+            if (d2 < sampled2) {
+                sampled = s;
+                sampledP = P;
+                sampled2 = d2;
+            }
+        }
+    }
+
+    // Newton on the derivative of the squared distance, clamped to the segment
+    f32 s = sampled;
+    for (u32 i = 0; i < CLOSEST_ITERATIONS; i++) {
+        evaluate(s, P, dP, ddP);
+        const glm::fvec3 offset = P - point;
+        const f32 slope = glm::dot(offset, dP);
+        const f32 curvature = glm::dot(dP, dP) + glm::dot(offset, ddP);
+        if (curvature <= 0.0f)
+            break;
+
+        const f32 next = std::clamp(s - slope / curvature, 0.0f, h);
+        const bool converged = std::abs(next - s) <= 1e-6f * h;
+        s = next;
+        if (converged)
+            break;
+    }
+    evaluate(s, P, dP, ddP);
+    f32 d2 = glm::dot(P - point, P - point);
+    if (d2 > sampled2) {
+        s = sampled;
+        P = sampledP;
+        d2 = sampled2;
+    }
+
+    // best.distance is squared until closestPoint() returns
+    if (d2 < best.distance)
+        best = { P, t0 + s, d2 };
+}
+
+CurvePoint SmoothICurve::closestPoint( const glm::fvec3 &point ) const
+{
+    CurvePoint best{ glm::fvec3(0.0f), t_start, std::numeric_limits<f32>::infinity() };
+    if (m_length < 2) {
+        if (m_length == 1) {
+            best.position = glm::fvec3(m_vertices[0], m_vertices[1], m_vertices[2]);
+            best.distance = glm::length(best.position - point);
+        }
+        return best;
+    }
+
+    std::call_once(m_segmentTreeBuilt, [this] {
+        // A cubic segment lies in the convex hull of its Bézier control points y0, y0 + h/3 S'(t0), y1 - h/3 S'(t1), y1
+        const bool hasSpline = spline_M.size() == m_length;
+        std::vector<Bounds> hulls(m_length - 1);
+        ThreadPool::getShared().parallelFor(0, hulls.size(), 1 << 12, [&, this]( const u64 first, const u64 last ) {
+            for (u64 i = first; i < last; i++) {
+                const f32 *v0 = &m_vertices[i * m_stride];
+                const f32 *v1 = &m_vertices[(i + 1) * m_stride];
+                const glm::fvec3 y0(v0[0], v0[1], v0[2]);
+                const glm::fvec3 y1(v1[0], v1[1], v1[2]);
+                hulls[i].extend(y0);
+                hulls[i].extend(y1);
+                if (!hasSpline)
+                    continue;
+
+                const f32 h = m_time[i + 1] - m_time[i];
+                const glm::fvec3 chord = (y1 - y0) / h - (spline_M[i + 1] - spline_M[i]) * (h / 6.0f);
+                hulls[i].extend(y0 + (chord - spline_M[i] * (h * 0.5f)) * (h / 3.0f));
+                hulls[i].extend(y1 - (chord + spline_M[i + 1] * (h * 0.5f)) * (h / 3.0f));
+            }
+        });
+        m_segmentTree = SegmentTree(hulls);
+    });
+
+    m_segmentTree.search(point, best.distance, [&, this]( const u32 segment ) {
+        closestOnSegment(segment, point, best);
+    });
+    best.distance = std::sqrt(best.distance);
+    return best;
+}
+
+void SmoothICurve::closestPoints( const glm::fvec3 *points, CurvePoint *results, const u64 count ) const
+{
+    if (count == 0)
+        return;
+    closestPoint(points[0]); // builds the segment tree
+
+    if (m_length <= CLOSEST_SORTED) {
+        ThreadPool::getShared().parallelFor(0, count, 1 << 10, [&, this]( const u64 first, const u64 last ) {
+            for (u64 i = first; i < last; i++)
+                results[i] = closestPoint(points[i]);
+        });
+        return;
+    }
+
+    // Queries in Morton order of their position walk the same part of the tree one after another, which stays cached
+    const Bounds bounds = m_segmentTree.getBounds();
+    const glm::fvec3 scale = glm::fvec3(1023.0f) / glm::max(bounds.max - bounds.min, glm::fvec3(1e-30f));
+    std::vector<std::pair<u32, u32>> order(count);
+    ThreadPool::getShared().parallelFor(0, count, 1 << 12, [&]( const u64 first, const u64 last ) {
+        const auto spread = []( u32 x ) {
+            x = (x | (x << 16)) & 0x030000FF;
+            x = (x | (x << 8)) & 0x0300F00F;
+            x = (x | (x << 4)) & 0x030C30C3;
+            return (x | (x << 2)) & 0x09249249;
+        };
+        for (u64 i = first; i < last; i++) {
+            const glm::fvec3 cell = glm::clamp((points[i] - bounds.min) * scale, glm::fvec3(0.0f), glm::fvec3(1023.0f));
+            const u32 code = spread(static_cast<u32>(cell.x)) | (spread(static_cast<u32>(cell.y)) << 1) | (spread(static_cast<u32>(cell.z)) << 2);
+            order[i] = { code, static_cast<u32>(i) };
+        }
+    });
+    std::sort(order.begin(), order.end());
+
+    ThreadPool::getShared().parallelFor(0, count, 1 << 10, [&, this]( const u64 first, const u64 last ) {
+        for (u64 i = first; i < last; i++)
+            results[order[i].second] = closestPoint(points[order[i].second]);
+    });
+}
@@ -1,8 +1,32 @@
 #pragma once
 #include "../Mesh.hpp"
+#include "3D/SegmentTree.hpp"
+#include <mutex>
 #include <glm/glm.hpp>
 
 
+/**
+ * Orthonormal frame of a curve sample as read by res/shader/tube, 24 bytes.<br>
+ * Tangent and normal are unit vectors, each packed into two snorm16 by an octahedral mapping.
+ */
+struct CurveFrame {
+    f32 P[3];
+    f32 t;       // the first attribute after the position, like the drawn vertices
+    u32 tangent; // unpackSnorm2x16
+    u32 normal;
+};
+
+
+/**
+ * Point of a curve closest to a query point.
+ */
+struct CurvePoint {
+    glm::fvec3 position;
+    f32 t;        // spline parameter of position
+    f32 distance; // to the query point
+};
+
+
 class SmoothICurve : public Mesh {
 public:
     SmoothICurve() = delete;
@@ -13,11 +37,13 @@ public:
      * @param columns for drawing. First three are used as space and 4th as time coordinates
      * @param time_and_scale time column or delta-t
      * @param cyclic (default false)
+     * @param system of the first three columns, the spline interpolates the cartesian points
      */
     SmoothICurve( const CSVFile &csv,
                   const std::vector<std::pair<std::string, f32>> &columns,
                   const std::pair<std::string, f32> &time_and_scale,
-                  bool cyclic = false );
+                  bool cyclic = false,
+                  CoordinateSystem system = CoordinateSystem::Cartesian );
 
     /**
      * Creates a 3D spline curve along <mesh>.
@@ -28,6 +54,7 @@ public:
      * @param Z z coord or default z value
      * @param mesh transform to its local orthonormal frame
      * @param cyclic (default false)
+     * @param system of the local coordinates (x,y,z)
      */
     SmoothICurve( const CSVFile &csv,
                   const std::pair<std::string, f32> &T,
@@ -35,7 +62,19 @@ public:
                   const std::pair<std::string, f32> &Y,
                   const std::pair<std::string, f32> &Z,
                   const Mesh *mesh,
-                  bool cyclic = false );
+                  bool cyclic = false,
+                  CoordinateSystem system = CoordinateSystem::Cartesian );
+
+    /**
+     * Restores a curve from the arrays of a previously built one, e.g. out of a SceneSnapshot.
+     * @param vertices cartesian data points of stride floats
+     * @param time spline parameter of each data point
+     * @param moments spline moments of each data point, empty if there are too few points for a spline
+     */
+    SmoothICurve( std::vector<f32> &&vertices, u32 stride,
+                  std::vector<f32> &&time,
+                  std::vector<glm::fvec3> &&moments,
+                  bool cyclic );
 
 
     /**
@@ -104,14 +143,77 @@ public:
 
     glm::fvec4 transform( const glm::fvec2 &uv, const glm::fvec4 &direction ) const override { return transform(uv.x, direction); }
 
+    /**
+     * getOrthonormalFrame(times[i]) * (local, 1) for the leading vertices on the spline segment of times[0],
+     * see LocalFrames. The segment's coefficients are computed once, then its vertices are placed in a loop
+     * without searching, with two inverse square roots each.
+     * @param segment of the previous run, the next one is tried before bisecting
+     * @return number of vertices placed
+     */
+    u32 placeRun( u32 &segment, const f32 *times, f32 *vertices, u32 count, u32 stride ) const;
+
+    void placeLocal( const f32 *times, f32 *vertices, u32 count, u32 stride ) const override;
+
+    /**
+     * Chooses samples along the spline, so that the polyline through them deviates at most tolerance from it.<br>
+     * On segment i the second derivative is linear between M_i and M_i+1, so a chord over dt deviates at most
+     * max(|M_i|, |M_i+1|) * dt^2 / 8 and the segment is split into ceil(h_i * sqrt(max(|M_i|, |M_i+1|) / (8 * tolerance))) parts.
+     * Straight parts keep their data points only.
+     * @param tolerance maximal distance to the spline, 0 draws the data points
+     */
+    void setTolerance( f32 tolerance );
+
+    u32 getDrawLength() const override;
+
+    /**
+     * Evaluates the samples chosen by setTolerance(), in parallel over the segments.
+     * Attributes beyond the position are interpolated linearly between the data points.
+     */
+    void writeDrawVertices( f32 *destination ) const override;
+
+    /**
+     * Evaluates the frames of getOrthonormalFrame() at the getDrawLength() samples of writeDrawVertices(), in parallel.<br>
+     * Where the curve is straight, the normal is undefined and any unit vector orthogonal to the tangent is taken.
+     */
+    void writeFrames( CurveFrame *destination ) const;
+
+    /**
+     * Closest point of the spline to point, given in the coordinates of getVertices().<br>
+     * Those are the source coordinates of curves the vertex shader converts, see Scene::getShaderSystem. Distances
+     * are measured there and not between the drawn points, so only query curves that are cartesian after building.<br>
+     * Segments are searched through a SegmentTree over the hulls of their Bézier control points, built on the
+     * first query. On every segment whose hull is closer than the best point so far, the distance is minimized
+     * by Newton iterations on (S(t) - point) · S'(t) = 0, started from the closest of a few samples.
+     */
+    CurvePoint closestPoint( const glm::fvec3 &point ) const;
+
+    /**
+     * closestPoint() of count points, in parallel.
+     */
+    void closestPoints( const glm::fvec3 *points, CurvePoint *results, u64 count ) const;
+
+    const std::vector<f32> &getTimes() const noexcept { return m_time; }
+    const std::vector<glm::fvec3> &getMoments() const noexcept { return spline_M; }
+    bool isCyclic() const noexcept { return m_cyclic; }
+
 protected:
     void generateTime( const CSVFile &csv, const std::pair<std::string, f32> &T );
 
     void calculateCyclicSpline();
     void calculateNaturalSpline();
 
+    /**
+     * Updates best if segment has a point closer to point.
+     */
+    void closestOnSegment( u32 segment, const glm::fvec3 &point, CurvePoint &best ) const;
+
     std::vector<f32> m_time;
     std::vector<glm::fvec3> spline_M;
+    std::vector<u32> m_sampleOffsets; // first sample of each segment, the last entry is the final data point
     f32 t_start, t_end;
     bool m_cyclic;
+
+    // Of closestPoint(), built on first use
+    mutable std::once_flag m_segmentTreeBuilt;
+    mutable SegmentTree m_segmentTree;
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <concepts>
+
+#include "defines.hpp"
+#include "Threading/ThreadPool.hpp"
+
+
+/**
+ * A mesh whose orthonormal frames are the local coordinates of child meshes, evaluated without virtual calls.<br>
+ * placeRun(piece, times, vertices, count, stride) places the leading vertices whose times fall on the same piece
+ * of the mesh, e.g. one spline segment, like transform(t, (local, 1)) and returns how many, at least one.
+ * piece carries the piece of the previous run, so increasing times need no search, and starts at ~0u.
+ */
+template<typename Frames>
+concept LocalFrames = requires( const Frames &frames, u32 &piece, const f32 *times, f32 *vertices, u32 count, u32 stride ) {
+    { frames.placeRun(piece, times, vertices, count, stride) } -> std::same_as<u32>;
+};
+
+/**
+ * Moves the first three floats of count vertices of stride floats from the local coordinates of frames at times
+ * to world coordinates, in parallel. Instantiated per concrete type, so placeRun() inlines into the loop.
+ */
+template<LocalFrames Frames>
+void placeAlong( const Frames &frames, const f32 *times, f32 *vertices, const u32 count, const u32 stride )
+{
+    ThreadPool::getShared().parallelFor(0, count, 1 << 12, [&]( const u64 first, const u64 last ) {
+        u32 piece = ~0u;
+        for (u64 i = first; i < last;)
+            i += frames.placeRun(piece, times + i, vertices + i * stride, static_cast<u32>(last - i), stride);
+    });
+}
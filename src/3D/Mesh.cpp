@@ -1,16 +1,13 @@
 #include "Mesh.hpp"
+#include "Memory/ScratchArena.hpp"
+#include <algorithm>
 
 Mesh::Mesh( Mesh &&mesh ) noexcept
     : m_vertices(std::move(mesh.m_vertices))
-    , m_vaoID(mesh.m_vaoID)
-    , m_vboID(mesh.m_vboID)
     , m_mode(GL_POINTS)
     , m_stride(mesh.m_stride)
     , m_length(mesh.m_length)
-    , m_bufferSize(0)
 {
-    mesh.m_vaoID = 0;
-    mesh.m_vboID = 0;
     mesh.m_stride = 0;
     mesh.m_length = 0;
 }
@@ -18,29 +15,25 @@ Mesh::Mesh( Mesh &&mesh ) noexcept
 
 Mesh::Mesh( const Mesh &mesh )
     : m_vertices(mesh.m_vertices.cbegin(), mesh.m_vertices.cend())
-    , m_vaoID(0)
-    , m_vboID(0)
     , m_mode(GL_POINTS)
     , m_stride(mesh.m_stride)
     , m_length(mesh.m_length)
-    , m_bufferSize(0)
 {}
 
 
-Mesh::Mesh( const CSVFile &csv, const std::vector<std::pair<std::string, f32>> &columns, const GLenum mode )
-    : m_vaoID(0)
-    , m_vboID(0)
-    , m_mode(mode)
-    , m_bufferSize(0)
+Mesh::Mesh( const CSVFile &csv, const std::vector<std::pair<std::string, f32>> &columns, const GLenum mode, const CoordinateSystem system )
+    : m_mode(mode)
 {
-    std::vector<const std::vector<std::string> *> column_data;
+    const ScratchArena scratch;
+    std::pmr::vector<const std::vector<f32> *> column_data(scratch.getResource());
 
     for (const auto &col : columns) {
-        column_data.emplace_back(csv.getColumn(col.first));
+        column_data.emplace_back(csv.getValues(col.first));
     }
 
     m_stride = static_cast<u32>(column_data.size());
     m_length = csv.getRowCount();
+    m_vertices.reserve(static_cast<size_t>(m_length) * m_stride);
 
     /*
      * Create packed vertex data like (x,y,z,t), (x,y,z,t), ...
@@ -51,9 +44,12 @@ Mesh::Mesh( const CSVFile &csv, const std::vector<std::pair<std::string, f32>> &
             if (nullptr == column)
                 m_vertices.push_back(columns[c].second); // Default value
             else
-                m_vertices.push_back(std::stof(column->at(r)));
+                m_vertices.push_back((*column)[r]);
         }
     }
+
+    if (m_stride >= 3)
+        CoordinateTransforms::toCartesian(system, m_vertices.data(), m_length, m_stride);
 }
 
 
@@ -62,86 +58,62 @@ Mesh::Mesh( const CSVFile &csv,
             const std::pair<std::string, f32> &X,
             const std::pair<std::string, f32> &Y,
             const std::pair<std::string, f32> &Z,
-            const Mesh *mesh, const GLenum mode )
-    : m_vaoID(0)
-    , m_vboID(0)
-    , m_mode(mode)
+            const Mesh *mesh, const GLenum mode, const CoordinateSystem system )
+    : m_mode(mode)
     , m_stride(4)
-    , m_bufferSize(0)
 {
-    const auto Xcol = csv.getColumn(X.first);
-    const auto Ycol = csv.getColumn(Y.first);
-    const auto Zcol = csv.getColumn(Z.first);
-    const auto Tcol = csv.getColumn(T.first);
+    const auto Xcol = csv.getValues(X.first);
+    const auto Ycol = csv.getValues(Y.first);
+    const auto Zcol = csv.getValues(Z.first);
+    const auto Tcol = csv.getValues(T.first);
     m_length = csv.getRowCount();
 
-    const f32 total_time = (nullptr == Tcol) ? (T.second * (m_length - 1)) : std::stof(Tcol->at(m_length - 1));
+    const f32 total_time = (nullptr == Tcol) ? (T.second * (m_length - 1)) : (*Tcol)[m_length - 1];
     const f32 inv_total_time = 1.0f / total_time;
 
     m_vertices.resize(4 * m_length);
 
+    const ScratchArena scratch;
+    std::pmr::vector<f32> times(m_length, scratch.getResource());
+
+    // Local coordinates first, converted to cartesian in one batch
     for (u32 r = 0; r < m_length; r++) {
-        glm::fvec4 local_coords(1.0f);
-        const f32 t = (nullptr == Tcol) ? (T.second * r) : std::stof(Tcol->at(r));
-        local_coords.x = (nullptr == Xcol) ? X.second : std::stof(Xcol->at(r));
-        local_coords.y = (nullptr == Ycol) ? Y.second : std::stof(Ycol->at(r));
-        local_coords.z = (nullptr == Zcol) ? Z.second : std::stof(Zcol->at(r));
-
-        const glm::fvec3 coords = mesh->transform(t, local_coords);
-        m_vertices[r * 4 + 0] = coords.x;
-        m_vertices[r * 4 + 1] = coords.y;
-        m_vertices[r * 4 + 2] = coords.z;
-        m_vertices[r * 4 + 3] = t * inv_total_time;
+        times[r] = (nullptr == Tcol) ? (T.second * r) : (*Tcol)[r];
+        m_vertices[r * 4 + 0] = (nullptr == Xcol) ? X.second : (*Xcol)[r];
+        m_vertices[r * 4 + 1] = (nullptr == Ycol) ? Y.second : (*Ycol)[r];
+        m_vertices[r * 4 + 2] = (nullptr == Zcol) ? Z.second : (*Zcol)[r];
+        m_vertices[r * 4 + 3] = times[r] * inv_total_time;
     }
+    CoordinateTransforms::toCartesian(system, m_vertices.data(), m_length, m_stride);
+
+    mesh->placeLocal(times.data(), m_vertices.data(), m_length, m_stride);
 }
 
 
 Mesh::Mesh( std::vector<f32> &&positions, const u32 stride, const GLenum mode )
-    : m_vertices(positions)
-    , m_vaoID(0)
-    , m_vboID(0)
+    : m_vertices(std::move(positions))
     , m_mode(mode)
     , m_stride(stride)
-    , m_length(positions.size() / stride)
-    , m_bufferSize(0)
+    , m_length(static_cast<u32>(m_vertices.size() / stride))
 {}
 
 
-void Mesh::push()
+void Mesh::writeDrawVertices( f32 *destination ) const
 {
-    if (m_vaoID > 0 && m_vboID > 0) {
-        const auto newBufferSize = m_vertices.size() * sizeof(f32);
-        if (m_bufferSize >= newBufferSize) {
-            glNamedBufferSubData(m_vboID, 0, static_cast<GLsizeiptr>(newBufferSize), m_vertices.data());
-            return;
-        }
-        glDeleteVertexArrays(1, &m_vaoID);
-        glDeleteBuffers(1, &m_vboID);
-    }
-
-    glCreateVertexArrays(1, &m_vaoID);
-    glCreateBuffers(1, &m_vboID);
-
-    m_bufferSize = static_cast<GLsizeiptr>(m_vertices.size() * sizeof(f32));
-    glNamedBufferStorage(m_vboID, m_bufferSize, m_vertices.data(), GL_DYNAMIC_STORAGE_BIT);
-
-    // First 3 floats are always position information
-    glVertexArrayVertexBuffer(m_vaoID, 0, m_vboID, 0, static_cast<GLsizei>(m_stride * sizeof(f32)));
-    glVertexArrayAttribFormat(m_vaoID, 0, 3, GL_FLOAT, GL_FALSE, 0);
-    glEnableVertexArrayAttrib(m_vaoID, 0);
-
-    // Additional information
-    for (u32 i = 1; i < m_stride - 2; i++) {
-        glVertexArrayVertexBuffer(m_vaoID, i, m_vboID, static_cast<GLintptr>((i + 2) * sizeof(f32)), static_cast<GLsizei>(m_stride * sizeof(f32)));
-        glVertexArrayAttribFormat(m_vaoID, i, 1, GL_FLOAT, GL_FALSE, 0);
-        glEnableVertexArrayAttrib(m_vaoID, i);
-    }
+    std::copy(m_vertices.begin(), m_vertices.end(), destination);
 }
 
-void Mesh::render() const
+Bounds Mesh::computeBounds( const CoordinateSystem system ) const
 {
-    glBindVertexArray(m_vaoID);
-    glDrawArrays(m_mode, 0, static_cast<GLsizei>(m_length));
+    if (m_stride < 3)
+        return { };
+    if (system == CoordinateSystem::Cartesian)
+        return Bounds::compute(m_vertices.data(), m_length, m_stride);
+
+    const ScratchArena scratch;
+    std::pmr::vector<f32> converted(m_vertices.begin(), m_vertices.end(), scratch.getResource());
+    CoordinateTransforms::toCartesian(system, converted.data(), m_length, m_stride);
+    return Bounds::compute(converted.data(), m_length, m_stride);
 }
 
 glm::fmat4 Mesh::getOrthonormalFrame( f32 ) const
@@ -164,6 +136,17 @@ glm::fvec4 Mesh::transform( const glm::fvec2 &local, const glm::fvec4 &direction
     return glm::fvec4(0.0f);
 }
 
+void Mesh::placeLocal( const f32 *times, f32 *vertices, const u32 count, const u32 stride ) const
+{
+    for (u32 i = 0; i < count; i++) {
+        f32 *v = vertices + static_cast<size_t>(i) * stride;
+        const glm::fvec4 P = transform(times[i], glm::fvec4(v[0], v[1], v[2], 1.0f));
+        v[0] = P.x;
+        v[1] = P.y;
+        v[2] = P.z;
+    }
+}
+
 glm::fvec3 Mesh::at( f32 t ) const
 {
     return glm::fvec3(0.0f);
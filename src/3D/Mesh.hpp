@@ -3,6 +3,8 @@
 
 #include <glad.h>
 #include "IO/CSVReader.hpp"
+#include "3D/Bounds.hpp"
+#include "3D/CoordinateSystem.hpp"
 #include <glm/glm.hpp>
 
 class Mesh {
@@ -16,9 +18,13 @@ public:
     // Moves a mesh
     Mesh( Mesh &&mesh ) noexcept;
 
+    /**
+     * @param system of the first three columns, converted to cartesian
+     */
     Mesh( const CSVFile &csv,
           const std::vector<std::pair<std::string, f32>> &columns,
-          GLenum mode );
+          GLenum mode,
+          CoordinateSystem system = CoordinateSystem::Cartesian );
 
     /**
      * @param csv a CSVFile object
@@ -28,6 +34,7 @@ public:
      * @param Z name of the column used as z coordinates or default z coordinate
      * @param mesh use (x,y,z) and t as local coordinates along this Mesh pointer
      * @param mode draw mode for OpenGL
+     * @param system of the local coordinates (x,y,z)
      */
     Mesh( const CSVFile &csv,
           const std::pair<std::string, f32> &T,
@@ -35,15 +42,34 @@ public:
           const std::pair<std::string, f32> &Y,
           const std::pair<std::string, f32> &Z,
           const Mesh *mesh,
-          GLenum mode );
+          GLenum mode,
+          CoordinateSystem system = CoordinateSystem::Cartesian );
 
     Mesh( std::vector<f32> &&positions, u32 stride, GLenum mode );
 
     virtual ~Mesh() = default;
 
-    void push();
+    const std::vector<f32> &getVertices() const noexcept { return m_vertices; }
+
+    constexpr u32 getStride() const noexcept { return m_stride; }
+    constexpr u32 getLength() const noexcept { return m_length; }
+    constexpr GLenum getMode() const noexcept { return m_mode; }
+
+    /**
+     * Number of vertices writeDrawVertices() produces. These are the data points themselves,
+     * unless a subclass samples an interpolation of them instead.
+     */
+    virtual u32 getDrawLength() const { return m_length; }
+
+    /**
+     * Writes getDrawLength() vertices of getStride() floats each, e.g. into a mapped GPU buffer.
+     */
+    virtual void writeDrawVertices( f32 *destination ) const;
 
-    void render() const;
+    /**
+     * Bounds of the data points, converted from system first, e.g. the one the vertex shader applies.
+     */
+    virtual Bounds computeBounds( CoordinateSystem system = CoordinateSystem::Cartesian ) const;
 
     /**
      * An orthonormal basis for the local coordiantes local.<br>
@@ -65,6 +91,14 @@ public:
 
     virtual glm::fvec4 transform( const glm::fvec2 &local, const glm::fvec4 &direction ) const;
 
+    /**
+     * Moves the first three floats of count vertices of stride floats from the local coordinates at times
+     * to world coordinates, like transform(times[i], (x, y, z, 1)) for each.<br>
+     * Called once per child mesh, subclasses override it with placeAlong() on their own type,
+     * so the per-vertex path does not go through virtual calls.
+     */
+    virtual void placeLocal( const f32 *times, f32 *vertices, u32 count, u32 stride ) const;
+
     virtual glm::fvec3 at( f32 t ) const;
 
     virtual glm::fvec3 diffAt( f32 t ) const;
@@ -79,10 +113,7 @@ public:
 
 protected:
     std::vector<f32> m_vertices;
-    GLuint m_vaoID;
-    GLuint m_vboID;
     GLenum m_mode;
     u32 m_stride;
     u32 m_length;
-    GLsizeiptr m_bufferSize;
 };
@@ -0,0 +1,39 @@
+#include "MeshSpec.hpp"
+#include "3D/Interpolation/SmoothICurve.hpp"
+#include "3D/Signal/SignalEnvelope.hpp"
+#include <iostream>
+
+
+std::shared_ptr<const Mesh> buildMesh( const MeshSpec &spec, const CSVFile &csv, const Mesh *parent, const CoordinateSystem system )
+{
+    // e.g. only a header, or a file caught by a reload while it is written
+    if (csv.getRowCount() == 0) {
+        std::clog << "[ ERROR  ][Load   ] \"" << csv.getFilename() << "\" has no rows" << std::endl;
+        return nullptr;
+    }
+
+    // Missing columns take their default value, but not columns with cells which are no numbers or invalid expressions
+    const bool isSignal = spec.kind == MeshSpec::Kind::Signal;
+    for (const auto *column : { &spec.T, &spec.X, &spec.Y, &spec.Z }) {
+        const std::vector<f32> *values;
+        if ((isSignal && (column == &spec.X || column == &spec.Z)) || csv.resolveValues(column->first, values))
+            continue;
+
+        std::clog << "[ ERROR  ][Load   ] \"" << csv.getFilename() << "\": <" << column->first << "> has no values, the mesh is not built" << std::endl;
+        return nullptr;
+    }
+
+    if (spec.kind == MeshSpec::Kind::Curve) {
+        const auto curve = parent ? std::make_shared<SmoothICurve>(csv, spec.T, spec.X, spec.Y, spec.Z, parent, spec.cyclic, system)
+                                  : std::make_shared<SmoothICurve>(csv, std::vector{ spec.X, spec.Y, spec.Z, spec.T }, spec.T, spec.cyclic, system);
+        curve->setTolerance(spec.tolerance);
+        return curve;
+    }
+
+    if (spec.kind == MeshSpec::Kind::Signal)
+        return std::make_shared<SignalEnvelope>(csv, spec.T, spec.Y, spec.envelopeCache);
+
+    if (parent)
+        return std::make_shared<Mesh>(csv, spec.T, spec.X, spec.Y, spec.Z, parent, spec.mode, system);
+    return std::make_shared<Mesh>(csv, std::vector{ spec.X, spec.Y, spec.Z, spec.T }, spec.mode, system);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <glad.h>
+#include "defines.hpp"
+#include "IO/CSVReader.hpp"
+#include "3D/CoordinateSystem.hpp"
+#include "3D/Mesh.hpp"
+
+
+constexpr i32 NO_PARENT = -1;
+
+/**
+ * Describes how a mesh is built from a CSV file, so it can be rebuilt when the file changes.
+ */
+struct MeshSpec {
+    enum class Kind {
+        Mesh,  // plain vertex data drawn with mode
+        Curve, // SmoothICurve, drawn as line strip or loop
+        Signal // SignalEnvelope of Y over T, drawn at screen resolution
+    };
+
+    enum class Sweep {
+        Line,  // polyline through the samples
+        Tube,  // shaded tube of radius around the samples
+        Ribbon // band of width 2 * radius along the normals
+    };
+
+    std::string file;
+    Kind kind{ Kind::Mesh };
+
+    // column name and its scaling (time) or default value (coordinates)
+    std::pair<std::string, f32> T{ "T", 1.0f };
+    std::pair<std::string, f32> X{ "X", 0.0f };
+    std::pair<std::string, f32> Y{ "Y", 0.0f };
+    std::pair<std::string, f32> Z{ "Z", 0.0f };
+
+    // of T/X/Y/Z, signals are always cartesian
+    CoordinateSystem system{ CoordinateSystem::Cartesian };
+
+    // index of the mesh whose orthonormal frames are the local coordinates, must be added before
+    i32 parent{ NO_PARENT };
+
+    bool cyclic{ false };
+    GLenum mode{ GL_LINE_STRIP };
+
+    // curves only: maximal distance of the drawn polyline to the spline, 0 draws the data points
+    f32 tolerance{ 1e-3f };
+
+    // curves only: geometry swept along the orthonormal frames of the samples, built on the GPU
+    Sweep sweep{ Sweep::Line };
+    f32 radius{ 0.01f };
+
+    // drawn as density image of its vertices instead of with mode, for large point clouds
+    bool density{ false };
+
+    // signals only: directory the envelope pyramid is stored in, empty to build it on every load
+    std::string envelopeCache;
+};
+
+
+/**
+ * Builds the mesh spec describes from csv, without GL, so tools without a context build the same meshes as Scene.
+ * @param parent mesh whose frames the local coordinates are in, nullptr for none
+ * @param system coordinate system converted on the CPU
+ * @return nullptr if csv has no rows, or a column of spec has cells which are no numbers or is an invalid expression
+ */
+std::shared_ptr<const Mesh> buildMesh( const MeshSpec &spec, const CSVFile &csv, const Mesh *parent, CoordinateSystem system );
@@ -0,0 +1,37 @@
+#define GLM_ENABLE_EXPERIMENTAL
+#include "OrbitCamera.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtx/transform.hpp>
+
+
+OrbitCamera::OrbitCamera( const f64 yaw, const f64 pitch, const f64 distance )
+    : m_yaw(yaw)
+    , m_pitch(pitch)
+    , m_distance(distance)
+{}
+
+void OrbitCamera::rotate( const f64 yaw, const f64 pitch )
+{
+    constexpr f64 MAX_PITCH = 1.5;
+    m_yaw += yaw;
+    m_pitch = std::clamp(m_pitch + pitch, -MAX_PITCH, MAX_PITCH);
+}
+
+void OrbitCamera::zoom( const f64 steps )
+{
+    m_distance = std::clamp(m_distance * std::pow(0.9, steps), 0.1, 512.0);
+}
+
+glm::fmat4 OrbitCamera::getViewProjection( const int width, const int height ) const
+{
+    const glm::dmat4 proj = glm::perspectiveFov<double>(glm::radians(45.0), width, height, 0.03, 1024.0);
+    constexpr glm::dvec3 X = { 1.0f, 0.0f, 0.0f };
+    constexpr glm::dvec3 Y = { 0.0f, 1.0f, 0.0f };
+
+    const glm::dvec3 position = m_distance * glm::dvec3(sin(m_yaw) * cos(m_pitch), sin(m_pitch), cos(m_yaw) * cos(m_pitch));
+
+    const glm::dmat4 ROT = glm::rotate(m_pitch, X) * glm::rotate(-m_yaw, Y);
+
+    return proj * ROT * glm::translate(-position);
+}
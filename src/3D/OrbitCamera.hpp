@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "defines.hpp"
+
+
+/**
+ * Camera on a sphere around the origin, looking at it.<br>
+ * Yaw turns around the y-axis, pitch is the elevation above the xz-plane.
+ */
+class OrbitCamera {
+public:
+    explicit OrbitCamera( f64 yaw = 0.0, f64 pitch = 0.78539816339744830962, f64 distance = 3.0 );
+
+    /**
+     * @param pitch radians, clamped so the camera never flips over the poles
+     */
+    void rotate( f64 yaw, f64 pitch );
+
+    /**
+     * Moves closer by 10% per step, negative steps move away.
+     */
+    void zoom( f64 steps );
+
+    glm::fmat4 getViewProjection( int width, int height ) const;
+
+    constexpr f64 getYaw() const noexcept { return m_yaw; }
+    constexpr f64 getPitch() const noexcept { return m_pitch; }
+    constexpr f64 getDistance() const noexcept { return m_distance; }
+
+private:
+    f64 m_yaw;
+    f64 m_pitch;
+    f64 m_distance;
+};
@@ -0,0 +1,285 @@
+#include "Scene.hpp"
+#include "3D/Interpolation/SmoothICurve.hpp"
+#include "IO/SceneSnapshot.hpp"
+#include "Memory/ScratchArena.hpp"
+#include "hash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+
+static std::shared_ptr<const CSVFile> readCSV( const std::string &file )
+{
+    auto csv = std::make_shared<CSVFile>(file);
+    if (!csv->read(','))
+        return nullptr;
+    return csv;
+}
+
+/**
+ * Copies a mesh out of a snapshot, it owns its vertices like a built one.
+ */
+static std::shared_ptr<const Mesh> restoreMesh( const MeshSpec &spec, const SnapshotMesh &stored )
+{
+    std::vector<f32> vertices(stored.vertices, stored.vertices + stored.vertexCount * stored.stride);
+    if (spec.kind != MeshSpec::Kind::Curve)
+        return std::make_shared<Mesh>(std::move(vertices), stored.stride, stored.mode);
+
+    std::vector<f32> time(stored.times, stored.times + stored.sampleCount);
+    std::vector<glm::fvec3> moments(stored.sampleCount);
+    for (u64 i = 0; i < stored.sampleCount; i++)
+        moments[i] = glm::fvec3(stored.moments[3 * i], stored.moments[3 * i + 1], stored.moments[3 * i + 2]);
+
+    const auto curve = std::make_shared<SmoothICurve>(std::move(vertices), stored.stride, std::move(time), std::move(moments), stored.cyclic);
+    curve->setTolerance(spec.tolerance);
+    return curve;
+}
+
+
+u32 Scene::add( const MeshSpec &spec )
+{
+    if (spec.parent >= static_cast<i32>(m_specs.size()))
+        throw std::invalid_argument("Parent mesh has to be added before its children");
+
+    m_specs.push_back(spec);
+    return static_cast<u32>(m_specs.size() - 1);
+}
+
+bool Scene::load()
+{
+    // Temporaries of all files and meshes, released at once after the load
+    const ScratchArena scratch;
+
+    std::map<std::string, std::shared_ptr<const CSVFile>> files;
+    for (const std::string &file : getFiles()) {
+        auto csv = readCSV(file);
+        if (!csv)
+            return false;
+        files[file] = std::move(csv);
+    }
+
+    std::vector<std::shared_ptr<const Mesh>> meshes;
+    for (u32 i = 0; i < m_specs.size(); i++) {
+        const MeshSpec &spec = m_specs[i];
+        const Mesh *parent = (spec.parent == NO_PARENT) ? nullptr : meshes[spec.parent].get();
+        meshes.push_back(buildMesh(spec, *files[spec.file], parent, getBuildSystem(i)));
+        if (!meshes.back())
+            return false;
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_files = std::move(files);
+    m_latest = meshes;
+    m_meshes = std::move(meshes);
+    return true;
+}
+
+bool Scene::open( const std::string &snapshot )
+{
+    const auto start = std::chrono::steady_clock::now();
+    const ScratchArena scratch;
+
+    std::unique_ptr<SceneSnapshot> stored;
+    if (std::filesystem::exists(snapshot))
+        stored = std::make_unique<SceneSnapshot>(snapshot);
+
+    // Only the files of stale meshes are read
+    std::map<std::string, std::shared_ptr<const CSVFile>> files;
+    std::vector<std::shared_ptr<const Mesh>> meshes;
+    std::vector<u64> hashes;
+    u32 restored = 0;
+    for (u32 i = 0; i < m_specs.size(); i++) {
+        const MeshSpec &spec = m_specs[i];
+        hashes.push_back(getSourceHash(i, (spec.parent == NO_PARENT) ? 0 : hashes[spec.parent]));
+
+        if (stored && stored->isValid() && i < stored->getMeshCount() && spec.kind != MeshSpec::Kind::Signal) {
+            const SnapshotMesh &entry = stored->getMesh(i);
+            if (entry.sourceHash == hashes[i] && entry.kind == static_cast<u32>(spec.kind)) {
+                meshes.push_back(restoreMesh(spec, entry));
+                restored++;
+                continue;
+            }
+        }
+
+        auto &csv = files[spec.file];
+        if (!csv && !(csv = readCSV(spec.file)))
+            return false;
+
+        const Mesh *parent = (spec.parent == NO_PARENT) ? nullptr : meshes[spec.parent].get();
+        meshes.push_back(buildMesh(spec, *csv, parent, getBuildSystem(i)));
+        if (!meshes.back())
+            return false;
+    }
+    stored.reset();
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_files = std::move(files);
+        m_latest = meshes;
+        m_meshes = std::move(meshes);
+    }
+
+    const auto signals = static_cast<u32>(std::count_if(m_specs.begin(), m_specs.end(), []( const MeshSpec &spec ) {
+        return spec.kind == MeshSpec::Kind::Signal;
+    }));
+    const u32 built = getMeshCount() - restored - signals;
+    std::cout << "[  INFO  ][Scene  ] Opened in " << std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count()
+              << " ms: " << restored << " meshes restored from \"" << snapshot << "\", " << built << " built" << std::endl;
+
+    if (built > 0)
+        return save(snapshot);
+    return true;
+}
+
+bool Scene::save( const std::string &snapshot ) const
+{
+    std::vector<std::shared_ptr<const Mesh>> meshes;
+    {
+        std::lock_guard lock(m_mutex);
+        meshes = m_latest;
+    }
+
+    std::vector<u64> hashes;
+    std::vector<SnapshotMesh> entries;
+    for (u32 i = 0; i < m_specs.size(); i++) {
+        const MeshSpec &spec = m_specs[i];
+        const Mesh &mesh = *meshes[i];
+        hashes.push_back(getSourceHash(i, (spec.parent == NO_PARENT) ? 0 : hashes[spec.parent]));
+
+        SnapshotMesh &entry = entries.emplace_back(SnapshotMesh{
+            hashes[i], spec.parent, static_cast<u32>(spec.kind), mesh.getMode(), mesh.getStride(), spec.cyclic,
+            mesh.getVertices().data(), mesh.getLength(), nullptr, nullptr, 0
+        });
+
+        // Signals are stored in their envelope cache
+        if (spec.kind == MeshSpec::Kind::Signal)
+            entry.vertexCount = 0;
+        else if (const auto *curve = dynamic_cast<const SmoothICurve *>(&mesh); curve && curve->getMoments().size() == curve->getTimes().size()) {
+            entry.times = curve->getTimes().data();
+            entry.moments = reinterpret_cast<const f32 *>(curve->getMoments().data());
+            entry.sampleCount = curve->getTimes().size();
+        }
+    }
+
+    return SceneSnapshot::write(snapshot, entries);
+}
+
+bool Scene::rebuild( const std::string &file, Rebuild &result )
+{
+    // Start from the latest rebuilt state, which may not be applied yet
+    std::vector<std::shared_ptr<const Mesh>> meshes;
+    std::map<std::string, std::shared_ptr<const CSVFile>> files;
+    {
+        std::lock_guard lock(m_mutex);
+        meshes = m_latest;
+        files = m_files;
+    }
+
+    const ScratchArena scratch;
+
+    result.file = file;
+    result.meshes.clear();
+
+    auto csv = readCSV(file);
+    if (!csv)
+        return false;
+    files[file] = std::move(csv);
+
+    // Parents precede children, so a single pass finds all descendants
+    std::set<u32> affected;
+    for (u32 i = 0; i < m_specs.size(); i++) {
+        const MeshSpec &spec = m_specs[i];
+        if (spec.file == file || (spec.parent != NO_PARENT && affected.contains(spec.parent)))
+            affected.insert(i);
+    }
+
+    for (const u32 i : affected) {
+        const MeshSpec &spec = m_specs[i];
+        // Files of meshes restored by open() are read on their first rebuild
+        auto &source = files[spec.file];
+        if (!source && !(source = readCSV(spec.file)))
+            return false;
+
+        const Mesh *parent = (spec.parent == NO_PARENT) ? nullptr : meshes[spec.parent].get();
+        meshes[i] = buildMesh(spec, *source, parent, getBuildSystem(i));
+        if (!meshes[i])
+            return false;
+        result.meshes.emplace_back(i, meshes[i]);
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_files = std::move(files);
+    m_latest = std::move(meshes);
+    return true;
+}
+
+void Scene::apply( Rebuild &&result )
+{
+    std::lock_guard lock(m_mutex);
+    for (auto &[index, mesh] : result.meshes)
+        m_meshes[index] = std::move(mesh);
+}
+
+std::vector<std::string> Scene::getFiles() const
+{
+    std::set<std::string> files;
+    for (const MeshSpec &spec : m_specs)
+        files.insert(spec.file);
+    return { files.begin(), files.end() };
+}
+
+std::shared_ptr<const Mesh> Scene::getMesh( const u32 index ) const
+{
+    std::lock_guard lock(m_mutex);
+    return m_meshes[index];
+}
+
+CoordinateSystem Scene::getShaderSystem( const u32 index ) const
+{
+    const MeshSpec &spec = m_specs[index];
+    if (spec.kind == MeshSpec::Kind::Signal || spec.parent != NO_PARENT || spec.sweep != MeshSpec::Sweep::Line)
+        return CoordinateSystem::Cartesian;
+
+    const bool hasChildren = std::any_of(m_specs.begin(), m_specs.end(), [index]( const MeshSpec &child ) {
+        return child.parent == static_cast<i32>(index);
+    });
+    return hasChildren ? CoordinateSystem::Cartesian : spec.system;
+}
+
+CoordinateSystem Scene::getBuildSystem( const u32 index ) const
+{
+    const MeshSpec &spec = m_specs[index];
+    if (spec.kind == MeshSpec::Kind::Signal || getShaderSystem(index) != CoordinateSystem::Cartesian)
+        return CoordinateSystem::Cartesian;
+    return spec.system;
+}
+
+u64 Scene::getSourceHash( const u32 index, const u64 parentHash ) const
+{
+    const MeshSpec &spec = m_specs[index];
+    const auto bytes = []( const auto &value ) {
+        return std::string_view(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+
+    // Size and modification time stand in for the content, like the envelope cache keys
+    std::error_code error;
+    const auto size = std::filesystem::file_size(spec.file, error);
+    const auto modified = std::filesystem::last_write_time(spec.file, error).time_since_epoch().count();
+
+    u64 key = HASH_BASIS;
+    key = hashBytes(key, std::filesystem::absolute(spec.file).lexically_normal().string());
+    key = hashBytes(key, std::to_string(size) + ':' + std::to_string(modified));
+    for (const auto &[column, value] : { spec.T, spec.X, spec.Y, spec.Z }) {
+        key = hashBytes(key, column);
+        key = hashBytes(key, bytes(value));
+    }
+    key = hashBytes(key, bytes(spec.kind));
+    key = hashBytes(key, bytes(spec.mode));
+    key = hashBytes(key, bytes(spec.cyclic));
+    key = hashBytes(key, bytes(getBuildSystem(index)));
+    key = hashBytes(key, bytes(parentHash));
+    return key;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "IO/CSVReader.hpp"
+#include "3D/CoordinateSystem.hpp"
+#include "3D/Mesh.hpp"
+#include "3D/MeshSpec.hpp"
+
+
+/**
+ * A set of meshes built from CSV files, with parents always preceding their children.<br>
+ * Built meshes are immutable and shared, so a rebuild can run on a background
+ * thread while the current meshes are rendered, and apply() swaps the results in.
+ */
+class Scene {
+public:
+    struct Rebuild {
+        std::string file;
+        std::vector<std::pair<u32, std::shared_ptr<const Mesh>>> meshes;
+    };
+
+    u32 add( const MeshSpec &spec );
+
+    /**
+     * Reads all files and builds all meshes.
+     * @return false if a file cannot be read or a mesh cannot be built of it, the meshes are not changed then
+     */
+    bool load();
+
+    /**
+     * Like load(), but restores every mesh whose sources are unchanged from snapshot instead of building it.<br>
+     * A mesh is stale when its file, its spec or its parent changed, only stale meshes are built from their files
+     * and the snapshot is rewritten afterwards. Signals are always built, they keep their own envelope cache.
+     * @param snapshot written by save(), built from scratch if missing
+     */
+    bool open( const std::string &snapshot );
+
+    /**
+     * Writes the latest meshes to snapshot, for open() on the next start.
+     */
+    bool save( const std::string &snapshot ) const;
+
+    /**
+     * Re-reads file and rebuilds every mesh using it, plus all their descendants.<br>
+     * May run on a background thread while the live meshes are rendered,
+     * but rebuilds must not run concurrently to each other.
+     * @return false if a file cannot be read or a mesh cannot be built of it, the previous meshes are kept then
+     */
+    bool rebuild( const std::string &file, Rebuild &result );
+
+    /**
+     * Swaps the rebuilt meshes in, call at a frame boundary.
+     */
+    void apply( Rebuild &&result );
+
+    std::vector<std::string> getFiles() const;
+
+    std::shared_ptr<const Mesh> getMesh( u32 index ) const;
+
+    const MeshSpec &getSpec( u32 index ) const { return m_specs[index]; }
+
+    u32 getMeshCount() const noexcept { return static_cast<u32>(m_specs.size()); }
+
+    /**
+     * Coordinate system the vertex shader converts mesh index from. Meshes with parent or children are
+     * converted on the CPU while building instead, since children are placed along the converted parent.
+     * So are swept curves, their frames have to be cartesian.
+     */
+    CoordinateSystem getShaderSystem( u32 index ) const;
+
+private:
+    CoordinateSystem getBuildSystem( u32 index ) const;
+
+    /**
+     * Hash of everything mesh index is built from: its file's path, size and modification time, its spec
+     * and parentHash, the one of its parent.
+     */
+    u64 getSourceHash( u32 index, u64 parentHash ) const;
+
+    std::vector<MeshSpec> m_specs;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<const Mesh>> m_meshes; // applied, what is rendered
+    std::vector<std::shared_ptr<const Mesh>> m_latest; // rebuilt, possibly not applied yet
+    std::map<std::string, std::shared_ptr<const CSVFile>> m_files;
+};
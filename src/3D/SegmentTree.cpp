@@ -0,0 +1,54 @@
+#include "SegmentTree.hpp"
+#include <algorithm>
+#include <numeric>
+
+
+// Segments per leaf, a few are tested faster than descending further
+constexpr u32 LEAF_SIZE = 4;
+
+
+SegmentTree::SegmentTree( const std::vector<Bounds> &segments )
+{
+    if (segments.empty())
+        return;
+
+    m_segments.resize(segments.size());
+    std::iota(m_segments.begin(), m_segments.end(), 0u);
+    m_nodes.reserve(2 * segments.size() / LEAF_SIZE + 1);
+    build(segments, 0, static_cast<u32>(segments.size()));
+
+    m_bounds.resize(segments.size());
+    for (u64 i = 0; i < m_segments.size(); i++)
+        m_bounds[i] = segments[m_segments[i]];
+}
+
+u32 SegmentTree::build( const std::vector<Bounds> &segments, const u32 first, const u32 last )
+{
+    const auto index = static_cast<u32>(m_nodes.size());
+    m_nodes.push_back({ { }, first, last - first });
+
+    Bounds bounds;
+    Bounds centers;
+    for (u32 i = first; i < last; i++) {
+        const Bounds &segment = segments[m_segments[i]];
+        bounds.extend(segment);
+        centers.extend((segment.min + segment.max) * 0.5f);
+    }
+    m_nodes[index].bounds = bounds;
+    if (last - first <= LEAF_SIZE)
+        return index;
+
+    const glm::fvec3 extent = centers.max - centers.min;
+    const i32 axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    const u32 middle = first + (last - first) / 2;
+    std::nth_element(m_segments.begin() + first, m_segments.begin() + middle, m_segments.begin() + last, [&]( const u32 a, const u32 b ) {
+        return segments[a].min[axis] + segments[a].max[axis] < segments[b].min[axis] + segments[b].max[axis];
+    });
+
+    // Left child follows directly, the right one is linked
+    build(segments, first, middle);
+    const u32 right = build(segments, middle, last);
+    m_nodes[index].first = right;
+    m_nodes[index].count = 0;
+    return index;
+}
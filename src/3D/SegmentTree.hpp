@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "defines.hpp"
+#include "3D/Bounds.hpp"
+
+
+/**
+ * Bounding volume hierarchy over the segments of a curve, for nearest segment searches.<br>
+ * Nodes are stored depth first, so the left child of an inner node directly follows it.
+ */
+class SegmentTree {
+public:
+    SegmentTree() = default;
+
+    /**
+     * Builds the tree by median splits along the longest axis.
+     * @param segments bounds of every segment, e.g. of its control point hull
+     */
+    explicit SegmentTree( const std::vector<Bounds> &segments );
+
+    bool isEmpty() const noexcept { return m_nodes.empty(); }
+
+    /**
+     * Bounds of all segments, empty without any.
+     */
+    Bounds getBounds() const noexcept { return m_nodes.empty() ? Bounds{ } : m_nodes[0].bounds; }
+
+    /**
+     * Calls visit(segment) for every segment whose bounds are closer to point than the current best,
+     * nearer subtrees first so best shrinks early.
+     * @param best2 squared distance of the closest point so far, visit updates it
+     */
+    template<typename Visit>
+    void search( const glm::fvec3 &point, const f32 &best2, Visit &&visit ) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        // Nodes to visit with the distance to their bounds, computed when pushed
+        struct Entry {
+            u32 node;
+            f32 distance2;
+        };
+        Entry stack[64];
+        u32 size = 0;
+        stack[size++] = { 0, distance2(m_nodes[0].bounds, point) };
+        while (size > 0) {
+            const Entry entry = stack[--size];
+            if (entry.distance2 >= best2)
+                continue;
+
+            const Node &node = m_nodes[entry.node];
+            if (node.count > 0) {
+                for (u32 i = node.first; i < node.first + node.count; i++) {
+                    if (distance2(m_bounds[i], point) < best2)
+                        visit(m_segments[i]);
+                }
+                continue;
+            }
+
+            const Entry left{ entry.node + 1, distance2(m_nodes[entry.node + 1].bounds, point) };
+            const Entry right{ node.first, distance2(m_nodes[node.first].bounds, point) };
+            stack[size++] = (left.distance2 <= right.distance2) ? right : left;
+            stack[size++] = (left.distance2 <= right.distance2) ? left : right;
+        }
+    }
+
+    static f32 distance2( const Bounds &bounds, const glm::fvec3 &point ) noexcept
+    {
+        const glm::fvec3 d = glm::max(glm::max(bounds.min - point, point - bounds.max), glm::fvec3(0.0f));
+        return glm::dot(d, d);
+    }
+
+private:
+    struct Node {
+        Bounds bounds;
+        u32 first; // inner nodes: right child, leaves: first index into m_segments
+        u32 count; // segments of a leaf, 0 for inner nodes
+    };
+
+    u32 build( const std::vector<Bounds> &segments, u32 first, u32 last );
+
+    std::vector<Node> m_nodes;
+    std::vector<u32> m_segments; // in leaf order
+    std::vector<Bounds> m_bounds; // of m_segments, so leaves test them without indirection
+};
@@ -0,0 +1,146 @@
+#include "EnvelopePyramid.hpp"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+
+static constexpr u32 PYRAMID_MAGIC = 0x50454C50; // "PLEP"
+static constexpr u32 PYRAMID_VERSION = 1;
+
+// Blocks per parallel chunk, small levels are built by the calling thread alone
+static constexpr u64 BUILD_GRAIN = 1u << 15;
+
+struct PyramidHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u64 sampleCount;
+    u32 levelCount;
+    u32 padding;
+};
+
+
+static SampleBounds merge( const SampleBounds &a, const SampleBounds &b )
+{
+    return { std::min(a.min, b.min), std::max(a.max, b.max) };
+}
+
+
+EnvelopePyramid::EnvelopePyramid( std::vector<f32> &&samples )
+    : m_samples(std::move(samples))
+{}
+
+void EnvelopePyramid::build( ThreadPool &pool )
+{
+    m_levels.clear();
+
+    // Blocks running over the end are left out, getBounds() takes the tail from the level below
+    for (u64 size = m_samples.size() / 2; size > 0; size /= 2) {
+        std::vector<SampleBounds> &level = m_levels.emplace_back(size);
+
+        if (m_levels.size() == 1) {
+            pool.parallelFor(0, size, BUILD_GRAIN, [this, &level]( const u64 first, const u64 last ) {
+                for (u64 i = first; i < last; i++)
+                    level[i] = { std::min(m_samples[2 * i], m_samples[2 * i + 1]), std::max(m_samples[2 * i], m_samples[2 * i + 1]) };
+            });
+        }
+        else {
+            const std::vector<SampleBounds> &below = m_levels[m_levels.size() - 2];
+            pool.parallelFor(0, size, BUILD_GRAIN, [&below, &level]( const u64 first, const u64 last ) {
+                for (u64 i = first; i < last; i++)
+                    level[i] = merge(below[2 * i], below[2 * i + 1]);
+            });
+        }
+    }
+}
+
+SampleBounds EnvelopePyramid::getBounds( u64 first, u64 last ) const noexcept
+{
+    SampleBounds bounds{ std::numeric_limits<f32>::infinity(), -std::numeric_limits<f32>::infinity() };
+
+    // Bottom up, taking the unpaired block at either end of the range on each level
+    if (first & 1) {
+        bounds = merge(bounds, { m_samples[first], m_samples[first] });
+        first++;
+    }
+    if (last & 1) {
+        last--;
+        bounds = merge(bounds, { m_samples[last], m_samples[last] });
+    }
+
+    for (const std::vector<SampleBounds> &level : m_levels) {
+        first /= 2;
+        last /= 2;
+        if (first >= last)
+            break;
+
+        if (first & 1)
+            bounds = merge(bounds, level[first++]);
+        if (last & 1)
+            bounds = merge(bounds, level[--last]);
+    }
+
+    return bounds;
+}
+
+u64 EnvelopePyramid::getMemoryUsage() const noexcept
+{
+    u64 bytes = m_samples.size() * sizeof(f32);
+    for (const std::vector<SampleBounds> &level : m_levels)
+        bytes += level.size() * sizeof(SampleBounds);
+    return bytes;
+}
+
+bool EnvelopePyramid::load( const std::filesystem::path &path, const u64 key )
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    PyramidHeader header{ };
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+
+    if (header.magic != PYRAMID_MAGIC || header.version != PYRAMID_VERSION || header.key != key || header.sampleCount != m_samples.size())
+        return false;
+
+    std::vector<std::vector<SampleBounds>> levels;
+    u64 size = m_samples.size() / 2;
+    for (u32 l = 0; l < header.levelCount; l++, size /= 2) {
+        std::vector<SampleBounds> &level = levels.emplace_back(size);
+        if (!file.read(reinterpret_cast<char *>(level.data()), static_cast<std::streamsize>(size * sizeof(SampleBounds))))
+            return false;
+    }
+
+    if (size > 0)
+        return false; // levels missing
+
+    m_levels = std::move(levels);
+    return true;
+}
+
+bool EnvelopePyramid::save( const std::filesystem::path &path, const u64 key ) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    const PyramidHeader header{ PYRAMID_MAGIC, PYRAMID_VERSION, key, m_samples.size(), getLevelCount(), 0 };
+
+    // Write to a temporary file first, a concurrent load never reads half an entry
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const std::vector<SampleBounds> &level : m_levels)
+            file.write(reinterpret_cast<const char *>(level.data()), static_cast<std::streamsize>(level.size() * sizeof(SampleBounds)));
+        if (!file)
+            return false;
+    }
+
+    std::filesystem::rename(tmpPath, path, error);
+    return !error;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "defines.hpp"
+#include "Threading/ThreadPool.hpp"
+
+
+struct SampleBounds {
+    f32 min;
+    f32 max;
+};
+
+
+/**
+ * Min/max pyramid over a 1D signal, for drawing it at screen resolution.<br>
+ * Level l holds the bounds of consecutive blocks of 2^l samples, so the bounds of any
+ * sample range are combined from at most two blocks per level. The levels take as much
+ * memory as the samples themselves.
+ */
+class EnvelopePyramid {
+public:
+    explicit EnvelopePyramid( std::vector<f32> &&samples );
+
+    /**
+     * Builds all levels, each one in parallel on pool.
+     */
+    void build( ThreadPool &pool = ThreadPool::getShared() );
+
+    /**
+     * Bounds of the samples [first, last), which must not be empty.
+     */
+    SampleBounds getBounds( u64 first, u64 last ) const noexcept;
+
+    u64 getSampleCount() const noexcept { return m_samples.size(); }
+    f32 getSample( const u64 index ) const noexcept { return m_samples[index]; }
+
+    u32 getLevelCount() const noexcept { return static_cast<u32>(m_levels.size()); }
+
+    /**
+     * @return bytes of samples and levels
+     */
+    u64 getMemoryUsage() const noexcept;
+
+    /**
+     * Reads the levels stored for the same samples under key.
+     * @return false if there is no matching entry, the levels are unchanged then
+     */
+    bool load( const std::filesystem::path &path, u64 key );
+
+    /**
+     * Stores the levels under key, replacing an older entry.
+     */
+    bool save( const std::filesystem::path &path, u64 key ) const;
+
+private:
+    std::vector<f32> m_samples;
+
+    // m_levels[l - 1] is level l, level 0 are the samples
+    std::vector<std::vector<SampleBounds>> m_levels;
+};
@@ -0,0 +1,246 @@
+#include "SignalEnvelope.hpp"
+#include "hash.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+
+// Upper limit of buckets per frame, a pixel row or column is never longer
+static constexpr u64 MAX_BUCKETS = 1u << 16;
+
+// Buckets per parallel chunk when writing the envelope
+static constexpr u64 BUCKET_GRAIN = 1024;
+
+
+static std::vector<f32> readSamples( const CSVFile &csv, const std::pair<std::string, f32> &value )
+{
+    if (const auto column = csv.getValues(value.first))
+        return *column;
+    return std::vector<f32>(csv.getRowCount(), value.second);
+}
+
+/**
+ * Key of a cached pyramid, changes with the file, its modification time and the column.
+ */
+static u64 getCacheKey( const std::string &file, const std::string &column )
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(file, error);
+    const auto modified = std::filesystem::last_write_time(file, error).time_since_epoch().count();
+
+    u64 key = HASH_BASIS;
+    key = hashBytes(key, std::filesystem::absolute(file).lexically_normal().string());
+    key = hashBytes(key, column);
+    key = hashBytes(key, std::to_string(size) + ':' + std::to_string(modified));
+    return key;
+}
+
+static std::filesystem::path getCachePath( const std::string &directory, const std::string &file, const std::string &column )
+{
+    std::string fileName = std::filesystem::path(file).lexically_normal().string() + '_' + column;
+    for (char &c : fileName) {
+        // Expressions may contain any character
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-')
+            c = '_';
+    }
+
+    return std::filesystem::path(directory) / (fileName + ".envelope");
+}
+
+
+SignalEnvelope::SignalEnvelope( const CSVFile &csv,
+                                const std::pair<std::string, f32> &T,
+                                const std::pair<std::string, f32> &value,
+                                const std::string &cacheDirectory )
+    : Mesh(std::vector<f32>{ }, 4, GL_LINE_STRIP)
+    , m_pyramid(readSamples(csv, value))
+    , m_startTime(0.0)
+    , m_timeStep(T.second)
+{
+    const u64 n = m_pyramid.getSampleCount();
+
+    if (const auto Tcol = csv.getValues(T.first); nullptr != Tcol && n > 0) {
+        m_times.assign(Tcol->begin(), Tcol->begin() + n);
+
+        if (!std::is_sorted(m_times.begin(), m_times.end())) {
+            std::clog << "[WARNING ][Signal ] <" << T.first << "> in \"" << csv.getFilename()
+                      << "\" does not increase, the samples are spread evenly instead" << std::endl;
+            m_startTime = m_times.front();
+            m_timeStep = (n > 1) ? (m_times.back() - m_times.front()) / static_cast<f64>(n - 1) : 1.0;
+            m_times.clear();
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    const std::filesystem::path cachePath = getCachePath(cacheDirectory, csv.getFilename(), value.first);
+    const u64 key = cacheDirectory.empty() ? 0 : getCacheKey(csv.getFilename(), value.first);
+
+    const bool cached = !cacheDirectory.empty() && m_pyramid.load(cachePath, key);
+    if (!cached) {
+        m_pyramid.build();
+        if (!cacheDirectory.empty() && !m_pyramid.save(cachePath, key))
+            std::clog << "[WARNING ][Signal ] Cannot store envelope in \"" << cachePath.string() << '"' << std::endl;
+    }
+
+    const f64 milliseconds = std::chrono::duration<f64, std::milli>(clock::now() - start).count();
+    std::cout << "[  INFO  ][Signal ] " << n << " samples of <" << value.first << "> in \"" << csv.getFilename() << "\", envelope "
+              << (cached ? "loaded" : "built") << " in " << milliseconds << " ms (" << m_pyramid.getLevelCount() << " levels, "
+              << static_cast<f64>(m_pyramid.getMemoryUsage()) / (1 << 20) << " MiB)" << std::endl;
+}
+
+f64 SignalEnvelope::getTime( const u64 index ) const noexcept
+{
+    return m_times.empty() ? m_startTime + static_cast<f64>(index) * m_timeStep : m_times[index];
+}
+
+u64 SignalEnvelope::getIndex( const f64 time ) const noexcept
+{
+    const u64 n = m_pyramid.getSampleCount();
+    if (!m_times.empty())
+        return std::lower_bound(m_times.begin(), m_times.end(), time) - m_times.begin();
+
+    if (m_timeStep <= 0.0)
+        return 0;
+    return static_cast<u64>(std::clamp(std::ceil((time - m_startTime) / m_timeStep), 0.0, static_cast<f64>(n)));
+}
+
+Bounds SignalEnvelope::computeBounds( CoordinateSystem ) const
+{
+    const u64 n = m_pyramid.getSampleCount();
+    if (n == 0)
+        return { };
+
+    const SampleBounds values = m_pyramid.getBounds(0, n);
+    return { { static_cast<f32>(getTime(0)), values.min, 0.0f }, { static_cast<f32>(getTime(n - 1)), values.max, 0.0f } };
+}
+
+u32 SignalEnvelope::writeEnvelope( const glm::fmat4 &MVP, const glm::fvec4 &viewport, std::vector<f32> &vertices ) const
+{
+    const u64 n = m_pyramid.getSampleCount();
+    if (n < 2)
+        return 0;
+
+    const f64 startTime = getTime(0);
+    const f64 endTime = getTime(n - 1);
+    const f64 invDuration = (endTime > startTime) ? 1.0 / (endTime - startTime) : 0.0;
+
+    /*
+     * Clip the time axis A + s * D, s in [0, 1], against the left, right and near plane.
+     * In clip space each plane is a linear function of s which has to be positive.
+     */
+    const SampleBounds range = m_pyramid.getBounds(0, n);
+    const f32 middle = 0.5f * (range.min + range.max);
+    const glm::fvec4 A = MVP * glm::fvec4(startTime, middle, 0.0f, 1.0f);
+    const glm::fvec4 D = MVP * glm::fvec4(endTime, middle, 0.0f, 1.0f) - A;
+
+    f32 s0 = 0.0f;
+    f32 s1 = 1.0f;
+    for (const glm::fvec2 plane : { glm::fvec2(A.w + A.x, D.w + D.x), glm::fvec2(A.w - A.x, D.w - D.x), glm::fvec2(A.w + A.z, D.w + D.z) }) {
+        if (plane.y == 0.0f) {
+            if (plane.x < 0.0f)
+                return 0;
+            continue;
+        }
+
+        const f32 s = -plane.x / plane.y;
+        if (plane.y > 0.0f)
+            s0 = std::max(s0, s);
+        else
+            s1 = std::min(s1, s);
+    }
+    if (s0 >= s1)
+        return 0;
+
+    /*
+     * One bucket per pixel column (or row, if the axis is closer to vertical on screen) the projected
+     * axis crosses. The boundary times follow from inverting the projection at the pixel borders,
+     * so under perspective the buckets just get longer with the distance.
+     */
+    const u32 axis = (std::abs(D.x * A.w - A.x * D.w) * viewport.x >= std::abs(D.y * A.w - A.y * D.w) * viewport.y) ? 0 : 1;
+    const f64 pixelCount = viewport[axis];
+    const auto getPixel = [&]( const f64 s ) {
+        const f64 ndc = (A[axis] + s * D[axis]) / (A.w + s * D.w);
+        return std::clamp(std::floor((0.5 * ndc + 0.5) * pixelCount), -pixelCount, 2.0 * pixelCount);
+    };
+    const f64 startPixel = getPixel(s0);
+    const f64 direction = (getPixel(s1) >= startPixel) ? 1.0 : -1.0;
+    const u64 buckets = std::min(static_cast<u64>(std::abs(getPixel(s1) - startPixel)) + 1, MAX_BUCKETS);
+
+    // Samples on screen, plus one beyond either end so the line leaves the screen
+    const u64 first = getIndex(startTime + s0 * (endTime - startTime));
+    const u64 last = std::min(getIndex(startTime + s1 * (endTime - startTime)) + 1, n);
+    const u64 lead = (first > 0) ? 1 : 0;
+    const u64 tail = (last < n || s1 < 1.0f) ? 1 : 0;
+
+    const size_t offset = vertices.size();
+    const auto writeVertex = [startTime, invDuration]( f32 *vertex, const f64 time, const f32 value ) {
+        vertex[0] = static_cast<f32>(time);
+        vertex[1] = value;
+        vertex[2] = 0.0f;
+        vertex[3] = static_cast<f32>((time - startTime) * invDuration);
+    };
+
+    // Few samples per pixel are drawn as they are
+    if (last - first <= 4 * buckets) {
+        vertices.resize(offset + 4 * (last - first + lead));
+        for (u64 i = first - lead; i < last; i++)
+            writeVertex(&vertices[offset + 4 * (i + lead - first)], getTime(i), m_pyramid.getSample(i));
+        return static_cast<u32>(last - first + lead);
+    }
+
+    const u64 end = last - tail;
+
+    // Index of the first sample in bucket, whose pixel border solves (A + s D)[axis] = ndc * (A + s D).w for s
+    const auto getBoundary = [&, this]( const u64 bucket ) {
+        if (bucket == 0)
+            return first;
+        if (bucket == buckets)
+            return end;
+
+        const f64 border = startPixel + static_cast<f64>(bucket) * direction + (direction > 0.0 ? 0.0 : 1.0);
+        const f64 ndc = 2.0 * border / pixelCount - 1.0;
+        const f64 s = (ndc * A.w - A[axis]) / (D[axis] - ndc * D.w);
+        return std::clamp(getIndex(startTime + s * (endTime - startTime)), first, end);
+    };
+
+    /*
+     * first, min, max and last per bucket, all within its pixel column, draw the same pixels as all samples.
+     * Only the samples beyond the screen edges are drawn as they are.
+     */
+    vertices.resize(offset + 4 * (lead + 4 * buckets + tail));
+    if (lead)
+        writeVertex(&vertices[offset], getTime(first - 1), m_pyramid.getSample(first - 1));
+    if (tail)
+        writeVertex(&vertices[vertices.size() - 4], getTime(end), m_pyramid.getSample(end));
+
+    ThreadPool::getShared().parallelFor(0, buckets, BUCKET_GRAIN, [&]( const u64 begin, const u64 stop ) {
+        for (u64 b = begin; b < stop; b++) {
+            f32 *vertex = &vertices[offset + 4 * lead + 16 * b];
+            const u64 a = getBoundary(b);
+            const u64 z = getBoundary(b + 1);
+
+            if (a >= z) {
+                // No sample in this bucket, the strip runs straight to the next one
+                const u64 i = std::min(a, end - 1);
+                for (u32 k = 0; k < 4; k++)
+                    writeVertex(vertex + 4 * k, getTime(i), m_pyramid.getSample(i));
+                continue;
+            }
+
+            const SampleBounds bounds = m_pyramid.getBounds(a, z);
+            const f64 center = 0.5 * (getTime(a) + getTime(z - 1));
+            writeVertex(vertex, getTime(a), m_pyramid.getSample(a));
+            writeVertex(vertex + 4, center, bounds.min);
+            writeVertex(vertex + 8, center, bounds.max);
+            writeVertex(vertex + 12, getTime(z - 1), m_pyramid.getSample(z - 1));
+        }
+    });
+
+    return static_cast<u32>(lead + 4 * buckets + tail);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "../Mesh.hpp"
+#include "EnvelopePyramid.hpp"
+#include <string>
+#include <vector>
+
+
+/**
+ * A long 1D signal value(t), drawn as its per-pixel envelope instead of all samples.<br>
+ * Every frame, the visible time range is split into one bucket per pixel and each bucket
+ * drawn by its first, min, max and last value (M4 aggregation). This covers the same pixels
+ * as the full polyline while touching O(pixels) data, apart from single pixels at the extremes
+ * and as long as the plane of the signal does not tilt away from the camera.<br>
+ * Not drawn by the SceneRenderer, getDrawLength() is 0.
+ */
+class SignalEnvelope : public Mesh {
+public:
+    SignalEnvelope() = delete;
+
+    /**
+     * Reads the signal and builds its EnvelopePyramid, or loads it from cacheDirectory.
+     * @param csv a CSVFile
+     * @param T time column and its scaling or uniform delta_t, times have to increase
+     * @param value value column or default value
+     * @param cacheDirectory where the pyramid is stored, empty to always build it
+     */
+    SignalEnvelope( const CSVFile &csv,
+                    const std::pair<std::string, f32> &T,
+                    const std::pair<std::string, f32> &value,
+                    const std::string &cacheDirectory = "" );
+
+    u32 getDrawLength() const override { return 0; }
+
+    void writeDrawVertices( f32 * ) const override {}
+
+    /**
+     * Bounds of the vertices (t, value, 0), from the top of the pyramid.
+     */
+    Bounds computeBounds( CoordinateSystem system = CoordinateSystem::Cartesian ) const override;
+
+    /**
+     * Appends the envelope of the part visible through MVP as a line strip
+     * of vertices (t, value, 0, normalized t).
+     * @param viewport (width, height, 1/width, 1/height)
+     * @return number of vertices appended
+     */
+    u32 writeEnvelope( const glm::fmat4 &MVP, const glm::fvec4 &viewport, std::vector<f32> &vertices ) const;
+
+    const EnvelopePyramid &getPyramid() const noexcept { return m_pyramid; }
+
+private:
+    f64 getTime( u64 index ) const noexcept;
+
+    /**
+     * @return index of the first sample at or after time
+     */
+    u64 getIndex( f64 time ) const noexcept;
+
+    EnvelopePyramid m_pyramid;
+    std::vector<f32> m_times; // empty if uniform
+    f64 m_startTime;
+    f64 m_timeStep;
+};
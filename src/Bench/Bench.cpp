@@ -0,0 +1,87 @@
+#include "Bench.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+f64 median( std::vector<f64> values )
+{
+    if (values.empty())
+        return 0.0;
+
+    const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+u64 getPeakResidentMemory()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{ };
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{ };
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<u64>(usage.ru_maxrss); // bytes
+#else
+    return static_cast<u64>(usage.ru_maxrss) * 1024; // KiB
+#endif
+#endif
+}
+
+bool buildDemoChain( Scene &scene )
+{
+    MeshSpec circle;
+    circle.file = "res/meshes/geodesicSphere.csv";
+    circle.kind = MeshSpec::Kind::Curve;
+    circle.cyclic = true;
+    const u32 circleIndex = scene.add(circle);
+
+    MeshSpec spiral;
+    spiral.file = "res/meshes/spiral.csv";
+    spiral.kind = MeshSpec::Kind::Curve;
+    spiral.parent = static_cast<i32>(circleIndex);
+    spiral.cyclic = true;
+    const u32 spiralIndex = scene.add(spiral);
+
+    MeshSpec tbnSpiral;
+    tbnSpiral.file = "res/meshes/ONF.csv";
+    tbnSpiral.parent = static_cast<i32>(spiralIndex);
+    tbnSpiral.mode = GL_LINES;
+    scene.add(tbnSpiral);
+
+    return scene.load();
+}
+
+bool rejectsFile( const std::string &name, const std::string &text, const std::string &parent )
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream(path, std::ios::binary) << text;
+
+    Scene scene;
+    MeshSpec spec;
+    if (!parent.empty()) {
+        spec.file = parent;
+        spec.kind = MeshSpec::Kind::Curve;
+        spec.parent = static_cast<i32>(scene.add(spec));
+        spec.kind = MeshSpec::Kind::Mesh;
+    }
+    spec.file = path.string();
+    scene.add(spec);
+
+    const bool loaded = scene.load();
+    std::filesystem::remove(path);
+    return !loaded;
+}
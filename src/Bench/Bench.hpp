@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+#include "3D/Scene.hpp"
+
+
+/**
+ * Command line of plotty-bench, <code>NAME [--runs N] [--duration S] [FILE]</code>.
+ */
+struct BenchOptions {
+    u32 runs = 10;
+    f64 duration = 2.0; // seconds of the benchmarks running for a time instead of runs
+    std::string file; // input of the benchmarks reading one
+};
+
+
+f64 median( std::vector<f64> values );
+
+/**
+ * Calls run() runs times.
+ * @return median of the seconds one call took
+ */
+template<typename Run>
+f64 measure( const u32 runs, const Run &run )
+{
+    using clock = std::chrono::steady_clock;
+    std::vector<f64> seconds;
+    for (u32 i = 0; i < runs; i++) {
+        const auto start = clock::now();
+        run();
+        seconds.push_back(std::chrono::duration<f64>(clock::now() - start).count());
+    }
+    return median(std::move(seconds));
+}
+
+/**
+ * @return peak resident memory of the process in bytes, 0 if unknown
+ */
+u64 getPeakResidentMemory();
+
+/**
+ * The chain circle -> spiral -> tbnSpiral of the demo scene, read from res/meshes.
+ */
+bool buildDemoChain( Scene &scene );
+
+/**
+ * Writes text to a file called name in the temporary directory and loads it as mesh,
+ * placed along the curve of the file parent unless it is empty.
+ * @return true if the load fails, as it has to for malformed files
+ */
+bool rejectsFile( const std::string &name, const std::string &text, const std::string &parent = "" );
+
+
+// Every benchmark returns 0 if its checks passed, see their sources
+
+int benchmarkClosest( const BenchOptions &options );
+
+int benchmarkLoad( const BenchOptions &options );
+
+int benchmarkParse( const BenchOptions &options );
+
+int benchmarkPlace( const BenchOptions &options );
+
+int benchmarkStream( const BenchOptions &options );
+
+int benchmarkTransforms( const BenchOptions &options );
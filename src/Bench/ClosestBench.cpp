@@ -0,0 +1,73 @@
+#include "Bench.hpp"
+#include <iostream>
+#include <limits>
+#include <random>
+#include "3D/Interpolation/SmoothICurve.hpp"
+
+
+/**
+ * Queries the closest points of 2^20 random points around the demo spiral options.runs times and reports the
+ * queries per second. A subset is checked against an exhaustive search over the samples drawn of the spiral:
+ * the closest point must never be farther than the nearest sample.
+ * @return 0 if every checked query passes
+ */
+int benchmarkClosest( const BenchOptions &options )
+{
+    using clock = std::chrono::steady_clock;
+    constexpr u64 QUERIES = 1 << 20;
+    constexpr u64 CHECKED = 256;
+
+    Scene scene;
+    if (!buildDemoChain(scene))
+        return 1;
+    if (scene.getShaderSystem(1) != CoordinateSystem::Cartesian) {
+        std::clog << "[ ERROR  ][Closest] The spiral is converted by the vertex shader, its closest points would not be cartesian" << std::endl;
+        return 1;
+    }
+    const auto mesh = scene.getMesh(1); // the spiral
+    const auto *curve = dynamic_cast<const SmoothICurve *>(mesh.get());
+    if (!curve)
+        return 1;
+
+    const Bounds bounds = curve->computeBounds();
+    const glm::fvec3 margin = (bounds.max - bounds.min) * 0.1f;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> uniform(0.0f, 1.0f);
+    std::vector<glm::fvec3> points(QUERIES);
+    for (glm::fvec3 &point : points) {
+        const glm::fvec3 u(uniform(random), uniform(random), uniform(random));
+        point = bounds.min - margin + u * (bounds.max - bounds.min + 2.0f * margin);
+    }
+
+    // The first query builds the segment tree
+    auto start = clock::now();
+    curve->closestPoint(points[0]);
+    const f64 buildTime = std::chrono::duration<f64>(clock::now() - start).count();
+
+    std::vector<CurvePoint> results(QUERIES);
+    const f64 queryTime = measure(options.runs, [&] { curve->closestPoints(points.data(), results.data(), QUERIES); });
+
+    std::vector<f32> samples(static_cast<u64>(curve->getDrawLength()) * curve->getStride());
+    curve->writeDrawVertices(samples.data());
+
+    u64 failed = 0;
+    f64 improvement = 0.0;
+    start = clock::now();
+    for (u64 q = 0; q < CHECKED; q++) {
+        f32 nearest = std::numeric_limits<f32>::max();
+        for (u64 k = 0; k < samples.size(); k += curve->getStride()) {
+            const glm::fvec3 sample(samples[k], samples[k + 1], samples[k + 2]);
+            nearest = std::min(nearest, glm::length(sample - points[q]));
+        }
+        failed += (results[q].distance > nearest * (1.0f + 1e-5f) + 1e-6f) ? 1 : 0;
+        improvement += nearest - results[q].distance;
+    }
+    const f64 exhaustiveTime = std::chrono::duration<f64>(clock::now() - start).count() / CHECKED;
+
+    std::cout << "[  INFO  ][Closest] " << curve->getLength() - 1 << " segments, tree built in " << buildTime * 1e3 << " ms, "
+              << QUERIES << " queries in " << queryTime * 1e3 << " ms (" << QUERIES / queryTime * 1e-6 << " M queries/s, p50), "
+              << "exhaustive search over " << curve->getDrawLength() << " samples " << exhaustiveTime * 1e6 << " us per query" << std::endl;
+    std::cout << (failed == 0 ? "[  INFO  ][Closest] " : "[ ERROR  ][Closest] ") << failed << " of " << CHECKED
+              << " checked queries farther than the nearest sample, on average " << improvement / CHECKED << " closer" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#include "Bench.hpp"
+#include <algorithm>
+#include <iostream>
+#include "Memory/ScratchArena.hpp"
+
+
+/**
+ * Loads options.file as a curve options.runs times, like a scene reload, and reports the load times,
+ * the scratch memory kept between loads and the peak resident memory of the process.<br>
+ * Files with only a header have to fail to load, alone and placed along a parent.
+ * @return 0 if every load succeeded and the empty files were rejected
+ */
+int benchmarkLoad( const BenchOptions &options )
+{
+    if (options.file.empty()) {
+        std::clog << "[ ERROR  ][Load   ] plotty-bench load needs a CSV file" << std::endl;
+        return 1;
+    }
+
+    MeshSpec spec;
+    spec.file = options.file;
+    spec.kind = MeshSpec::Kind::Curve;
+
+    using clock = std::chrono::steady_clock;
+    std::vector<f64> seconds;
+    for (u32 run = 0; run < options.runs; run++) {
+        Scene scene;
+        scene.add(spec);
+
+        const auto start = clock::now();
+        if (!scene.load())
+            return 1;
+        seconds.push_back(std::chrono::duration<f64>(clock::now() - start).count());
+    }
+
+    const f64 first = seconds.front();
+    const f64 slowest = *std::max_element(seconds.begin(), seconds.end());
+    std::cout << "[  INFO  ][Load   ] \"" << options.file << "\" " << options.runs << " loads, first " << first * 1e3 << " ms, p50 "
+              << median(seconds) * 1e3 << " ms, max " << slowest * 1e3 << " ms, scratch kept " << (ScratchArena::getCapacity() >> 10)
+              << " KiB, peak RSS " << (getPeakResidentMemory() >> 20) << " MiB" << std::endl;
+
+    const std::string header = "T,X,Y,Z\n";
+    const bool rejected = rejectsFile("plotty-empty.csv", header) && rejectsFile("plotty-empty.csv", header, "res/meshes/spiral.csv");
+    std::cout << (rejected ? "[  INFO  ][Load   ] " : "[ ERROR  ][Load   ] ") << "Files with only a header "
+              << (rejected ? "rejected" : "loaded") << std::endl;
+    return rejected ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include "Bench.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "IO/NumberParser.hpp"
+
+
+/**
+ * Parses the same generated cells with std::stof, std::from_chars and the NumberParser detected for their
+ * format, options.runs times, and reports the median time per cell and the cells where the results differ.<br>
+ * A file with a malformed cell has to fail to load, one without a Z column has to load with Z = 0.
+ * @return 0 if NumberParser agrees with std::from_chars on every cell and the files are treated as described
+ */
+int benchmarkParse( const BenchOptions &options )
+{
+    struct Format {
+        const char *printf;
+        f64 exponent; // values up to 10^exponent
+    };
+    constexpr Format FORMATS[] = {
+        { "%+.6f", 0.0 }, // like res/meshes
+        { "%.3f", 9.0 },  // more digits than f32 holds
+        { "%.7g", 30.0 }  // exponents, both tiny and huge values
+    };
+    constexpr u32 CELLS = 1 << 20;
+
+    const auto perCell = [&options]( const auto &parse ) { return measure(options.runs, parse) * 1e9 / CELLS; };
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f64> uniform(-1.0, 1.0);
+    bool agree = true;
+    for (const Format &format : FORMATS) {
+        std::string text;
+        std::vector<u64> starts;
+        for (u32 i = 0; i < CELLS; i++) {
+            const f64 value = uniform(random) * std::pow(10.0, format.exponent * uniform(random));
+            char cell[64];
+            starts.push_back(text.size());
+            text.append(cell, std::snprintf(cell, sizeof(cell), format.printf, value));
+        }
+        starts.push_back(text.size());
+
+        const char *const data = text.c_str();
+        const NumberParser::Parse parser = NumberParser::detect({ data, starts[1] });
+        std::vector<f32> stof(CELLS), fromChars(CELLS), parsed(CELLS);
+
+        const f64 stofTime = perCell([&] {
+            for (u32 i = 0; i < CELLS; i++)
+                stof[i] = std::stof(std::string(data + starts[i], data + starts[i + 1]));
+        });
+        const f64 fromCharsTime = perCell([&] {
+            for (u32 i = 0; i < CELLS; i++)
+                NumberParser::parseGeneral(data + starts[i], data + starts[i + 1], fromChars[i]);
+        });
+        const f64 parserTime = perCell([&] {
+            for (u32 i = 0; i < CELLS; i++)
+                parser(data + starts[i], data + starts[i + 1], parsed[i]);
+        });
+
+        u32 differ = 0;
+        for (u32 i = 0; i < CELLS; i++)
+            differ += (std::memcmp(&parsed[i], &fromChars[i], sizeof(f32)) != 0) | (std::memcmp(&stof[i], &fromChars[i], sizeof(f32)) != 0);
+        agree &= differ == 0;
+
+        std::cout << (differ == 0 ? "[  INFO  ][Parse  ] " : "[ ERROR  ][Parse  ] ") << format.printf << ": " << CELLS << " cells, stof "
+                  << stofTime << " ns, from_chars " << fromCharsTime << " ns, NumberParser ("
+                  << (parser == &NumberParser::parseGeneral ? "general" : "fixed") << ") " << parserTime << " ns per cell, "
+                  << differ << " differ" << std::endl;
+    }
+
+    const bool malformed = rejectsFile("plotty-malformed.csv", "T,X,Y,Z\n0,+1.000000,0,0\n1,+1.0x0000,0,0\n2,+1.000000,1,0\n3,+0.000000,1,0\n");
+    const bool missing = !rejectsFile("plotty-missing.csv", "T,X,Y\n0,+1.000000,0\n1,+1.000000,1\n2,+0.000000,1\n");
+    std::cout << (malformed ? "[  INFO  ][Parse  ] " : "[ ERROR  ][Parse  ] ") << "File with a malformed cell "
+              << (malformed ? "rejected" : "loaded") << std::endl;
+    std::cout << (missing ? "[  INFO  ][Parse  ] " : "[ ERROR  ][Parse  ] ") << "File without column Z "
+              << (missing ? "loaded" : "rejected") << std::endl;
+
+    return agree && malformed && missing ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include "Bench.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "IO/CSVReader.hpp"
+
+
+/**
+ * Places vertices at times along parent options.runs times, once per vertex through the virtual Mesh::transform
+ * and once through the parent's placeLocal(), and reports both times and how far they differ.
+ * @return true if both placements agree
+ */
+static bool comparePlacement( const BenchOptions &options, const std::string &name, const Mesh &parent,
+                              const std::vector<f32> &times, const std::vector<f32> &local )
+{
+    const u32 rows = static_cast<u32>(times.size());
+    std::vector<f32> virtualPlaced, staticPlaced;
+    const f64 virtualTime = measure(options.runs, [&] {
+        virtualPlaced = local;
+        parent.Mesh::placeLocal(times.data(), virtualPlaced.data(), rows, 4);
+    });
+    const f64 staticTime = measure(options.runs, [&] {
+        staticPlaced = local;
+        parent.placeLocal(times.data(), staticPlaced.data(), rows, 4);
+    });
+
+    f32 difference = 0.0f;
+    for (u64 k = 0; k < local.size(); k++)
+        difference = std::max(difference, std::abs(virtualPlaced[k] - staticPlaced[k]));
+    const bool ok = difference <= 1e-5f;
+
+    std::cout << (ok ? "[  INFO  ][Place  ] " : "[ ERROR  ][Place  ] ") << name << ": " << rows << " vertices, virtual transform "
+              << virtualTime * 1e3 << " ms, placeLocal " << staticTime * 1e3 << " ms (" << virtualTime / staticTime
+              << "x), largest difference " << difference << std::endl;
+    return ok;
+}
+
+
+/**
+ * Builds the demo chain circle -> spiral -> tbnSpiral options.runs times and reports the load times.
+ * Then compares the placement of the children along their parents, and of 2^20 vertices along the circle,
+ * thousands per spline segment, see comparePlacement().
+ * @return 0 if all placements agree
+ */
+int benchmarkPlace( const BenchOptions &options )
+{
+    constexpr u32 DENSE = 1 << 20;
+
+    Scene scene;
+    if (!buildDemoChain(scene))
+        return 1;
+    bool loaded = true;
+    const f64 loadTime = measure(options.runs, [&] { loaded &= scene.load(); });
+    if (!loaded)
+        return 1;
+    std::cout << "[  INFO  ][Place  ] chain of " << scene.getMeshCount() << " meshes loaded in " << loadTime * 1e3 << " ms (p50)" << std::endl;
+
+    bool agree = true;
+    for (u32 i = 0; i < scene.getMeshCount(); i++) {
+        const MeshSpec &spec = scene.getSpec(i);
+        if (spec.parent == NO_PARENT)
+            continue;
+
+        // Times and local coordinates as the child constructor reads them
+        CSVFile csv(spec.file);
+        if (!csv.read())
+            return 1;
+        const auto *Tcol = csv.getValues(spec.T.first);
+        const auto *Xcol = csv.getValues(spec.X.first);
+        const auto *Ycol = csv.getValues(spec.Y.first);
+        const auto *Zcol = csv.getValues(spec.Z.first);
+        const u32 rows = csv.getRowCount();
+        std::vector<f32> times(rows), local(4 * static_cast<size_t>(rows));
+        for (u32 r = 0; r < rows; r++) {
+            times[r] = Tcol ? (*Tcol)[r] : spec.T.second * r;
+            local[4 * r + 0] = Xcol ? (*Xcol)[r] : spec.X.second;
+            local[4 * r + 1] = Ycol ? (*Ycol)[r] : spec.Y.second;
+            local[4 * r + 2] = Zcol ? (*Zcol)[r] : spec.Z.second;
+        }
+
+        const std::string name = '"' + spec.file + "\" along mesh " + std::to_string(spec.parent);
+        agree &= comparePlacement(options, name, *scene.getMesh(spec.parent), times, local);
+    }
+
+    // Once around the circle, each vertex 0.1 off in every direction of its frame
+    const auto circle = scene.getMesh(0);
+    std::vector<f32> times(DENSE), local(4 * static_cast<size_t>(DENSE), 0.1f);
+    for (u32 r = 0; r < DENSE; r++)
+        times[r] = static_cast<f32>(r) / DENSE;
+    agree &= comparePlacement(options, "dense along mesh 0", *circle, times, local);
+
+    return agree ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include "Bench.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "IO/RingProducer.hpp"
+
+
+/**
+ * Producer and reader of one SharedRing on two threads, both as fast as they can, for options.duration seconds.
+ * Reports their rates and checks that every row the reader considers intact is the one written.
+ * @return 0 if no intact row was torn
+ */
+int benchmarkStream( const BenchOptions &options )
+{
+    using clock = std::chrono::steady_clock;
+    constexpr u64 BATCH = 4096;
+    constexpr u64 CAPACITY = 1 << 20;
+    const std::string name = "plotty-bench-" + std::to_string(clock::now().time_since_epoch().count());
+
+    RingProducer producer(name, { "T", "X", "Y", "Z" }, CAPACITY);
+    if (!producer.isValid())
+        return 1;
+    const SharedRing ring(name);
+    if (!ring.isValid())
+        return 1;
+
+    std::atomic<bool> running(true);
+    std::thread produce([&] {
+        // T is the row index modulo 2^24, exact in a f32
+        std::vector<f32> rows(4 * BATCH);
+        while (running) {
+            const u64 first = producer.getWritten();
+            for (u64 i = 0; i < BATCH; i++)
+                rows[4 * i] = static_cast<f32>((first + i) & 0xFFFFFF);
+            producer.append(rows.data(), BATCH);
+        }
+    });
+
+    // Copied like an upload, then checked against T once known to be intact
+    std::vector<f32> copy(4 * CAPACITY);
+    u64 next = 0;
+    u64 read = 0;
+    u64 torn = 0;
+    const auto start = clock::now();
+    while (clock::now() - start < std::chrono::duration<f64>(options.duration)) {
+        u64 first = ~0ull;
+        const RowRange intact = ring.read(next, [&]( const u64 row, const f32 *rows, const u64 count ) {
+            first = std::min(first, row);
+            std::memcpy(copy.data() + 4 * (row - first), rows, count * 4 * sizeof(f32));
+        });
+        for (u64 row = std::max(intact.begin, first); row < intact.end; row++)
+            torn += copy[4 * (row - first)] != static_cast<f32>(row & 0xFFFFFF);
+        read += intact.end - std::min(intact.end, std::max(intact.begin, first));
+    }
+    running = false;
+    produce.join();
+    const f64 seconds = std::chrono::duration<f64>(clock::now() - start).count();
+
+    std::cout << (torn == 0 ? "[  INFO  ][Stream ] " : "[ ERROR  ][Stream ] ") << "produced " << producer.getWritten() / seconds / 1e6
+              << " M rows/s, read " << read / seconds / 1e6 << " M rows/s intact, " << torn << " torn rows, "
+              << producer.getWritten() - read << " rows overwritten before they were read" << std::endl;
+    return torn == 0 ? 0 : 1;
+}
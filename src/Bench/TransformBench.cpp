@@ -0,0 +1,86 @@
+#include "Bench.hpp"
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <glm/glm.hpp>
+#include "3D/CoordinateSystem.hpp"
+
+
+struct KnownPoint {
+    CoordinateSystem system;
+    glm::fvec3 source;
+    glm::fvec3 cartesian;
+};
+
+// Axes and signs each transform has to get right, radians as in CoordinateSystem
+static constexpr f32 QUARTER = std::numbers::pi_v<f32> * 0.5f;
+static const KnownPoint KNOWN[] = {
+    { CoordinateSystem::Cartesian, { 1.0f, -2.0f, 3.0f }, { 1.0f, -2.0f, 3.0f } },
+    { CoordinateSystem::Spherical, { 2.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f } },
+    { CoordinateSystem::Spherical, { 2.0f, 0.0f, QUARTER }, { 0.0f, 2.0f, 0.0f } },
+    { CoordinateSystem::Spherical, { 2.0f, QUARTER, 0.0f }, { 0.0f, 0.0f, 2.0f } },
+    { CoordinateSystem::Cylindrical, { 2.0f, QUARTER, -3.0f }, { 0.0f, 2.0f, -3.0f } },
+    { CoordinateSystem::Polar, { 2.0f, -QUARTER, 5.0f }, { 0.0f, -2.0f, 0.0f } },
+    { CoordinateSystem::Logarithmic, { 9.0f, -99.0f, 0.0f }, { 1.0f, -2.0f, 0.0f } }
+};
+
+
+/**
+ * Converts 2^20 random points with every coordinate transform through the parallel CoordinateTransforms::toCartesian,
+ * options.runs times, and reports the points per second, copy of the input included. Checks the results against the serial kernel, that the fourth
+ * component of each vertex is left alone, a few points with known results, and that find() and the generated GLSL
+ * cover every transform. The GLSL itself is compared on the GPU by plotty-check transforms.
+ * @return 0 if all checks pass
+ */
+int benchmarkTransforms( const BenchOptions &options )
+{
+    constexpr u64 COUNT = 1 << 20;
+    constexpr u32 STRIDE = 4;
+
+    // Radii and values of both signs, angles beyond one turn
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> uniform(-10.0f, 10.0f);
+    std::vector<f32> points(STRIDE * COUNT);
+    for (f32 &v : points)
+        v = uniform(random);
+
+    const std::string glsl = CoordinateTransforms::generateGLSL();
+    bool ok = true;
+    for (const CoordinateTransform &transform : CoordinateTransforms::getAll()) {
+        std::vector<f32> serial = points;
+        transform.toCartesian(serial.data(), COUNT, STRIDE);
+
+        std::vector<f32> parallel;
+        const f64 seconds = measure(options.runs, [&] {
+            parallel = points;
+            CoordinateTransforms::toCartesian(transform.system, parallel.data(), COUNT, STRIDE);
+        });
+
+        u64 differing = 0;
+        for (u64 i = 0; i < parallel.size(); i++) {
+            const f32 expected = (i % STRIDE == 3) ? points[i] : serial[i];
+            differing += parallel[i] != expected;
+        }
+
+        u64 wrong = 0;
+        for (const KnownPoint &known : KNOWN) {
+            if (known.system != transform.system)
+                continue;
+            glm::fvec3 p = known.source;
+            transform.toCartesian(&p.x, 1, 3);
+            wrong += glm::length(p - known.cartesian) > 1e-5f;
+        }
+
+        const bool found = CoordinateTransforms::find(transform.name) == &transform;
+        const bool generated = glsl.find(std::string("return ") + transform.glsl + ";") != std::string::npos;
+        const bool passed = differing == 0 && wrong == 0 && found && generated;
+        ok &= passed;
+        std::cout << (passed ? "[  INFO  ][Check  ] " : "[ ERROR  ][Check  ] ") << transform.name << ": " << COUNT / seconds * 1e-6
+                  << " M points/s (p50), " << differing << " values differ from the serial kernel, " << wrong << " known points wrong"
+                  << (found ? "" : ", not found by name") << (generated ? "" : ", missing in the GLSL") << std::endl;
+    }
+
+    ok &= CoordinateTransforms::find("none") == nullptr;
+    return ok ? 0 : 1;
+}
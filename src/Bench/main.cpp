@@ -0,0 +1,81 @@
+#include <cstring>
+#include <iostream>
+#include "Bench.hpp"
+
+
+struct Benchmark {
+    const char *name;
+    int (*run)( const BenchOptions &options );
+};
+
+// Each is registered as test of the same name, see CMakeLists.txt
+constexpr Benchmark BENCHMARKS[] = {
+    { "closest", &benchmarkClosest },
+    { "load", &benchmarkLoad },
+    { "parse", &benchmarkParse },
+    { "place", &benchmarkPlace },
+    { "stream", &benchmarkStream },
+    { "transforms", &benchmarkTransforms },
+};
+
+
+static bool parseOptions( const int argc, char **argv, BenchOptions &options )
+{
+    for (int i = 2; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (arg[0] != '-' && options.file.empty()) {
+            options.file = arg;
+            continue;
+        }
+        if (!value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        i++;
+
+        try {
+            if (std::strcmp(arg, "--runs") == 0) {
+                options.runs = static_cast<u32>(std::max(std::stoul(value), 1ul));
+            }
+            else if (std::strcmp(arg, "--duration") == 0) {
+                options.duration = std::stod(value);
+            }
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &) {
+            std::cerr << "No number for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Benchmarks and checks of the parts that need no window or GL context, run from the project directory.<br>
+ * Reports its measurements and returns 0 if the checks of benchmark NAME passed.
+ */
+int main( int argc, char **argv )
+{
+    BenchOptions options;
+    const Benchmark *benchmark = nullptr;
+    for (const Benchmark &candidate : BENCHMARKS) {
+        if (argc > 1 && std::strcmp(argv[1], candidate.name) == 0)
+            benchmark = &candidate;
+    }
+
+    if (!benchmark || !parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " NAME [--runs N] [--duration S] [FILE], NAME one of";
+        for (const Benchmark &candidate : BENCHMARKS)
+            std::cerr << ' ' << candidate.name;
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    return benchmark->run(options);
+}
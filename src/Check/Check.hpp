@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include "defines.hpp"
+
+
+/**
+ * Command line of plotty-check, <code>NAME [FILE]</code>.
+ */
+struct CheckOptions {
+    std::string file; // input of the checks reading one
+};
+
+
+// Every check runs on the current headless context and returns 0 if it passed, see their sources
+
+int checkDensity( const CheckOptions &options );
+
+int checkPacing( const CheckOptions &options );
+
+int checkTransforms( const CheckOptions &options );
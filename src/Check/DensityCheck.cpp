@@ -0,0 +1,111 @@
+#include <glad.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Check.hpp"
+#include "3D/OrbitCamera.hpp"
+#include "3D/Scene.hpp"
+#include "Rendering/Framebuffer.hpp"
+#include "Rendering/SceneView.hpp"
+
+
+// Size of the compared frames and points of the cloud generated without FILE
+constexpr int WIDTH = 640;
+constexpr int HEIGHT = 480;
+constexpr u32 POINTS = 1 << 18;
+
+
+/**
+ * Writes POINTS normally distributed points with columns X, Y and Z to filename.
+ */
+static bool writeCloud( const std::string &filename )
+{
+    std::ofstream file(filename);
+    std::mt19937 random(42);
+    std::normal_distribution<f32> normal(0.0f, 0.5f);
+    file << "X,Y,Z\n";
+    for (u32 i = 0; i < POINTS; i++)
+        file << normal(random) << ',' << normal(random) << ',' << normal(random) << '\n';
+    return file.good();
+}
+
+
+/**
+ * Renders the point cloud options.file, or a generated one, once splatted on the GPU and once binned on the CPU,
+ * and fails if more than one point in a thousand landed on another pixel.
+ */
+int checkDensity( const CheckOptions &options )
+{
+    std::string filename = options.file;
+    if (filename.empty()) {
+        filename = (std::filesystem::temp_directory_path() / "plotty-check-density.csv").string();
+        if (!writeCloud(filename)) {
+            std::clog << "[ ERROR  ][Check  ] Cannot write \"" << filename << '"' << std::endl;
+            return 1;
+        }
+    }
+
+    Scene scene;
+    MeshSpec cloud;
+    cloud.file = filename;
+    cloud.mode = GL_POINTS;
+    cloud.density = true;
+    scene.add(cloud);
+    const bool loaded = scene.load();
+    if (options.file.empty())
+        std::filesystem::remove(filename);
+    if (!loaded)
+        return 1;
+
+    SceneView view(scene);
+    Framebuffer framebuffer(WIDTH, HEIGHT);
+
+    const auto w = static_cast<f32>(WIDTH);
+    const auto h = static_cast<f32>(HEIGHT);
+    const FrameData frame{ OrbitCamera(0.0).getViewProjection(WIDTH, HEIGHT), { w, h, 1.0f / w, 1.0f / h }, 0.0f };
+    Profiler profiler(2);
+    std::vector<f32> counts[2];
+    std::vector<u8> images[2];
+    f64 seconds[2];
+
+    using clock = std::chrono::steady_clock;
+    for (int cpu = 0; cpu < 2; cpu++) {
+        view.setCpuBinning(cpu == 1);
+        const auto start = clock::now();
+        profiler.beginFrame();
+        framebuffer.bind();
+        view.render(frame, profiler);
+        framebuffer.resolve();
+        profiler.endFrame();
+        glFinish();
+        seconds[cpu] = std::chrono::duration<f64>(clock::now() - start).count();
+
+        view.getDensityRenderer().readCounts(counts[cpu]);
+        images[cpu].resize(static_cast<size_t>(WIDTH) * HEIGHT * 4);
+        glGetTextureImage(framebuffer.getColorTexture(), 0, GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(images[cpu].size()), images[cpu].data());
+    }
+
+    // A point moved to a neighbouring pixel changes two counts by one
+    f64 points = 0.0;
+    f64 moved = 0.0;
+    for (size_t i = 0; i < counts[0].size(); i++) {
+        points += counts[1][i];
+        moved += std::abs(counts[0][i] - counts[1][i]) * 0.5;
+    }
+
+    u64 differing = 0;
+    for (size_t i = 0; i < images[0].size(); i += 4)
+        differing += std::memcmp(&images[0][i], &images[1][i], 4) != 0;
+
+    const bool ok = points > 0.0 && moved <= 1e-3 * points;
+    std::cout << (ok ? "[  INFO  ][Check  ] " : "[ ERROR  ][Check  ] ") << "density: " << points << " points in view, "
+              << moved << " binned to another pixel on the CPU, " << differing << " of " << WIDTH * HEIGHT
+              << " pixels differ; frame with GPU splatting " << seconds[0] * 1e3 << " ms, CPU binning " << seconds[1] * 1e3 << " ms" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include <glad.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "Check.hpp"
+#include "3D/OrbitCamera.hpp"
+#include "3D/Scene.hpp"
+#include "Rendering/Framebuffer.hpp"
+#include "Rendering/Profiler.hpp"
+#include "Rendering/SceneView.hpp"
+#include "Threading/TripleBuffer.hpp"
+
+
+// Size of the rendered frames, small enough for software rasterizers to stay within one vsync
+constexpr int WIDTH = 320;
+constexpr int HEIGHT = 240;
+constexpr u32 FRAMES = 300;
+
+// Simulated vsync and update thread of the app
+constexpr f64 PERIOD = 1.0 / 60.0;
+constexpr f64 UPDATE_RATE = 240.0;
+constexpr f64 ORBIT_SPEED = 0.125;
+
+// Heavy data updates, the update thread blocks STALL seconds every STALL_INTERVAL
+constexpr f64 STALL = 0.05;
+constexpr f64 STALL_INTERVAL = 0.5;
+
+
+struct PacingSnapshot {
+    f64 time;
+    FrameData frame;
+};
+
+
+static f64 now()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration<f64>(steady_clock::now() - start).count();
+}
+
+static void sleepUntil( const f64 time )
+{
+    std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::duration<f64>(time - now()));
+}
+
+/**
+ * Orbits the camera UPDATE_RATE times a second like the update thread of the app, stalling periodically.
+ */
+static void updateLoop( const std::atomic<bool> &running, TripleBuffer<PacingSnapshot> &snapshots )
+{
+    OrbitCamera camera;
+    f64 lastTick = now();
+    f64 nextTick = lastTick;
+    f64 nextStall = lastTick + STALL_INTERVAL;
+
+    const auto w = static_cast<f32>(WIDTH);
+    const auto h = static_cast<f32>(HEIGHT);
+    while (running) {
+        const f64 time = now();
+        camera.rotate((time - lastTick) * ORBIT_SPEED, 0.0);
+        lastTick = time;
+
+        snapshots.getWriteBuffer() = { time, { camera.getViewProjection(WIDTH, HEIGHT), { w, h, 1.0f / w, 1.0f / h }, static_cast<f32>(time) } };
+        snapshots.publish();
+
+        if (time >= nextStall) {
+            std::this_thread::sleep_for(std::chrono::duration<f64>(STALL));
+            nextStall += STALL_INTERVAL;
+        }
+
+        // Skip ticks instead of catching up after a stall
+        nextTick = std::max(nextTick + 1.0 / UPDATE_RATE, now());
+        sleepUntil(nextTick);
+    }
+}
+
+
+/**
+ * Renders the demo chain FRAMES times against a simulated 60 Hz vsync while the update thread stalls
+ * STALL seconds every STALL_INTERVAL, and reports how evenly frames were presented.<br>
+ * Every missed vsync is attributed to where the time of its frame went: waiting for the snapshot of the update
+ * thread (blocked), rendering longer than a period (slow, e.g. on a software rasterizer at a large size), or
+ * neither, so the thread woke up too late for a frame ready in time (overslept, e.g. on a busy host).
+ * @return 0 if no frame was blocked and the snapshots aged by a stall in between, so rendering went on during stalls
+ */
+int checkPacing( const CheckOptions & )
+{
+    Scene scene;
+    MeshSpec circle;
+    circle.file = "res/meshes/geodesicSphere.csv";
+    circle.kind = MeshSpec::Kind::Curve;
+    circle.cyclic = true;
+    MeshSpec spiral;
+    spiral.file = "res/meshes/spiral.csv";
+    spiral.kind = MeshSpec::Kind::Curve;
+    spiral.parent = static_cast<i32>(scene.add(circle));
+    spiral.cyclic = true;
+    MeshSpec tbnSpiral;
+    tbnSpiral.file = "res/meshes/ONF.csv";
+    tbnSpiral.parent = static_cast<i32>(scene.add(spiral));
+    tbnSpiral.mode = GL_LINES;
+    scene.add(tbnSpiral);
+    if (!scene.load())
+        return 1;
+
+    SceneView view(scene);
+    Framebuffer framebuffer(WIDTH, HEIGHT);
+    Profiler profiler(FRAMES);
+
+    std::atomic<bool> running(true);
+    TripleBuffer<PacingSnapshot> snapshots;
+    std::thread update(updateLoop, std::cref(running), std::ref(snapshots));
+    while (!snapshots.fetch())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::vector<f64> jitter;
+    std::vector<f64> age;
+    u32 blocked = 0;
+    u32 slow = 0;
+    u32 overslept = 0;
+    f64 deadline = now();
+    f64 lastPresent = -1.0;
+
+    for (u32 f = 0; f < FRAMES; f++) {
+        const f64 start = now();
+        snapshots.fetch();
+        const PacingSnapshot &snapshot = snapshots.getReadBuffer();
+        const f64 fetched = now();
+
+        profiler.beginFrame();
+        framebuffer.bind();
+        view.render(snapshot.frame, profiler);
+        framebuffer.resolve();
+        glFinish(); // stands in for the swap
+        profiler.endFrame();
+        const f64 rendered = now();
+
+        // Present at the next vsync, or immediately if it was missed
+        deadline += PERIOD;
+        if (now() > deadline)
+            deadline = now();
+        sleepUntil(deadline);
+
+        const f64 present = now();
+        if (lastPresent >= 0.0) {
+            const f64 interval = present - lastPresent;
+            jitter.push_back(std::abs(interval - PERIOD));
+            if (interval > 1.5 * PERIOD && rendered - fetched > PERIOD)
+                slow++;
+            else if (interval > 1.5 * PERIOD && rendered - start > PERIOD)
+                blocked++;
+            else if (interval > 1.5 * PERIOD)
+                overslept++;
+        }
+        age.push_back(present - snapshot.time);
+        lastPresent = present;
+    }
+
+    running = false;
+    update.join();
+
+    const ProfileStatistics frameTime = profiler.getFrameStatistics();
+    const ProfileStatistics jitterTime = Profiler::computeStatistics(jitter);
+    const ProfileStatistics ageTime = Profiler::computeStatistics(age);
+
+    // The snapshots have to age by about a stall, otherwise the stalls were not overlapped with rendering
+    const bool ok = blocked == 0 && ageTime.max >= 0.8 * STALL;
+    const char *tag = ok ? "[  INFO  ][Pacing ] " : "[ ERROR  ][Pacing ] ";
+    std::cout << tag << FRAMES << " frames of " << WIDTH << 'x' << HEIGHT << " at 60 Hz, update stalls " << STALL * 1e3
+              << " ms every " << STALL_INTERVAL * 1e3 << " ms" << std::endl;
+    std::cout << tag << "render p50 " << frameTime.p50 * 1e3 << " ms, p95 " << frameTime.p95 * 1e3 << " ms" << std::endl;
+    std::cout << tag << "jitter p50 " << jitterTime.p50 * 1e3 << " ms, p95 " << jitterTime.p95 * 1e3 << " ms, p99 "
+              << jitterTime.p99 * 1e3 << " ms, max " << jitterTime.max * 1e3 << " ms" << std::endl;
+    std::cout << tag << "snapshot age p50 " << ageTime.p50 * 1e3 << " ms, max " << ageTime.max * 1e3 << " ms" << std::endl;
+    std::cout << tag << "missed vsyncs: " << blocked << " blocked by the update thread, " << slow << " rendering longer than a period, "
+              << overslept << " overslept" << std::endl;
+    return ok ? 0 : 1;
+}
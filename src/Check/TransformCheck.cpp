@@ -0,0 +1,66 @@
+#include <glad.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Check.hpp"
+#include "3D/CoordinateSystem.hpp"
+#include "Rendering/Shader.hpp"
+
+
+/**
+ * Converts the same random points with the CPU kernel and the generated GLSL of every
+ * coordinate transform and reports the largest difference.
+ * @return 0 if all transforms agree
+ */
+int checkTransforms( const CheckOptions & )
+{
+    Shader::defineInclude("transforms.glsl", CoordinateTransforms::generateGLSL());
+    Shader shader("./res/shader/transformCheck", false);
+    if (!shader.Load())
+        return 1;
+
+    // Radii and values of both signs, angles beyond one turn
+    constexpr u32 COUNT = 1 << 16;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> uniform(-10.0f, 10.0f);
+    std::vector<f32> points(4 * COUNT);
+    for (f32 &v : points)
+        v = uniform(random);
+
+    GLuint buffers[2];
+    glCreateBuffers(2, buffers);
+    glNamedBufferStorage(buffers[0], points.size() * sizeof(f32), points.data(), 0);
+    glNamedBufferStorage(buffers[1], points.size() * sizeof(f32), nullptr, GL_MAP_READ_BIT);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffers[0]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffers[1]);
+    shader.Bind();
+    const Uniform<u32> system = shader.getUniform<u32>("system");
+
+    bool agree = true;
+    for (const CoordinateTransform &transform : CoordinateTransforms::getAll()) {
+        shader.set(system, static_cast<u32>(transform.system));
+        glDispatchCompute(COUNT / 64, 1, 1);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        std::vector<f32> gpu(points.size());
+        glGetNamedBufferSubData(buffers[1], 0, static_cast<GLsizeiptr>(gpu.size() * sizeof(f32)), gpu.data());
+
+        std::vector<f32> cpu = points;
+        CoordinateTransforms::toCartesian(transform.system, cpu.data(), COUNT, 4);
+
+        // Relative to the magnitude, GPUs evaluate sin, cos and log with less precision
+        f32 maxError = 0.0f;
+        for (u64 i = 0; i < cpu.size(); i++)
+            maxError = std::max(maxError, std::abs(gpu[i] - cpu[i]) / (1.0f + std::abs(cpu[i])));
+
+        const bool ok = maxError <= 1e-4f;
+        agree &= ok;
+        std::cout << (ok ? "[  INFO  ][Check  ] " : "[ ERROR  ][Check  ] ") << transform.name << ": " << COUNT
+                  << " points, max relative difference CPU/GPU " << maxError << std::endl;
+    }
+
+    glDeleteBuffers(2, buffers);
+    return agree ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include <glad.h>
+
+#include <cstring>
+#include <iostream>
+#include "Check.hpp"
+#include "GUI/HeadlessContext.hpp"
+#include "Rendering/Shader.hpp"
+
+
+struct Check {
+    const char *name;
+    int (*run)( const CheckOptions &options );
+};
+
+// Each is registered as test check-NAME, see CMakeLists.txt
+constexpr Check CHECKS[] = {
+    { "density", &checkDensity },
+    { "pacing", &checkPacing },
+    { "transforms", &checkTransforms },
+};
+
+
+/**
+ * Checks that the GPU paths of the renderer agree with their CPU counterparts and that frames are paced evenly,
+ * on a headless context and run from the project directory.<br>
+ * Reports the differences and returns 0 if check NAME passed.
+ */
+int main( int argc, char **argv )
+{
+    const Check *check = nullptr;
+    for (const Check &candidate : CHECKS) {
+        if (argc > 1 && std::strcmp(argv[1], candidate.name) == 0)
+            check = &candidate;
+    }
+
+    if (!check || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " NAME [FILE], NAME one of";
+        for (const Check &candidate : CHECKS)
+            std::cerr << ' ' << candidate.name;
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    CheckOptions options;
+    if (argc > 2)
+        options.file = argv[2];
+
+    const HeadlessContext context;
+    if (!context.isValid()) {
+        std::cerr << "Could not create a headless OpenGL context: " << context.getError() << std::endl;
+        return 1;
+    }
+    gladLoadGL(HeadlessContext::getProcAddress);
+    Shader::enableParallelCompile();
+
+    return check->run(options);
+}
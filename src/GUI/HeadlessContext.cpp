@@ -0,0 +1,132 @@
+#include "HeadlessContext.hpp"
+#include <cstring>
+
+#ifdef PLOTTY_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+
+#ifdef PLOTTY_HAS_EGL
+
+static bool hasExtension( const char *extensions, const char *name )
+{
+    if (nullptr == extensions)
+        return false;
+
+    const size_t length = std::strlen(name);
+    for (const char *it = std::strstr(extensions, name); it; it = std::strstr(it + length, name)) {
+        if ((it == extensions || it[-1] == ' ') && (it[length] == ' ' || it[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+static EGLDisplay getSurfacelessDisplay()
+{
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay)
+            return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+
+    // e.g. vendor drivers exposing a device display without a window system
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+#endif
+
+
+HeadlessContext::HeadlessContext( const int gl_major, const int gl_minor )
+    : m_display(nullptr)
+    , m_context(nullptr)
+{
+#ifdef PLOTTY_HAS_EGL
+    EGLDisplay display = getSurfacelessDisplay();
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        m_error = "No EGL display available";
+        return;
+    }
+    m_display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        m_error = "EGL implementation does not support desktop OpenGL";
+        return;
+    }
+
+    const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!hasExtension(extensions, "EGL_KHR_surfaceless_context")) {
+        m_error = "EGL_KHR_surfaceless_context is not supported";
+        return;
+    }
+
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    if (!hasExtension(extensions, "EGL_KHR_no_config_context")) {
+        const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLint count = 0;
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &count) || count == 0) {
+            m_error = "No EGL config for desktop OpenGL";
+            return;
+        }
+    }
+
+    // Software rasterizers often stop below the requested version, 4.5 is required for direct state access
+    const int versions[][2] = { { gl_major, gl_minor }, { 4, 5 } };
+    for (const auto &[versionMajor, versionMinor] : versions) {
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, versionMajor,
+            EGL_CONTEXT_MINOR_VERSION, versionMinor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+
+        if (EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes); context != EGL_NO_CONTEXT) {
+            m_context = context;
+            break;
+        }
+    }
+
+    if (nullptr == m_context) {
+        m_error = "Cannot create an OpenGL 4.5+ core context";
+        return;
+    }
+
+    makeCurrent();
+#else
+    (void) gl_major;
+    (void) gl_minor;
+    m_error = "Plotty was built without EGL, headless rendering is not available";
+#endif
+}
+
+HeadlessContext::~HeadlessContext()
+{
+#ifdef PLOTTY_HAS_EGL
+    if (m_display) {
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_context)
+            eglDestroyContext(m_display, m_context);
+        eglTerminate(m_display);
+    }
+#endif
+}
+
+void HeadlessContext::makeCurrent() const noexcept
+{
+#ifdef PLOTTY_HAS_EGL
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context);
+#endif
+}
+
+HeadlessContext::Proc HeadlessContext::getProcAddress( const char *name )
+{
+#ifdef PLOTTY_HAS_EGL
+    return eglGetProcAddress(name);
+#else
+    (void) name;
+    return nullptr;
+#endif
+}
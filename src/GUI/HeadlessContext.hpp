@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+
+/**
+ * An OpenGL core context without any window or display server (EGL surfaceless, e.g. Mesa llvmpipe).<br>
+ * Rendering has to target framebuffer objects, there is no default framebuffer.
+ */
+class HeadlessContext {
+public:
+    explicit HeadlessContext( int gl_major = 4, int gl_minor = 6 );
+
+    HeadlessContext( const HeadlessContext & ) = delete;
+
+    ~HeadlessContext();
+
+    void makeCurrent() const noexcept;
+
+    constexpr bool isValid() const noexcept { return m_context != nullptr; }
+
+    const std::string &getError() const noexcept { return m_error; }
+
+    using Proc = void (*)();
+
+    /**
+     * Loader for glad, valid after a context was created.
+     */
+    static Proc getProcAddress( const char *name );
+
+private:
+    void *m_display;
+    void *m_context;
+    std::string m_error;
+};
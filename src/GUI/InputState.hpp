@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+#include <GLFW/glfw3.h>
+#include "defines.hpp"
+
+
+/**
+ * Everything the window received so far, as seen by the input thread.<br>
+ * Presses are counted instead of flagged, so a consumer which skips states
+ * still notices every press by comparing with the counts it saw last.
+ */
+struct InputState {
+    int width{ 0 };  // framebuffer size in pixels
+    int height{ 0 };
+    f64 cursorX{ 0.0 };
+    f64 cursorY{ 0.0 };
+    f64 scroll{ 0.0 }; // accumulated vertical scroll offset
+    std::array<bool, 3> buttons{ };  // left, right, middle
+    std::array<u32, GLFW_KEY_LAST + 1> keyPresses{ };
+};
@@ -0,0 +1,106 @@
+#include "ProfilerOverlay.hpp"
+#include <imgui.h>
+#include <backends/imgui_impl_opengl3.h>
+
+
+ProfilerOverlay::ProfilerOverlay( Profiler &profiler, std::string traceFile )
+    : m_profiler(profiler)
+    , m_traceFile(std::move(traceFile))
+    , m_visible(true)
+    , m_togglePresses(0)
+    , m_lastTime(-1.0)
+{
+    ImGui::CreateContext();
+    ImGuiIO &io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.BackendPlatformName = "plotty";
+    ImGui::StyleColorsDark();
+
+    ImGui_ImplOpenGL3_Init("#version 420");
+}
+
+ProfilerOverlay::~ProfilerOverlay()
+{
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui::DestroyContext();
+}
+
+void ProfilerOverlay::render( const InputState &input, const f64 time )
+{
+    ImGuiIO &io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(static_cast<float>(input.width), static_cast<float>(input.height));
+    io.DeltaTime = (m_lastTime < 0.0 || time <= m_lastTime) ? 1.0f / 60.0f : static_cast<float>(time - m_lastTime);
+    m_lastTime = time;
+
+    io.AddMousePosEvent(static_cast<float>(input.cursorX), static_cast<float>(input.cursorY));
+    io.AddMouseButtonEvent(0, input.buttons[0]);
+    io.AddMouseButtonEvent(1, input.buttons[1]);
+    io.AddMouseButtonEvent(2, input.buttons[2]);
+
+    // An odd number of presses since the last frame flips the visibility
+    const u32 presses = input.keyPresses[GLFW_KEY_F3];
+    if ((presses - m_togglePresses) % 2 == 1)
+        m_visible = !m_visible;
+    m_togglePresses = presses;
+
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+
+    if (m_visible)
+        drawWindow();
+
+    ImGui::Render();
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
+void ProfilerOverlay::drawWindow()
+{
+    ImGui::SetNextWindowPos(ImVec2(8.0f, 8.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.75f);
+    if (!ImGui::Begin("Profiler", &m_visible, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+        ImGui::End();
+        return;
+    }
+
+    const ProfileStatistics frame = m_profiler.getFrameStatistics();
+    ImGui::Text("Frame  %6.2f ms  (%5.1f fps)", frame.mean * 1e3, frame.mean > 0.0 ? 1.0 / frame.mean : 0.0);
+    ImGui::Text("p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f ms", frame.p50 * 1e3, frame.p95 * 1e3, frame.p99 * 1e3, frame.max * 1e3);
+
+    m_frameTimes.clear();
+    for (const ProfileFrame *profileFrame : m_profiler.getFrames())
+        m_frameTimes.push_back(static_cast<float>(profileFrame->duration * 1e3));
+    ImGui::PlotLines("##frametimes", m_frameTimes.data(), static_cast<int>(m_frameTimes.size()), 0, "frame time [ms]",
+                     0.0f, static_cast<float>(frame.p99 * 2e3), ImVec2(360.0f, 64.0f));
+
+    ImGui::Separator();
+    if (ImGui::BeginTable("scopes", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Unit");
+        ImGui::TableSetupColumn("mean [ms]");
+        ImGui::TableSetupColumn("p95 [ms]");
+        ImGui::TableSetupColumn("p99 [ms]");
+        ImGui::TableHeadersRow();
+
+        for (const ScopeStatistics &scope : m_profiler.getScopeStatistics()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(scope.name);
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(scope.gpu ? "GPU" : "CPU");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.time.mean * 1e3);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.time.p95 * 1e3);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.time.p99 * 1e3);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export trace"))
+        m_profiler.exportChromeTrace(m_traceFile);
+    ImGui::SameLine();
+    ImGui::TextUnformatted(m_traceFile.c_str());
+
+    ImGui::End();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Rendering/Profiler.hpp"
+#include "GUI/InputState.hpp"
+
+
+/**
+ * ImGui window showing frame-time percentiles, a frame-time plot and
+ * per-scope CPU/GPU timings of a Profiler. F3 toggles it.<br>
+ * Input is fed from an InputState instead of GLFW callbacks, so the overlay
+ * can be drawn on a render thread other than the one receiving events.
+ */
+class ProfilerOverlay {
+public:
+    explicit ProfilerOverlay( Profiler &profiler, std::string traceFile = "plotty-trace.json" );
+
+    ProfilerOverlay( const ProfilerOverlay & ) = delete;
+
+    ~ProfilerOverlay();
+
+    /**
+     * @param input window input, the framebuffer size of it is the display size
+     * @param time seconds, for ImGui's frame delta
+     */
+    void render( const InputState &input, f64 time );
+
+    void setVisible( const bool visible ) noexcept { m_visible = visible; }
+
+    constexpr bool isVisible() const noexcept { return m_visible; }
+
+private:
+    void drawWindow();
+
+    Profiler &m_profiler;
+    std::string m_traceFile;
+    std::vector<float> m_frameTimes;
+    bool m_visible;
+
+    u32 m_togglePresses;
+    f64 m_lastTime;
+};
@@ -9,9 +9,34 @@ static void sizeCallback( GLFWwindow *window, int width, int height )
         win->setSize(width, height);
 }
 
+static void cursorCallback( GLFWwindow *window, double x, double y )
+{
+    if (auto win = static_cast<glWindow *>(glfwGetWindowUserPointer(window)))
+        win->onCursor(x, y);
+}
+
+static void buttonCallback( GLFWwindow *window, int button, int action, int )
+{
+    if (auto win = static_cast<glWindow *>(glfwGetWindowUserPointer(window)))
+        win->onButton(button, action);
+}
+
+static void scrollCallback( GLFWwindow *window, double, double offset )
+{
+    if (auto win = static_cast<glWindow *>(glfwGetWindowUserPointer(window)))
+        win->onScroll(offset);
+}
 
-glWindow::glWindow( const std::string &title, const int width, const int height, const bool fullscreen, const int gl_major, const int gl_minor )
+static void keyCallback( GLFWwindow *window, int key, int, int action, int )
+{
+    if (auto win = static_cast<glWindow *>(glfwGetWindowUserPointer(window)))
+        win->onKey(key, action);
+}
+
+
+glWindow::glWindow( const std::string &title, const int width, const int height, const bool fullscreen, const int gl_major, const int gl_minor, const int samples )
     : m_window(nullptr)
+    , m_inputCount(0)
     , m_frameTimes{ }
     , m_lastFrame(glfwGetTime())
     , m_frameTimeIndex(0)
@@ -26,7 +51,7 @@ glWindow::glWindow( const std::string &title, const int width, const int height,
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, gl_minor);
     glfwWindowHint(GLFW_OPENGL_PROFILE,        GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
-    glfwWindowHint(GLFW_SAMPLES, 8);
+    glfwWindowHint(GLFW_SAMPLES, samples);
     glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_TRUE);
 
 #ifdef DEBUG
@@ -53,6 +78,14 @@ glWindow::glWindow( const std::string &title, const int width, const int height,
     glfwSetWindowUserPointer(m_window, this);
 
     glfwSetFramebufferSizeCallback(m_window, sizeCallback);
+    glfwSetCursorPosCallback(m_window, cursorCallback);
+    glfwSetMouseButtonCallback(m_window, buttonCallback);
+    glfwSetScrollCallback(m_window, scrollCallback);
+    glfwSetKeyCallback(m_window, keyCallback);
+
+    m_input.width = m_width;
+    m_input.height = m_height;
+    publishInput();
 }
 
 
@@ -67,6 +100,21 @@ void glWindow::swap() const noexcept
 }
 
 
+GLFWwindow *glWindow::createSharedContext() const
+{
+    // Context hints of the constructor are still in effect
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow *const shared = glfwCreateWindow(1, 1, "", nullptr, m_window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if (nullptr == shared) {
+        throw std::runtime_error("GLFW shared context could not be created");
+    }
+
+    return shared;
+}
+
+
 void glWindow::setWidth( const int width )
 {
     setSize(width, m_height);
@@ -82,5 +130,53 @@ void glWindow::setSize( const int width, const int height )
     m_width = width;
     m_height = height;
 
-    glViewport(0, 0, m_width, m_height);
+    // The viewport is set by the render thread, which owns the context
+    m_input.width = width;
+    m_input.height = height;
+    publishInput();
+}
+
+
+void glWindow::onCursor( const double x, const double y )
+{
+    m_input.cursorX = x;
+    m_input.cursorY = y;
+    publishInput();
+}
+
+void glWindow::onButton( const int button, const int action )
+{
+    if (button < 0 || button >= static_cast<int>(m_input.buttons.size()))
+        return;
+
+    m_input.buttons[button] = (action == GLFW_PRESS);
+    publishInput();
+}
+
+void glWindow::onScroll( const double offset )
+{
+    m_input.scroll += offset;
+    publishInput();
+}
+
+void glWindow::onKey( const int key, const int action )
+{
+    if (key < 0 || key > GLFW_KEY_LAST || action != GLFW_PRESS)
+        return;
+
+    m_input.keyPresses[key]++;
+    publishInput();
+}
+
+void glWindow::publishInput()
+{
+    m_inputs.getWriteBuffer() = m_input;
+    m_inputs.publish();
+    wakeInputWaiters();
+}
+
+void glWindow::wakeInputWaiters() noexcept
+{
+    m_inputCount.fetch_add(1, std::memory_order_acq_rel);
+    m_inputCount.notify_all();
 }
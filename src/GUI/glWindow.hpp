@@ -2,7 +2,10 @@
 
 
 #include <GLFW/glfw3.h>
+#include <atomic>
 #include <string>
+#include "GUI/InputState.hpp"
+#include "Threading/TripleBuffer.hpp"
 
 constexpr uint32_t N_FRAMETIMES = 4;
 constexpr double INV_N_FRAMETIMES = 1.0 / N_FRAMETIMES;
@@ -11,13 +14,39 @@ class glWindow {
 public:
     explicit glWindow( const std::string &title = "GL Window",
                        int width = 1280, int height = -1, bool fullscreen = false,
-                       int gl_major = 4, int gl_minor = 6 );
+                       int gl_major = 4, int gl_minor = 6, int samples = 0 );
 
     void swap() const noexcept;
 
+    /**
+     * Creates an invisible window whose context shares objects with this one,
+     * to be made current on a background thread. Must be called on the main thread.
+     */
+    GLFWwindow *createSharedContext() const;
+
     void makeCurrent() const noexcept { glfwMakeContextCurrent(m_window); }
     bool shouldClose() const noexcept { return glfwWindowShouldClose(m_window); }
 
+    /**
+     * Picks up the newest input state, may be called from one thread other than the main thread.
+     * @return true if anything changed since the last fetch
+     */
+    bool fetchInput() noexcept { return m_inputs.fetch(); }
+
+    const InputState &getInput() const noexcept { return m_inputs.getReadBuffer(); }
+
+    /**
+     * Number of input changes so far, for waitForInput().
+     */
+    u64 getInputCount() const noexcept { return m_inputCount.load(std::memory_order_acquire); }
+
+    /**
+     * Blocks until the input changed after seen was read from getInputCount(), or wakeInputWaiters() was called.
+     */
+    void waitForInput( const u64 seen ) const noexcept { m_inputCount.wait(seen, std::memory_order_acquire); }
+
+    void wakeInputWaiters() noexcept;
+
     void setWidth( int width );
 
     void setHeight( int height );
@@ -37,9 +66,21 @@ public:
         return avg * INV_N_FRAMETIMES;
     }
 
+    // Event handlers, called on the main thread
+    void onCursor( double x, double y );
+    void onButton( int button, int action );
+    void onScroll( double offset );
+    void onKey( int key, int action );
+
 private:
+    void publishInput();
+
     GLFWwindow *m_window;
 
+    InputState m_input;
+    TripleBuffer<InputState> m_inputs;
+    std::atomic<u64> m_inputCount;
+
     mutable double m_frameTimes[N_FRAMETIMES];
     mutable double m_lastFrame;
     mutable int m_frameTimeIndex;
@@ -1,45 +1,66 @@
 #include "IO/CSVReader.hpp"
+#include "IO/Expression.hpp"
+#include "IO/NumberParser.hpp"
+#include "Memory/ScratchArena.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <filesystem>
 
 
-static std::vector<std::string> readCSVLine( const std::string &line, const char sep )
-{
-    std::vector<std::string> splitLineData;
+// Cell of rows shorter than the header
+static constexpr const char *EMPTY_CELL = "";
 
-    std::stringstream line_ss(line);
-    std::string data;
+// Rows per parallel chunk when parsing a column
+static constexpr u64 PARSE_GRAIN = 1 << 14;
 
-    while (std::getline(line_ss, data, sep)) {
-        splitLineData.push_back(data);
-    }
 
-    return splitLineData;
+/**
+ * Splits line at sep like repeated std::getline calls, so a trailing empty field is dropped.
+ */
+static void splitCSVLine( const std::string_view line, const char sep, std::pmr::vector<std::string_view> &fields )
+{
+    fields.clear();
+
+    size_t begin = 0;
+    while (begin < line.size()) {
+        const size_t end = std::min(line.find(sep, begin), line.size());
+        fields.push_back(line.substr(begin, end - begin));
+        begin = end + 1;
+    }
 }
 
-static std::vector<std::string> readCSVLine( const std::string &line, const char sep, const u32 columns )
+/**
+ * Finds cell field of the row [begin, end), split like repeated std::getline calls.
+ * Cells split before are NUL-terminated in place, so NUL separates as well.
+ * @return false if the row has fewer cells
+ */
+static bool findCell( const char *begin, const char *end, const u32 field, const char sep, const char *&cellBegin, const char *&cellEnd )
 {
-    std::vector<std::string> splitLineData(columns);
-
-    std::stringstream line_ss(line);
-    std::string data;
+    const char *cell = begin;
+    for (u32 i = 0; cell < end; i++) {
+        const char *stop = cell;
+        while (stop < end && *stop != sep && *stop != '\0')
+            stop++;
 
-    for (u32 i = 0; i < columns; i++) {
-        if (std::getline(line_ss, data, sep))
-            splitLineData[i] = data;
+        if (i == field) {
+            cellBegin = cell;
+            cellEnd = stop;
+            return true;
+        }
+        cell = stop + 1;
     }
-
-    return splitLineData;
+    return false;
 }
 
-
 u32 CSVFile::getColCount() const noexcept { return static_cast<u32>(m_header.size()); }
 
 
 CSVFile::CSVFile( const std::string &filename )
     : m_filename(filename)
+    , m_separator(',')
     , m_rows(0)
     , m_hasData(false)
 {
@@ -53,33 +74,50 @@ bool CSVFile::read( const char separator )
     if (!m_isOk)
         return false;
 
-    std::ifstream f(m_filename);
-    if (!f) {
+    std::error_code error;
+    const u64 size = std::filesystem::file_size(m_filename, error);
+    std::ifstream f(m_filename, std::ios::binary);
+    if (!f || error) {
         std::clog << "Cannot read file \"" << m_filename << "\"" << std::endl;
         return false;
     }
 
-    std::string headerLine;
-    std::getline(f, headerLine);
-    std::vector<std::string> headers = readCSVLine(headerLine, separator);
+    const ScratchArena scratch;
+    std::lock_guard lock(m_cacheMutex);
 
-    const u32 columnCount = static_cast<u32>(headers.size());
-    m_values.reserve(columnCount);
-    for (u32 i = 0; i < columnCount; i++) {
-        m_header[headers[i]] = i;
-        m_values.emplace_back(0);
-    }
+    m_header.clear();
+    m_columns.clear();
+    m_floats.clear();
+    m_separator = separator;
+    m_arena = std::make_unique<std::pmr::monotonic_buffer_resource>(size + 1);
 
-    std::string line;
-    m_rows = 0;
-    while (std::getline(f, line)) {
-        u32 i = 0;
-        for (const std::string &entry : readCSVLine(line, separator, columnCount)) {
-            m_values[i].push_back(entry);
-            i++;
-        }
-        m_rows++;
+    // Cells are NUL-terminated in place once their column is split
+    char *const text = static_cast<char *>(m_arena->allocate(size + 1, 1));
+    f.read(text, static_cast<std::streamsize>(size));
+    char *const end = text + f.gcount();
+    *end = '\0';
+
+    char *const headerEnd = std::find(text, end, '\n');
+    std::pmr::vector<std::string_view> names(scratch.getResource());
+    const char *const headerLast = (headerEnd > text && headerEnd[-1] == '\r') ? headerEnd - 1 : headerEnd;
+    splitCSVLine({ text, headerLast }, separator, names);
+
+    for (u32 i = 0; i < names.size(); i++)
+        m_header[std::string(names[i])] = i;
+    m_columns.resize(names.size());
+
+    // Counted first, so the index is allocated exactly once
+    char *line = (headerEnd < end) ? headerEnd + 1 : end;
+    const u64 rows = std::count(line, end, '\n') + ((line < end && end[-1] != '\n') ? 1 : 0);
+
+    m_rowStarts = std::pmr::vector<const char *>(m_arena.get());
+    m_rowStarts.reserve(rows + 1);
+    while (line < end) {
+        m_rowStarts.push_back(line);
+        line = std::find(line, end, '\n') + 1;
     }
+    m_rowStarts.push_back(line);
+    m_rows = static_cast<u32>(m_rowStarts.size() - 1);
 
     std::cout << "Read " << m_rows << " data lines" << std::endl;
 
@@ -88,12 +126,148 @@ bool CSVFile::read( const char separator )
 }
 
 
-const std::vector<std::string> *CSVFile::getColumn( const std::string &name ) const noexcept
+void CSVFile::getCell( const u64 row, const u32 column, const char *&begin, const char *&end ) const
+{
+    // Without the line break and a carriage return, which may be NUL already
+    const char *const rowBegin = m_rowStarts[row];
+    const char *rowEnd = m_rowStarts[row + 1] - 1;
+    if (rowEnd > rowBegin && (rowEnd[-1] == '\r' || rowEnd[-1] == '\0'))
+        rowEnd--;
+
+    begin = EMPTY_CELL;
+    end = EMPTY_CELL;
+    findCell(rowBegin, rowEnd, column, m_separator, begin, end);
+}
+
+template<typename F>
+void CSVFile::forEachCell( const u32 column, F &&cell ) const
+{
+    ThreadPool::getShared().parallelFor(0, m_rows, PARSE_GRAIN, [this, column, &cell]( const u64 first, const u64 last ) {
+        for (u64 r = first; r < last; r++) {
+            const char *begin;
+            const char *end;
+            getCell(r, column, begin, end);
+            cell(r, begin, end);
+        }
+    });
+}
+
+bool CSVFile::findColumn( const std::string &name, u32 &index ) const
 {
-    if (!m_header.contains(name)) {
+    const auto it = m_header.find(name);
+    if (it == m_header.end()) {
         std::clog << "No column <" << name << "> in file \"" << m_filename << "\"" << std::endl;
+        return false;
+    }
+
+    index = it->second;
+    return true;
+}
+
+const CSVColumn *CSVFile::getColumn( const std::string &name ) const
+{
+    u32 index;
+    if (!findColumn(name, index))
         return nullptr;
+
+    std::lock_guard lock(m_cacheMutex);
+    if (!m_columns[index]) {
+        auto column = std::make_unique<CSVColumn>(m_arena.get());
+        column->m_cells.resize(m_rows);
+
+        // The text stays in place, only the cell ends are overwritten
+        forEachCell(index, [&column]( const u64 row, const char *begin, const char *end ) {
+            if (begin != EMPTY_CELL)
+                *const_cast<char *>(end) = '\0';
+            column->m_cells[row] = begin;
+        });
+        m_columns[index] = std::move(column);
+    }
+    return m_columns[index].get();
+}
+
+const std::vector<f32> *CSVFile::getValues( const std::string &nameOrExpression ) const
+{
+    std::lock_guard lock(m_cacheMutex);
+
+    if (m_header.contains(nameOrExpression))
+        return parseColumn(nameOrExpression);
+
+    if (const auto it = m_floats.find(nameOrExpression); it != m_floats.end())
+        return it->second.get();
+
+    std::string error;
+    const auto expression = Expression::parse(nameOrExpression, error);
+
+    std::unique_ptr<std::vector<f32>> values;
+    if (!expression) {
+        std::clog << "[ ERROR  ][Expr   ] <" << nameOrExpression << ">: " << error << std::endl;
+    }
+    else {
+        // Expressions refer to columns of the header only
+        const auto source = [this]( const std::string &name ) -> const std::vector<f32> * {
+            u32 index;
+            return findColumn(name, index) ? parseColumn(name) : nullptr;
+        };
+
+        values = std::make_unique<std::vector<f32>>();
+        if (!expression->evaluate(source, m_rows, *values))
+            values.reset();
+    }
+
+    return (m_floats[nameOrExpression] = std::move(values)).get();
+}
+
+bool CSVFile::resolveValues( const std::string &nameOrExpression, const std::vector<f32> *&values ) const
+{
+    values = getValues(nameOrExpression);
+    if (values || m_header.contains(nameOrExpression))
+        return values != nullptr;
+
+    // Only a plain name is a missing column, everything else a failed expression
+    std::string error;
+    const auto expression = Expression::parse(nameOrExpression, error);
+    return expression && expression->getColumns().size() == 1 && expression->getColumns().front() == nameOrExpression;
+}
+
+const std::vector<f32> *CSVFile::parseColumn( const std::string &name ) const
+{
+    if (const auto it = m_floats.find(name); it != m_floats.end())
+        return it->second.get();
+
+    const u32 column = m_header.at(name);
+    auto values = std::make_unique<std::vector<f32>>(m_rows);
+
+    // Format of the first row, the others fall back to the general parser if they differ
+    const char *sampleBegin = EMPTY_CELL;
+    const char *sampleEnd = EMPTY_CELL;
+    if (m_rows > 0)
+        getCell(0, column, sampleBegin, sampleEnd);
+    const NumberParser::Parse parse = NumberParser::detect({ sampleBegin, sampleEnd });
+
+    // Straight from the text, without splitting the column into cells first
+    std::atomic<u64> firstError = m_rows;
+    std::atomic<u64> errors = 0;
+    forEachCell(column, [&values, &firstError, &errors, parse]( const u64 row, const char *begin, const char *end ) {
+        if (parse(begin, end, (*values)[row]))
+            return;
+
+        errors++;
+        u64 first = firstError.load();
+        while (row < first && !firstError.compare_exchange_weak(first, row)) { }
+    });
+
+    if (errors > 0) {
+        const char *begin;
+        const char *end;
+        getCell(firstError, column, begin, end);
+        std::clog << "[ ERROR  ][Load   ] \"" << m_filename << "\" row " << firstError + 1 << " (line " << firstError + 2
+                  << "), column <" << name << ">: \"" << std::string_view(begin, end - begin) << "\" is not a number";
+        if (errors > 1)
+            std::clog << ", and " << errors - 1 << " more cells of this column";
+        std::clog << std::endl;
+        values.reset();
     }
 
-    return &m_values[m_header.at(name)];
+    return (m_floats[name] = std::move(values)).get();
 }
@@ -1,29 +1,111 @@
 #pragma once
 
 #include "defines.hpp"
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 
-using StringTabular = std::vector<std::vector<std::string>>;
+/**
+ * The cells of one column, pointing into the text of their CSVFile.
+ */
+class CSVColumn {
+public:
+    explicit CSVColumn( std::pmr::memory_resource *resource ) : m_cells(resource) { }
+
+    /**
+     * @return cell of row, NUL-terminated so data() is a C string
+     */
+    std::string_view at( const u32 row ) const { return m_cells.at(row); }
+
+    u32 size() const noexcept { return static_cast<u32>(m_cells.size()); }
+
+private:
+    friend class CSVFile;
+
+    std::pmr::vector<const char *> m_cells;
+};
+
 
 class CSVFile {
 public:
     explicit CSVFile( const std::string &filename );
 
+    CSVFile( const CSVFile & ) = delete;
+
+    /**
+     * Reads the file into a single block of text and indexes where its rows start.
+     * Cells are only split when a column is first requested, so the cost of a wide
+     * file is that of the columns used. Text, row index and columns are allocated from the
+     * arena of this file, temporaries from the ScratchArena of the calling thread.
+     */
     bool read( char separator = ',' );
 
-    const std::vector<std::string> *getColumn( const std::string &name ) const noexcept;
+    /**
+     * Splits the cells of column name on first use.
+     */
+    const CSVColumn *getColumn( const std::string &name ) const;
+
+    /**
+     * Values of a column, or of an expression over columns like <code>sqrt(X*X + Y*Y)</code>, see Expression.<br>
+     * Computed on first use and kept with the file, so meshes of the same file share them.
+     * @return nullptr if a column is missing, a cell is no number or the expression is invalid
+     */
+    const std::vector<f32> *getValues( const std::string &nameOrExpression ) const;
+
+    /**
+     * Like getValues(), but tells a missing column, which meshes replace by a default value, from a failure.
+     * @param values set to the values, nullptr if nameOrExpression is the name of a column missing in the header
+     * @return false if a cell is no number, or if the expression is invalid or uses a missing column
+     */
+    bool resolveValues( const std::string &nameOrExpression, const std::vector<f32> *&values ) const;
 
     u32 getColCount() const noexcept;
 
     constexpr u32 getRowCount() const noexcept { return m_rows; }
 
+    const std::string &getFilename() const noexcept { return m_filename; }
+
 protected:
+    /**
+     * Index of column name in the header, logs missing ones.
+     */
+    bool findColumn( const std::string &name, u32 &index ) const;
+
+    /**
+     * Finds the cell [begin, end) of row in column, empty if the row is shorter.
+     */
+    void getCell( u64 row, u32 column, const char *&begin, const char *&end ) const;
+
+    /**
+     * Calls cell(row, begin, end) for the cell of every row in column, in parallel.
+     * Rows without this column get an empty cell.
+     */
+    template<typename F>
+    void forEachCell( u32 column, F &&cell ) const;
+
+    /**
+     * Cached values of a column of the header, m_cacheMutex has to be locked.<br>
+     * The NumberParser is chosen by the format of the first row. Cells which are no numbers are
+     * logged with their row, and the column fails.
+     */
+    const std::vector<f32> *parseColumn( const std::string &name ) const;
+
     std::string m_filename;
     std::unordered_map<std::string, u32> m_header;
-    StringTabular m_values;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+    std::pmr::vector<const char *> m_rowStarts; // rows + 1, the last one past the end of the text
+    char m_separator;
+
+    mutable std::mutex m_cacheMutex;
+    mutable std::vector<std::unique_ptr<CSVColumn>> m_columns; // per header column, split on first use
+
+    // Parsed columns and evaluated expressions, nullptr for failures
+    mutable std::unordered_map<std::string, std::unique_ptr<std::vector<f32>>> m_floats;
 
     u32 m_rows;
 
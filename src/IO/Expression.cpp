@@ -0,0 +1,487 @@
+#include "Expression.hpp"
+#include "Memory/ScratchArena.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <memory_resource>
+#include <numbers>
+
+
+// Rows per block, the slots of one block stay in cache between instructions
+static constexpr u64 BLOCK_ROWS = 1024;
+
+// Rows per parallel chunk
+static constexpr u64 PARALLEL_GRAIN = 16 * BLOCK_ROWS;
+
+
+enum class Operation {
+    Add, Subtract, Multiply, Divide, Power, Min, Max, Atan2,
+    Negate, Sqrt, Abs, Exp, Log, Sin, Cos, Tan, Asin, Acos, Atan, Diff
+};
+
+struct Expression::Node {
+    enum class Type {
+        Constant,
+        Column,
+        Call
+    };
+
+    Type type;
+    f32 value{ 0.0f };
+    std::string column;
+    Operation operation{ Operation::Add };
+    std::unique_ptr<Node> a;
+    std::unique_ptr<Node> b; // binary operations only
+};
+
+using Node = Expression::Node;
+
+
+struct Function {
+    const char *name;
+    Operation operation;
+    u32 arguments;
+};
+
+static constexpr Function FUNCTIONS[] = {
+    { "sqrt", Operation::Sqrt, 1 }, { "abs", Operation::Abs, 1 }, { "exp", Operation::Exp, 1 }, { "log", Operation::Log, 1 },
+    { "sin", Operation::Sin, 1 }, { "cos", Operation::Cos, 1 }, { "tan", Operation::Tan, 1 }, { "asin", Operation::Asin, 1 },
+    { "acos", Operation::Acos, 1 }, { "atan", Operation::Atan, 1 }, { "diff", Operation::Diff, 1 },
+    { "atan2", Operation::Atan2, 2 }, { "pow", Operation::Power, 2 }, { "min", Operation::Min, 2 }, { "max", Operation::Max, 2 }
+};
+
+
+/**
+ * Recursive descent over the grammar documented in Expression.hpp.
+ */
+class Parser {
+public:
+    explicit Parser( const std::string &text ) : m_text(text), m_position(0) { }
+
+    std::unique_ptr<Node> parse( std::string &error )
+    {
+        auto root = expression();
+        skipSpace();
+        if (root && m_position < m_text.size())
+            fail("Unexpected '" + std::string(1, m_text[m_position]) + "'");
+
+        if (!m_error.empty()) {
+            error = m_error;
+            return nullptr;
+        }
+        return root;
+    }
+
+private:
+    static std::unique_ptr<Node> makeCall( const Operation operation, std::unique_ptr<Node> a, std::unique_ptr<Node> b = nullptr )
+    {
+        auto node = std::make_unique<Node>();
+        node->type = Node::Type::Call;
+        node->operation = operation;
+        node->a = std::move(a);
+        node->b = std::move(b);
+        return node;
+    }
+
+    static std::unique_ptr<Node> makeConstant( const f32 value )
+    {
+        auto node = std::make_unique<Node>();
+        node->type = Node::Type::Constant;
+        node->value = value;
+        return node;
+    }
+
+    std::nullptr_t fail( const std::string &message )
+    {
+        if (m_error.empty())
+            m_error = message + " at " + std::to_string(m_position + 1);
+        return nullptr;
+    }
+
+    void skipSpace()
+    {
+        while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position])))
+            m_position++;
+    }
+
+    bool accept( const char c )
+    {
+        skipSpace();
+        if (m_position < m_text.size() && m_text[m_position] == c) {
+            m_position++;
+            return true;
+        }
+        return false;
+    }
+
+    std::unique_ptr<Node> expression()
+    {
+        auto left = term();
+        while (left) {
+            if (accept('+'))
+                left = makeCall(Operation::Add, std::move(left), term());
+            else if (accept('-'))
+                left = makeCall(Operation::Subtract, std::move(left), term());
+            else
+                break;
+            if (!left->b)
+                return nullptr;
+        }
+        return left;
+    }
+
+    std::unique_ptr<Node> term()
+    {
+        auto left = unary();
+        while (left) {
+            if (accept('*'))
+                left = makeCall(Operation::Multiply, std::move(left), unary());
+            else if (accept('/'))
+                left = makeCall(Operation::Divide, std::move(left), unary());
+            else
+                break;
+            if (!left->b)
+                return nullptr;
+        }
+        return left;
+    }
+
+    std::unique_ptr<Node> unary()
+    {
+        if (accept('-')) {
+            auto operand = unary();
+            return operand ? makeCall(Operation::Negate, std::move(operand)) : nullptr;
+        }
+
+        auto base = primary();
+        if (base && accept('^')) {
+            auto exponent = unary();
+            return exponent ? makeCall(Operation::Power, std::move(base), std::move(exponent)) : nullptr;
+        }
+        return base;
+    }
+
+    std::unique_ptr<Node> primary()
+    {
+        skipSpace();
+        if (m_position >= m_text.size())
+            return fail("Unexpected end");
+
+        const char c = m_text[m_position];
+
+        if (accept('(')) {
+            auto inner = expression();
+            if (inner && !accept(')'))
+                return fail("Expected ')'");
+            return inner;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char *start = m_text.c_str() + m_position;
+            char *end = nullptr;
+            const f32 value = std::strtof(start, &end);
+            if (end == start)
+                return fail("Invalid number");
+            m_position += end - start;
+            return makeConstant(value);
+        }
+
+        if (c == '"') {
+            const size_t close = m_text.find('"', m_position + 1);
+            if (close == std::string::npos)
+                return fail("Unterminated column name");
+
+            auto node = std::make_unique<Node>();
+            node->type = Node::Type::Column;
+            node->column = m_text.substr(m_position + 1, close - m_position - 1);
+            m_position = close + 1;
+            return node;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            const size_t start = m_position;
+            while (m_position < m_text.size() && (std::isalnum(static_cast<unsigned char>(m_text[m_position])) || m_text[m_position] == '_'))
+                m_position++;
+            const std::string name = m_text.substr(start, m_position - start);
+
+            if (accept('('))
+                return call(name, start);
+
+            if (name == "pi")
+                return makeConstant(std::numbers::pi_v<f32>);
+
+            auto node = std::make_unique<Node>();
+            node->type = Node::Type::Column;
+            node->column = name;
+            return node;
+        }
+
+        return fail("Unexpected '" + std::string(1, c) + "'");
+    }
+
+    /**
+     * @param start position of name, for errors
+     */
+    std::unique_ptr<Node> call( const std::string &name, const size_t start )
+    {
+        const auto function = std::find_if(std::begin(FUNCTIONS), std::end(FUNCTIONS), [&name]( const Function &f ) { return name == f.name; });
+        if (function == std::end(FUNCTIONS)) {
+            m_position = start;
+            return fail("Unknown function " + name);
+        }
+
+        auto a = expression();
+        if (!a)
+            return nullptr;
+
+        std::unique_ptr<Node> b;
+        if (function->arguments == 2) {
+            if (!accept(','))
+                return fail(name + " expects 2 arguments");
+            if (!(b = expression()))
+                return nullptr;
+        }
+
+        if (!accept(')'))
+            return fail(function->arguments == 1 ? name + " expects 1 argument" : "Expected ')'");
+        return makeCall(function->operation, std::move(a), std::move(b));
+    }
+
+    const std::string &m_text;
+    size_t m_position;
+    std::string m_error;
+};
+
+
+/*
+ * Operations as types, so every kernel below is a loop of its own the compiler can vectorise.
+ */
+#define PLOTTY_OPERATION( NAME, EXPRESSION ) \
+    struct NAME { static f32 apply( [[maybe_unused]] const f32 a, [[maybe_unused]] const f32 b ) { return EXPRESSION; } };
+
+PLOTTY_OPERATION(AddOp, a + b)
+PLOTTY_OPERATION(SubtractOp, a - b)
+PLOTTY_OPERATION(MultiplyOp, a * b)
+PLOTTY_OPERATION(DivideOp, a / b)
+PLOTTY_OPERATION(PowerOp, std::pow(a, b))
+PLOTTY_OPERATION(MinOp, std::min(a, b))
+PLOTTY_OPERATION(MaxOp, std::max(a, b))
+PLOTTY_OPERATION(Atan2Op, std::atan2(a, b))
+PLOTTY_OPERATION(NegateOp, -a)
+PLOTTY_OPERATION(SqrtOp, std::sqrt(a))
+PLOTTY_OPERATION(AbsOp, std::abs(a))
+PLOTTY_OPERATION(ExpOp, std::exp(a))
+PLOTTY_OPERATION(LogOp, std::log(a))
+PLOTTY_OPERATION(SinOp, std::sin(a))
+PLOTTY_OPERATION(CosOp, std::cos(a))
+PLOTTY_OPERATION(TanOp, std::tan(a))
+PLOTTY_OPERATION(AsinOp, std::asin(a))
+PLOTTY_OPERATION(AcosOp, std::acos(a))
+PLOTTY_OPERATION(AtanOp, std::atan(a))
+
+#undef PLOTTY_OPERATION
+
+// Column with column
+template<typename Op>
+static void binaryColumns( const f32 *a, const f32 *b, f32 *out, const u64 n, f32 & )
+{
+    for (u64 i = 0; i < n; i++)
+        out[i] = Op::apply(a[i], b[i]);
+}
+
+// Column with constant, e.g. a unit conversion
+template<typename Op>
+static void binaryColumnConstant( const f32 *a, const f32 *b, f32 *out, const u64 n, f32 & )
+{
+    const f32 constant = *b;
+    for (u64 i = 0; i < n; i++)
+        out[i] = Op::apply(a[i], constant);
+}
+
+template<typename Op>
+static void binaryConstantColumn( const f32 *a, const f32 *b, f32 *out, const u64 n, f32 & )
+{
+    const f32 constant = *a;
+    for (u64 i = 0; i < n; i++)
+        out[i] = Op::apply(constant, b[i]);
+}
+
+template<typename Op>
+static void unaryColumn( const f32 *a, const f32 *, f32 *out, const u64 n, f32 & )
+{
+    for (u64 i = 0; i < n; i++)
+        out[i] = Op::apply(a[i], 0.0f);
+}
+
+static void diffColumn( const f32 *a, const f32 *, f32 *out, const u64 n, f32 &previous )
+{
+    out[0] = a[0] - previous;
+    for (u64 i = 1; i < n; i++)
+        out[i] = a[i] - a[i - 1];
+    previous = a[n - 1];
+}
+
+/**
+ * @param aConstant, bConstant which operands are constants, never both
+ */
+template<typename Op>
+static auto selectKernel( const bool unary, const bool aConstant, const bool bConstant )
+{
+    if (unary)
+        return &unaryColumn<Op>;
+    if (aConstant)
+        return &binaryConstantColumn<Op>;
+    if (bConstant)
+        return &binaryColumnConstant<Op>;
+    return &binaryColumns<Op>;
+}
+
+template<typename Op>
+static f32 fold( const f32 a, const f32 b )
+{
+    return Op::apply(a, b);
+}
+
+/**
+ * Calls f.template operator()<Op>() with the type of operation.
+ */
+template<typename F>
+static auto dispatch( const Operation operation, F &&f )
+{
+    switch (operation) {
+        case Operation::Add: return f.template operator()<AddOp>();
+        case Operation::Subtract: return f.template operator()<SubtractOp>();
+        case Operation::Multiply: return f.template operator()<MultiplyOp>();
+        case Operation::Divide: return f.template operator()<DivideOp>();
+        case Operation::Power: return f.template operator()<PowerOp>();
+        case Operation::Min: return f.template operator()<MinOp>();
+        case Operation::Max: return f.template operator()<MaxOp>();
+        case Operation::Atan2: return f.template operator()<Atan2Op>();
+        case Operation::Negate: return f.template operator()<NegateOp>();
+        case Operation::Sqrt: return f.template operator()<SqrtOp>();
+        case Operation::Abs: return f.template operator()<AbsOp>();
+        case Operation::Exp: return f.template operator()<ExpOp>();
+        case Operation::Log: return f.template operator()<LogOp>();
+        case Operation::Sin: return f.template operator()<SinOp>();
+        case Operation::Cos: return f.template operator()<CosOp>();
+        case Operation::Tan: return f.template operator()<TanOp>();
+        case Operation::Asin: return f.template operator()<AsinOp>();
+        case Operation::Acos: return f.template operator()<AcosOp>();
+        case Operation::Atan: return f.template operator()<AtanOp>();
+        case Operation::Diff: break; // has state, handled by the caller
+    }
+    return f.template operator()<AddOp>();
+}
+
+
+std::unique_ptr<Expression> Expression::parse( const std::string &text, std::string &error )
+{
+    Parser parser(text);
+    const auto root = parser.parse(error);
+    if (!root)
+        return nullptr;
+
+    std::unique_ptr<Expression> expression(new Expression());
+    expression->m_result = expression->compile(*root);
+    return expression;
+}
+
+Expression::Operand Expression::compile( const Node &node )
+{
+    if (node.type == Node::Type::Constant)
+        return { Operand::Kind::Constant, 0, node.value };
+
+    if (node.type == Node::Type::Column) {
+        const auto it = std::find(m_columns.begin(), m_columns.end(), node.column);
+        const auto index = static_cast<u32>(it - m_columns.begin());
+        if (it == m_columns.end())
+            m_columns.push_back(node.column);
+        return { Operand::Kind::Column, index, 0.0f };
+    }
+
+    const Operand a = compile(*node.a);
+    const Operand b = node.b ? compile(*node.b) : Operand{ Operand::Kind::Constant, 0, 0.0f };
+    const bool unary = !node.b;
+    const bool aConstant = a.kind == Operand::Kind::Constant;
+    const bool bConstant = b.kind == Operand::Kind::Constant;
+
+    if (node.operation == Operation::Diff) {
+        if (aConstant)
+            return { Operand::Kind::Constant, 0, 0.0f };
+
+        m_sequential = true;
+        m_program.push_back({ &diffColumn, a, b, m_slotCount, true });
+        return { Operand::Kind::Slot, m_slotCount++, 0.0f };
+    }
+
+    // Constant subexpressions are computed once here
+    if (aConstant && bConstant) {
+        const f32 value = dispatch(node.operation, [&]<typename Op>() { return fold<Op>(a.value, b.value); });
+        return { Operand::Kind::Constant, 0, value };
+    }
+
+    const Kernel kernel = dispatch(node.operation, [&]<typename Op>() -> Kernel { return selectKernel<Op>(unary, aConstant, bConstant); });
+    m_program.push_back({ kernel, a, b, m_slotCount, false });
+    return { Operand::Kind::Slot, m_slotCount++, 0.0f };
+}
+
+bool Expression::evaluate( const ColumnSource &source, const u64 rows, std::vector<f32> &values ) const
+{
+    std::vector<const f32 *> columns;
+    for (const std::string &name : m_columns) {
+        const std::vector<f32> *column = source(name);
+        if (nullptr == column || column->size() < rows)
+            return false;
+        columns.push_back(column->data());
+    }
+
+    values.resize(rows);
+
+    const auto run = [this, &columns, &values]( const u64 first, const u64 last ) {
+        const ScratchArena scratch;
+        std::pmr::vector<f32> slots(m_slotCount * BLOCK_ROWS, scratch.getResource());
+        std::pmr::vector<f32> states(m_program.size(), 0.0f, scratch.getResource());
+
+        for (u64 block = first; block < last; block += BLOCK_ROWS) {
+            const u64 n = std::min(BLOCK_ROWS, last - block);
+
+            const auto resolve = [&]( const Operand &operand ) -> const f32 * {
+                switch (operand.kind) {
+                    case Operand::Kind::Slot: return &slots[operand.index * BLOCK_ROWS];
+                    case Operand::Kind::Column: return columns[operand.index] + block;
+                    case Operand::Kind::Constant: break;
+                }
+                return &operand.value;
+            };
+
+            if (m_program.empty()) {
+                // A single column or constant
+                const f32 *result = resolve(m_result);
+                if (m_result.kind == Operand::Kind::Constant)
+                    std::fill_n(values.data() + block, n, *result);
+                else
+                    std::copy_n(result, n, values.data() + block);
+                continue;
+            }
+
+            for (size_t i = 0; i < m_program.size(); i++) {
+                const Instruction &instruction = m_program[i];
+                const f32 *a = resolve(instruction.a);
+                if (block == 0 && instruction.carries)
+                    states[i] = a[0];
+
+                // The last instruction is the root and writes the result directly
+                f32 *out = (i + 1 == m_program.size()) ? values.data() + block : &slots[instruction.out * BLOCK_ROWS];
+                instruction.kernel(a, resolve(instruction.b), out, n, states[i]);
+            }
+        }
+    };
+
+    if (m_sequential)
+        run(0, rows);
+    else
+        ThreadPool::getShared().parallelFor(0, rows, PARALLEL_GRAIN, run);
+    return true;
+}
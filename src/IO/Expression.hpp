@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+
+/**
+ * An arithmetic expression over the columns of a CSVFile, e.g. <code>sqrt(X*X + Y*Y)</code>.<br>
+ * Grammar, with the usual precedence and ^ binding right:
+ * <pre>
+ * expression := term (('+' | '-') term)*
+ * term       := unary (('*' | '/') unary)*
+ * unary      := '-' unary | power
+ * power      := primary ('^' unary)?
+ * primary    := number | column | function '(' expression (',' expression)* ')' | '(' expression ')'
+ * column     := identifier | '"' any name '"'
+ * </pre>
+ * Functions: sqrt abs exp log sin cos tan asin acos atan diff (one argument), atan2 pow min max (two),
+ * the constant pi. diff(a) is the difference to the previous row, 0 in the first one.<br>
+ * The syntax tree is compiled into a list of column-at-a-time instructions, each one a loop specialised
+ * for its operation and whether its operands are columns or constants, which the compiler vectorises.
+ * Rows are evaluated in blocks which stay in cache, independent blocks in parallel.
+ */
+class Expression {
+public:
+    /**
+     * Values of the column name, nullptr if there is none.
+     */
+    using ColumnSource = std::function<const std::vector<f32> *( const std::string &name )>;
+
+    /**
+     * @param error set to a description with the position if text is no valid expression
+     * @return nullptr on errors
+     */
+    static std::unique_ptr<Expression> parse( const std::string &text, std::string &error );
+
+    /**
+     * Names of all columns used, each once.
+     */
+    const std::vector<std::string> &getColumns() const noexcept { return m_columns; }
+
+    /**
+     * Evaluates the expression for rows rows into values.
+     * @return false if a column is missing or shorter than rows
+     */
+    bool evaluate( const ColumnSource &source, u64 rows, std::vector<f32> &values ) const;
+
+    // Syntax tree, only used while parsing
+    struct Node;
+
+private:
+    struct Operand {
+        enum class Kind : u8 {
+            Slot,
+            Column,
+            Constant
+        };
+
+        Kind kind;
+        u32 index; // slot or column
+        f32 value; // constant
+    };
+
+    /**
+     * Writes the results of n rows to out. Scalar operands point to their constant,
+     * state carries a value from one block to the next.
+     */
+    using Kernel = void (*)( const f32 *a, const f32 *b, f32 *out, u64 n, f32 &state );
+
+    struct Instruction {
+        Kernel kernel;
+        Operand a;
+        Operand b;
+        u32 out;      // slot
+        bool carries; // state starts with the first row of a
+    };
+
+    Expression() = default;
+
+    Operand compile( const Node &node );
+
+    std::vector<std::string> m_columns;
+    std::vector<Instruction> m_program;
+    Operand m_result{ Operand::Kind::Constant, 0, 0.0f };
+    u32 m_slotCount{ 0 };
+    bool m_sequential{ false }; // diff() carries state from block to block
+};
@@ -0,0 +1,146 @@
+#include "FileWatcher.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Events of one file closer than this are delivered as one notification
+static constexpr double COALESCE_SECONDS = 0.05;
+static constexpr int POLL_MILLISECONDS = 100;
+
+
+static double now()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string normalize( const std::filesystem::path &path )
+{
+    std::error_code error;
+    const std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    return (error ? path : absolute).lexically_normal().string();
+}
+
+
+FileWatcher::FileWatcher( Callback callback )
+    : m_callback(std::move(callback))
+#ifdef __linux__
+    , m_inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+#endif
+    , m_running(true)
+{
+#ifdef __linux__
+    if (m_inotify < 0)
+        std::clog << "[WARNING ][Watch  ] inotify is not available, file changes are not noticed" << std::endl;
+#endif
+    m_thread = std::thread(&FileWatcher::loop, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+    m_running = false;
+    m_thread.join();
+
+#ifdef __linux__
+    if (m_inotify >= 0)
+        close(m_inotify);
+#endif
+}
+
+void FileWatcher::watch( const std::string &path )
+{
+    const std::string normalized = normalize(path);
+
+    std::lock_guard lock(m_mutex);
+    m_files[normalized] = path;
+
+#ifdef __linux__
+    if (m_inotify < 0)
+        return;
+
+    const std::filesystem::path directory = std::filesystem::path(normalized).parent_path();
+    const int wd = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0)
+        std::clog << "[WARNING ][Watch  ] Cannot watch \"" << directory.string() << '"' << std::endl;
+    else
+        m_directories[wd] = directory;
+#else
+    std::error_code error;
+    m_writeTimes[normalized] = std::filesystem::last_write_time(normalized, error);
+#endif
+}
+
+void FileWatcher::collect()
+{
+#ifdef __linux__
+    if (m_inotify < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MILLISECONDS));
+        return;
+    }
+
+    pollfd descriptor{ m_inotify, POLLIN, 0 };
+    if (poll(&descriptor, 1, POLL_MILLISECONDS) <= 0)
+        return;
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+        std::lock_guard lock(m_mutex);
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            const auto directory = m_directories.find(event->wd);
+            if (event->len == 0 || directory == m_directories.end())
+                continue;
+
+            const auto file = m_files.find((directory->second / event->name).string());
+            if (file != m_files.end())
+                m_pending[file->second] = now();
+        }
+    }
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MILLISECONDS));
+
+    std::lock_guard lock(m_mutex);
+    for (auto &[path, writeTime] : m_writeTimes) {
+        std::error_code error;
+        const auto current = std::filesystem::last_write_time(path, error);
+        if (!error && current != writeTime) {
+            writeTime = current;
+            m_pending[m_files[path]] = now();
+        }
+    }
+#endif
+}
+
+void FileWatcher::loop()
+{
+    while (m_running) {
+        collect();
+
+        std::vector<std::string> ready;
+        {
+            std::lock_guard lock(m_mutex);
+            const double t = now();
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                if (t - it->second >= COALESCE_SECONDS) {
+                    ready.push_back(it->first);
+                    it = m_pending.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        for (const std::string &path : ready)
+            m_callback(path);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+
+/**
+ * Notifies about modified files on a background thread.<br>
+ * On Linux the parent directories are watched with inotify, so editors that save by
+ * writing a new file and renaming it over the old one are noticed as well.
+ * Other platforms fall back to polling the modification times.
+ * Bursts of events for the same file are coalesced into one callback.
+ */
+class FileWatcher {
+public:
+    using Callback = std::function<void( const std::string &path )>;
+
+    explicit FileWatcher( Callback callback );
+
+    FileWatcher( const FileWatcher & ) = delete;
+
+    ~FileWatcher();
+
+    /**
+     * Starts watching path, the callback receives it in the same spelling.
+     */
+    void watch( const std::string &path );
+
+private:
+    void loop();
+
+    void collect();
+
+    Callback m_callback;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::string> m_files; // normalized absolute path -> registered path
+    std::map<std::string, double> m_pending;               // registered path -> time of last event
+
+#ifdef __linux__
+    int m_inotify;
+    std::unordered_map<int, std::filesystem::path> m_directories; // watch descriptor -> directory
+#else
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_writeTimes;
+#endif
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
@@ -0,0 +1,134 @@
+#include "FrameWriter.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+#ifdef PLOTTY_HAS_PNG
+#include <png.h>
+#endif
+
+
+static std::string getFramePath( const std::string &directory, const u64 index, const char *extension )
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%06llu.%s", static_cast<unsigned long long>(index), extension);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+static bool writeImage( const std::string &directory, const FramePixels &frame )
+{
+    const auto rowSize = static_cast<size_t>(frame.width) * 4;
+
+#ifdef PLOTTY_HAS_PNG
+    png_image image{ };
+    image.version = PNG_IMAGE_VERSION;
+    image.width = static_cast<png_uint_32>(frame.width);
+    image.height = static_cast<png_uint_32>(frame.height);
+    image.format = PNG_FORMAT_RGBA;
+
+    // A negative stride makes libpng walk the rows bottom-up, which flips the GL image
+    const std::string path = getFramePath(directory, frame.index, "png");
+    const bool success = png_image_write_to_file(&image, path.c_str(), 0, frame.rgba.data(), -static_cast<png_int_32>(rowSize), nullptr);
+    png_image_free(&image);
+    return success;
+#else
+    std::ofstream out(getFramePath(directory, frame.index, "ppm"), std::ios::binary);
+    out << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+
+    std::vector<u8> row(static_cast<size_t>(frame.width) * 3);
+    for (int y = frame.height - 1; y >= 0; y--) {
+        const u8 *src = frame.rgba.data() + y * rowSize;
+        for (int x = 0; x < frame.width; x++) {
+            row[3 * x + 0] = src[4 * x + 0];
+            row[3 * x + 1] = src[4 * x + 1];
+            row[3 * x + 2] = src[4 * x + 2];
+        }
+        out.write(reinterpret_cast<const char *>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+    return static_cast<bool>(out);
+#endif
+}
+
+
+FrameWriter::FrameWriter( std::string directory, const FrameFormat format, const u32 maxQueued )
+    : m_directory(std::move(directory))
+    , m_format(format)
+    , m_maxQueued(std::max(maxQueued, 1u))
+    , m_queued(0)
+    , m_written(0)
+    , m_failed(false)
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error)
+        std::clog << "[WARNING ][Writer ] Cannot create \"" << m_directory << "\": " << error.message() << std::endl;
+
+    if (m_format == FrameFormat::Raw)
+        m_raw.open(std::filesystem::path(m_directory) / "frames.rgba", std::ios::binary | std::ios::trunc);
+
+    m_queue = std::make_unique<TaskQueue>();
+}
+
+FrameWriter::~FrameWriter()
+{
+    m_queue.reset();
+}
+
+void FrameWriter::write( FramePixels &&frame )
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_queued < m_maxQueued; });
+        m_queued++;
+    }
+
+    m_queue->push([this, frame = std::move(frame)] {
+        encode(frame);
+        {
+            std::lock_guard lock(m_mutex);
+            m_queued--;
+        }
+        m_condition.notify_all();
+    });
+}
+
+void FrameWriter::finish()
+{
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_queued == 0; });
+}
+
+void FrameWriter::encode( const FramePixels &frame )
+{
+    bool success;
+    if (m_format == FrameFormat::Raw) {
+        const auto rowSize = static_cast<std::streamsize>(frame.width) * 4;
+        for (int y = frame.height - 1; y >= 0; y--)
+            m_raw.write(reinterpret_cast<const char *>(frame.rgba.data()) + y * rowSize, rowSize);
+        success = static_cast<bool>(m_raw);
+    }
+    else {
+        success = writeImage(m_directory, frame);
+    }
+
+    if (success) {
+        m_written++;
+    }
+    else if (!m_failed) {
+        // Report once, a full disk would otherwise flood the log
+        m_failed = true;
+        std::clog << "[ ERROR  ][Writer ] Cannot write frame " << frame.index << " to \"" << m_directory << '"' << std::endl;
+    }
+}
+
+bool FrameWriter::parseFormat( const std::string &name, FrameFormat &format )
+{
+    if (name == "png")
+        format = FrameFormat::Png;
+    else if (name == "raw")
+        format = FrameFormat::Raw;
+    else
+        return false;
+    return true;
+}
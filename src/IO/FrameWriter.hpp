@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "defines.hpp"
+#include "Rendering/FrameReadback.hpp"
+#include "Threading/TaskQueue.hpp"
+
+
+enum class FrameFormat {
+    Png, // one frame_NNNNNN.png per frame (PPM if built without libpng)
+    Raw  // all frames appended to frames.rgba, top row first, for e.g. ffmpeg -f rawvideo -pix_fmt rgba
+};
+
+
+/**
+ * Encodes and writes frames on a background thread.<br>
+ * write() only blocks if more than maxQueued frames are waiting, which bounds memory
+ * when encoding is slower than rendering.
+ */
+class FrameWriter {
+public:
+    FrameWriter( std::string directory, FrameFormat format, u32 maxQueued = 8 );
+
+    FrameWriter( const FrameWriter & ) = delete;
+
+    // Writes all queued frames
+    ~FrameWriter();
+
+    void write( FramePixels &&frame );
+
+    /**
+     * Blocks until all queued frames are written.
+     */
+    void finish();
+
+    u64 getWrittenCount() const noexcept { return m_written; }
+
+    static bool parseFormat( const std::string &name, FrameFormat &format );
+
+private:
+    void encode( const FramePixels &frame );
+
+    std::string m_directory;
+    FrameFormat m_format;
+    u32 m_maxQueued;
+    std::ofstream m_raw;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    u32 m_queued;
+    std::atomic<u64> m_written;
+    bool m_failed;
+
+    // Declared last, so it drains before anything above is destroyed
+    std::unique_ptr<TaskQueue> m_queue;
+};
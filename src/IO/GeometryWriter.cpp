@@ -0,0 +1,134 @@
+#include "GeometryWriter.hpp"
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+
+static constexpr u64 GEOMETRY_MAGIC = 0x53574F52594C5450; // "PTLYROWS"
+static constexpr u32 GEOMETRY_VERSION = 1;
+
+// Bytes formatted before they are handed to the stream
+static constexpr u64 BUFFER_SIZE = 1 << 20;
+
+// Longest float formatted by std::to_chars plus separator
+static constexpr u64 MAX_VALUE_CHARS = 32;
+
+// Offset of the row count in the binary header
+static constexpr std::streamoff ROW_COUNT_OFFSET = sizeof(u64) + 2 * sizeof(u32);
+
+
+GeometryWriter::GeometryWriter( const std::string &path, const GeometryFormat format, const std::vector<std::string> &columns )
+    : m_path(path)
+    , m_tmpPath(path + ".tmp")
+    , m_format(format)
+    , m_columns(static_cast<u32>(columns.size()))
+    , m_file(m_tmpPath, std::ios::binary | std::ios::trunc)
+    , m_buffer(BUFFER_SIZE)
+    , m_used(0)
+    , m_rows(0)
+{
+    if (!m_file) {
+        std::clog << "[ ERROR  ][Batch  ] Cannot write \"" << path << '"' << std::endl;
+        return;
+    }
+
+    std::string names;
+    for (const std::string &column : columns)
+        names += (names.empty() ? "" : (format == GeometryFormat::Csv ? "," : "\n")) + column;
+
+    if (format == GeometryFormat::Csv) {
+        m_file << names << '\n';
+        return;
+    }
+
+    const u64 rows = 0;
+    const auto length = static_cast<u32>(names.size());
+    m_file.write(reinterpret_cast<const char *>(&GEOMETRY_MAGIC), sizeof(GEOMETRY_MAGIC));
+    m_file.write(reinterpret_cast<const char *>(&GEOMETRY_VERSION), sizeof(GEOMETRY_VERSION));
+    m_file.write(reinterpret_cast<const char *>(&m_columns), sizeof(m_columns));
+    m_file.write(reinterpret_cast<const char *>(&rows), sizeof(rows));
+    m_file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    m_file.write(names.data(), length);
+}
+
+GeometryWriter::~GeometryWriter()
+{
+    if (m_file.is_open()) {
+        m_file.close();
+        std::error_code error;
+        std::filesystem::remove(m_tmpPath, error);
+    }
+}
+
+void GeometryWriter::write( const f32 *rows, const u64 count )
+{
+    if (!m_file.is_open())
+        return;
+
+    if (m_format == GeometryFormat::Binary) {
+        const u64 bytes = count * m_columns * sizeof(f32);
+        if (bytes >= BUFFER_SIZE) {
+            // Larger than the buffer anyway, no reason to copy
+            flush();
+            m_file.write(reinterpret_cast<const char *>(rows), static_cast<std::streamsize>(bytes));
+        }
+        else {
+            if (m_used + bytes > BUFFER_SIZE)
+                flush();
+            std::memcpy(m_buffer.data() + m_used, rows, bytes);
+            m_used += bytes;
+        }
+        m_rows += count;
+        return;
+    }
+
+    for (u64 r = 0; r < count; r++) {
+        if (m_used + m_columns * MAX_VALUE_CHARS > BUFFER_SIZE)
+            flush();
+
+        char *out = m_buffer.data() + m_used;
+        for (u32 c = 0; c < m_columns; c++) {
+            out = std::to_chars(out, out + MAX_VALUE_CHARS - 1, rows[r * m_columns + c]).ptr;
+            *out++ = (c + 1 < m_columns) ? ',' : '\n';
+        }
+        m_used = out - m_buffer.data();
+    }
+    m_rows += count;
+}
+
+bool GeometryWriter::close()
+{
+    if (!m_file.is_open())
+        return false;
+
+    flush();
+    if (m_format == GeometryFormat::Binary) {
+        m_file.seekp(ROW_COUNT_OFFSET);
+        m_file.write(reinterpret_cast<const char *>(&m_rows), sizeof(m_rows));
+    }
+
+    const bool written = static_cast<bool>(m_file);
+    m_file.close();
+
+    std::error_code error;
+    if (written)
+        std::filesystem::rename(m_tmpPath, m_path, error);
+    if (!written || error) {
+        std::clog << "[ ERROR  ][Batch  ] Cannot write \"" << m_path << '"' << std::endl;
+        std::filesystem::remove(m_tmpPath, error);
+        return false;
+    }
+    return true;
+}
+
+GeometryFormat GeometryWriter::formatOf( const std::string &path )
+{
+    return std::filesystem::path(path).extension() == ".csv" ? GeometryFormat::Csv : GeometryFormat::Binary;
+}
+
+void GeometryWriter::flush()
+{
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+    m_used = 0;
+}
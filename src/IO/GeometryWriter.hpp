@@ -0,0 +1,63 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+
+enum class GeometryFormat {
+    Csv,   // header line of the column names, then one line per row
+    Binary // see GeometryWriter
+};
+
+
+/**
+ * Streams rows of floats into a file through a fixed size buffer, so results of any length are written
+ * without being formatted in memory first. The binary format is
+ * <pre>
+ * u64 magic "PTLYROWS" | u32 version | u32 column count | u64 row count | u32 length, column names joined by '\n' | f32 rows
+ * </pre>
+ * The row count is filled in by close(). Both formats go to a temporary file, renamed once complete.
+ */
+class GeometryWriter {
+public:
+    GeometryWriter( const std::string &path, GeometryFormat format, const std::vector<std::string> &columns );
+
+    GeometryWriter( const GeometryWriter & ) = delete;
+
+    // Discards the file unless closed
+    ~GeometryWriter();
+
+    bool isValid() const noexcept { return m_file.is_open(); }
+
+    /**
+     * Appends count rows of one float per column.
+     */
+    void write( const f32 *rows, u64 count );
+
+    /**
+     * Flushes the buffer and moves the file into place.
+     */
+    bool close();
+
+    u64 getRowCount() const noexcept { return m_rows; }
+
+    /**
+     * @return Binary unless path ends in .csv
+     */
+    static GeometryFormat formatOf( const std::string &path );
+
+private:
+    void flush();
+
+    std::string m_path;
+    std::string m_tmpPath;
+    GeometryFormat m_format;
+    u32 m_columns;
+    std::ofstream m_file;
+    std::vector<char> m_buffer;
+    u64 m_used;
+    u64 m_rows;
+};
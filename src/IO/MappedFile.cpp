@@ -0,0 +1,112 @@
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile( const std::string &path )
+    : m_data(nullptr)
+    , m_size(0)
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+{
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size{ };
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        std::clog << "[ ERROR  ][Map    ] Cannot map \"" << path << '"' << std::endl;
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+        m_data = static_cast<const u8 *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data)
+        m_size = static_cast<u64>(size.QuadPart);
+    else
+        std::clog << "[ ERROR  ][Map    ] Cannot map \"" << path << '"' << std::endl;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+}
+
+void MappedFile::advise( u64, u64, Advice ) const
+{
+    // The working set is left to the system
+}
+
+u64 MappedFile::getPageSize()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+
+#else
+
+MappedFile::MappedFile( const std::string &path )
+    : m_data(nullptr)
+    , m_size(0)
+{
+    const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status{ };
+    if (file < 0 || fstat(file, &status) != 0 || status.st_size == 0) {
+        std::clog << "[ ERROR  ][Map    ] Cannot map \"" << path << '"' << std::endl;
+        if (file >= 0)
+            close(file);
+        return;
+    }
+
+    // The mapping keeps the file referenced, the descriptor is not needed any more
+    void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+
+    if (data == MAP_FAILED) {
+        std::clog << "[ ERROR  ][Map    ] Cannot map \"" << path << '"' << std::endl;
+        return;
+    }
+
+    m_data = static_cast<const u8 *>(data);
+    m_size = static_cast<u64>(status.st_size);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        munmap(const_cast<u8 *>(m_data), m_size);
+}
+
+void MappedFile::advise( const u64 offset, const u64 size, const Advice advice ) const
+{
+    if (!m_data || offset >= m_size)
+        return;
+
+    const u64 page = getPageSize();
+    const u64 first = offset / page * page;
+    const u64 last = std::min(offset + size, m_size);
+    madvise(const_cast<u8 *>(m_data) + first, last - first, advice == Advice::WillNeed ? MADV_WILLNEED : MADV_DONTNEED);
+}
+
+u64 MappedFile::getPageSize()
+{
+    static const u64 page = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+#include "defines.hpp"
+
+
+/**
+ * Read-only memory mapping of a whole file. Pages are read on first access, so
+ * files much larger than RAM can be mapped, and advise() steers which parts stay resident.
+ */
+class MappedFile {
+public:
+    enum class Advice {
+        WillNeed, // start reading the range in the background
+        DontNeed  // drop the range from RAM, it is read from disk again on next access
+    };
+
+    explicit MappedFile( const std::string &path );
+
+    MappedFile( const MappedFile & ) = delete;
+
+    ~MappedFile();
+
+    bool isValid() const noexcept { return nullptr != m_data; }
+
+    const u8 *getData() const noexcept { return m_data; }
+    u64 getSize() const noexcept { return m_size; }
+
+    /**
+     * Hint for the range [offset, offset + size), rounded to whole pages. Ignored where unsupported.
+     */
+    void advise( u64 offset, u64 size, Advice advice ) const;
+
+    static u64 getPageSize();
+
+private:
+    const u8 *m_data;
+    u64 m_size;
+
+#ifdef _WIN32
+    void *m_file;
+    void *m_mapping;
+#endif
+};
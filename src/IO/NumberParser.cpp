@@ -0,0 +1,167 @@
+#include "IO/NumberParser.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+
+// Digits of a fixed format number, so the mantissa is exact in a f64
+static constexpr u32 MAX_DIGITS = 15;
+
+static constexpr f64 POWERS_OF_TEN[MAX_DIGITS + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+};
+
+
+static bool isBlank( const char c ) { return c == ' ' || c == '\t'; }
+
+static u64 loadWord( const char *bytes )
+{
+    u64 word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+/**
+ * Whether all eight bytes of word are '0' to '9'.
+ */
+static bool isDigits( const u64 word )
+{
+    return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+/**
+ * Value of eight digits, the first one in the lowest byte.
+ */
+static u64 toInteger( u64 word )
+{
+    word -= 0x3030303030303030;
+    word = word * 10 + (word >> 8);
+    return ((word & 0x000000FF000000FF) * (100 + (1000000ull << 32)) + ((word >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32))) >> 32;
+}
+
+/**
+ * mantissa / 10^fraction rounded to f32 in a single step.
+ * @return false in the rare case the f64 quotient lies right between two f32, where rounding it again might be off
+ */
+static bool toFloat( const u64 mantissa, const u32 fraction, f32 &value )
+{
+    // Both exact in f32, so the division rounds correctly
+    if (mantissa < (1u << 24) && fraction <= 10) {
+        value = static_cast<f32>(mantissa) / static_cast<f32>(POWERS_OF_TEN[fraction]);
+        return true;
+    }
+
+    const f64 quotient = static_cast<f64>(mantissa) / POWERS_OF_TEN[fraction];
+    value = static_cast<f32>(quotient);
+    return (std::bit_cast<u64>(quotient) & 0x1FFFFFFF) != 0x10000000;
+}
+
+/**
+ * Cells like [+-]ddd.fff with FRACTION digits after the point, none without a point.
+ */
+template<u32 FRACTION>
+static bool parseFixed( const char *begin, const char *end, f32 &value )
+{
+    const bool negative = begin < end && *begin == '-';
+    const char *const digits = begin + (begin < end && (*begin == '-' || *begin == '+'));
+    const char *const point = end - FRACTION - (FRACTION > 0);
+    const u64 integers = point - digits;
+    if (point < digits || integers + FRACTION == 0 || integers + FRACTION > MAX_DIGITS || (FRACTION > 0 && *point != '.'))
+        return NumberParser::parseGeneral(begin, end, value);
+
+    u64 mantissa;
+    bool valid;
+    if (end - begin >= 8 && end - digits <= 8) {
+        // The last eight bytes of the cell, with '0' in front of the digits and the point taken out
+        u64 word = loadWord(end - 8);
+        const u64 lead = (1ull << (8 * (8 - (end - digits)))) - 1;
+        word = (word & ~lead) | (0x3030303030303030 & lead);
+        if constexpr (FRACTION > 0) {
+            constexpr u64 BELOW = (1ull << (8 * (7 - std::min(FRACTION, 7u)))) - 1; // digits in front of the point
+            word = ((word & BELOW) << 8) | (word & ~(BELOW << 8 | 0xFF)) | 0x30;
+        }
+        mantissa = toInteger(word);
+        valid = isDigits(word);
+    }
+    else {
+        // Right aligned behind leading zeros, without the point
+        char buffer[16];
+        static_assert(FRACTION <= sizeof(buffer));
+        // Checked above already, clamped again so the compiler can tell the copy stays within buffer
+        const u64 leading = std::min<u64>(integers, sizeof(buffer) - FRACTION);
+        std::memset(buffer, '0', sizeof(buffer));
+        std::memcpy(buffer + sizeof(buffer) - FRACTION - leading, digits, leading);
+        std::memcpy(buffer + sizeof(buffer) - FRACTION, point + 1, FRACTION);
+
+        const u64 high = loadWord(buffer);
+        const u64 low = loadWord(buffer + 8);
+        mantissa = toInteger(high) * 100000000 + toInteger(low);
+        valid = isDigits(high) & isDigits(low);
+    }
+
+    if (!valid || !toFloat(mantissa, FRACTION, value))
+        return NumberParser::parseGeneral(begin, end, value);
+
+    value = negative ? -value : value;
+    return true;
+}
+
+template<u64... FRACTIONS>
+static constexpr auto makeFixedParsers( std::index_sequence<FRACTIONS...> )
+{
+    return std::array<NumberParser::Parse, sizeof...(FRACTIONS)>{ &parseFixed<FRACTIONS>... };
+}
+
+static constexpr auto FIXED_PARSERS = makeFixedParsers(std::make_index_sequence<MAX_DIGITS + 1>());
+
+
+NumberParser::Parse NumberParser::detect( const std::string_view sample ) noexcept
+{
+    // The words are read in little endian order
+    if constexpr (std::endian::native != std::endian::little)
+        return &parseGeneral;
+
+    const auto isDigit = []( const char c ) { return c >= '0' && c <= '9'; };
+    auto c = sample.begin();
+    if (c != sample.end() && (*c == '-' || *c == '+'))
+        c++;
+
+    u64 integers = 0;
+    while (c != sample.end() && isDigit(*c)) {
+        c++;
+        integers++;
+    }
+
+    u64 fraction = 0;
+    if (c != sample.end() && *c == '.') {
+        c++;
+        while (c != sample.end() && isDigit(*c)) {
+            c++;
+            fraction++;
+        }
+        if (fraction == 0)
+            return &parseGeneral;
+    }
+
+    if (c != sample.end() || integers + fraction == 0 || integers + fraction > MAX_DIGITS)
+        return &parseGeneral;
+    return FIXED_PARSERS[fraction];
+}
+
+bool NumberParser::parseGeneral( const char *begin, const char *end, f32 &value ) noexcept
+{
+    while (begin < end && isBlank(*begin))
+        begin++;
+    while (end > begin && isBlank(end[-1]))
+        end--;
+
+    // std::from_chars accepts a '-' only
+    if (end - begin > 1 && *begin == '+' && begin[1] != '-' && begin[1] != '+')
+        begin++;
+
+    const auto [stop, error] = std::from_chars(begin, end, value);
+    return error == std::errc() && stop == end;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string_view>
+
+#include "defines.hpp"
+
+
+/**
+ * Parses CSV cells into f32, rounded exactly like std::strtof would.<br>
+ * Data is mostly written with a fixed number of fraction digits, e.g. <code>+0.250000</code>.
+ * detect() picks a parser for that format from a sample cell. The parser reads the digits of a cell as two
+ * 8-byte words, then validates and converts them without branching (SWAR). Cells in another format, with an
+ * exponent, inf or nan, or with more than 15 digits fall back to std::from_chars.
+ */
+class NumberParser {
+public:
+    /**
+     * Parses the whole cell [begin, end). Blanks around the number and a leading '+' are allowed.
+     * @return false if the cell is no number or out of the range of f32
+     */
+    using Parse = bool (*)( const char *begin, const char *end, f32 &value );
+
+    /**
+     * Parser for cells formatted like sample, parseGeneral if the format is not fixed.
+     */
+    static Parse detect( std::string_view sample ) noexcept;
+
+    /**
+     * Any format std::from_chars accepts.
+     */
+    static bool parseGeneral( const char *begin, const char *end, f32 &value ) noexcept;
+};
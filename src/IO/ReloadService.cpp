@@ -0,0 +1,147 @@
+#include "ReloadService.hpp"
+#include "Rendering/Invalidation.hpp"
+#include <filesystem>
+#include <iostream>
+
+
+ReloadService::ReloadService( Scene &scene, GLFWwindow *sharedContext )
+    : m_scene(scene)
+    , m_sharedContext(sharedContext)
+{
+    m_shaderQueue = std::make_unique<TaskQueue>(
+        [this] {
+            glfwMakeContextCurrent(m_sharedContext);
+            Shader::enableParallelCompile();
+        },
+        [] { glfwMakeContextCurrent(nullptr); }
+    );
+    m_dataQueue = std::make_unique<TaskQueue>();
+    m_watcher = std::make_unique<FileWatcher>([this]( const std::string &path ) { onChanged(path); });
+}
+
+ReloadService::~ReloadService()
+{
+    // No more notifications, then let the workers finish before their context goes away
+    m_watcher.reset();
+    m_shaderQueue.reset();
+    m_dataQueue.reset();
+
+    m_pendingShaders.clear();
+}
+
+void ReloadService::watch( Shader &shader )
+{
+    for (const char *extension : { ".vert", ".frag", ".geom", ".comp" }) {
+        const std::string path = shader.getName() + extension;
+
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+            continue;
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_shaders[path] = &shader;
+        }
+        m_watcher->watch(path);
+    }
+}
+
+void ReloadService::watchScene()
+{
+    for (const std::string &file : m_scene.getFiles()) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_dataFiles.insert(file);
+        }
+        m_watcher->watch(file);
+    }
+}
+
+void ReloadService::onChanged( const std::string &path )
+{
+    std::unique_lock lock(m_mutex);
+
+    // A task for this file is still waiting and will read the newest content anyway
+    if (!m_queued.insert(path).second)
+        return;
+
+    if (const auto it = m_shaders.find(path); it != m_shaders.end()) {
+        Shader *const shader = it->second;
+        lock.unlock();
+
+        m_shaderQueue->push([this, path, shader] {
+            {
+                std::lock_guard guard(m_mutex);
+                m_queued.erase(path);
+            }
+
+            auto fresh = std::make_unique<Shader>(shader->getName(), false);
+            if (!fresh->Load()) {
+                std::clog << "[WARNING ][Reload ] Keeping previous program of " << shader->getName() << std::endl;
+                return;
+            }
+
+            // The program must be complete before the render context picks it up
+            glFinish();
+
+            {
+                std::lock_guard guard(m_mutex);
+                m_pendingShaders.emplace_back(shader, std::move(fresh));
+            }
+            Invalidation::requestRedraw();
+        });
+    }
+    else if (m_dataFiles.contains(path)) {
+        lock.unlock();
+
+        m_dataQueue->push([this, path] {
+            {
+                std::lock_guard guard(m_mutex);
+                m_queued.erase(path);
+            }
+
+            Scene::Rebuild rebuild;
+            if (!m_scene.rebuild(path, rebuild)) {
+                std::clog << "[WARNING ][Reload ] Keeping previous meshes of " << path << std::endl;
+                return;
+            }
+
+            {
+                std::lock_guard guard(m_mutex);
+                m_pendingRebuilds.push_back(std::move(rebuild));
+            }
+            Invalidation::requestRedraw();
+        });
+    }
+    else {
+        m_queued.erase(path);
+    }
+}
+
+std::vector<u32> ReloadService::applyPending()
+{
+    std::vector<std::pair<Shader *, std::unique_ptr<Shader>>> shaders;
+    std::vector<Scene::Rebuild> rebuilds;
+    {
+        std::lock_guard lock(m_mutex);
+        shaders.swap(m_pendingShaders);
+        rebuilds.swap(m_pendingRebuilds);
+    }
+
+    // fresh takes the previous program and releases it when going out of scope
+    for (auto &[shader, fresh] : shaders) {
+        *shader = std::move(*fresh);
+        std::cout << "[  INFO  ][Reload ] Reloaded " << shader->getName() << std::endl;
+    }
+
+    std::vector<u32> replaced;
+    for (Scene::Rebuild &rebuild : rebuilds) {
+        for (const auto &[index, mesh] : rebuild.meshes)
+            replaced.push_back(index);
+
+        std::cout << "[  INFO  ][Reload ] Reloaded " << rebuild.file << " (" << rebuild.meshes.size() << " meshes)" << std::endl;
+        m_scene.apply(std::move(rebuild));
+    }
+
+    return replaced;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "3D/Scene.hpp"
+#include "IO/FileWatcher.hpp"
+#include "Rendering/Shader.hpp"
+#include "Threading/TaskQueue.hpp"
+#include <GLFW/glfw3.h>
+
+
+/**
+ * Rebuilds shaders and scene meshes whose source files changed.<br>
+ * Shaders are compiled on a worker thread owning a context shared with the render context,
+ * data files are re-parsed and their meshes rebuilt on a second worker.
+ * Nothing visible changes until applyPending() swaps all finished results in at a frame boundary.
+ * A shader that fails to compile keeps its previous program.
+ * Finished results request a redraw, so an idle render thread wakes up to apply them.
+ */
+class ReloadService {
+public:
+    /**
+     * @param scene meshes to rebuild when their files change
+     * @param sharedContext invisible window sharing objects with the render context, has to outlive the service.
+     *                      It is not destroyed here, as that is only allowed on the main thread.
+     */
+    ReloadService( Scene &scene, GLFWwindow *sharedContext );
+
+    ReloadService( const ReloadService & ) = delete;
+
+    ~ReloadService();
+
+    /**
+     * Watches all existing stage sources of shader, which has to outlive the service.
+     */
+    void watch( Shader &shader );
+
+    /**
+     * Watches all files the scene is built from.
+     */
+    void watchScene();
+
+    /**
+     * Swaps in all finished shaders and meshes. Call on the render thread between frames.
+     * @return indices of the replaced scene meshes
+     */
+    std::vector<u32> applyPending();
+
+private:
+    void onChanged( const std::string &path );
+
+    Scene &m_scene;
+    GLFWwindow *m_sharedContext;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Shader *> m_shaders; // stage source -> shader
+    std::set<std::string> m_dataFiles;
+    std::set<std::string> m_queued; // changed files whose task has not started yet
+
+    std::vector<std::pair<Shader *, std::unique_ptr<Shader>>> m_pendingShaders;
+    std::vector<Scene::Rebuild> m_pendingRebuilds;
+
+    std::unique_ptr<TaskQueue> m_shaderQueue;
+    std::unique_ptr<TaskQueue> m_dataQueue;
+    std::unique_ptr<FileWatcher> m_watcher;
+};
@@ -0,0 +1,36 @@
+#include "RingProducer.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+RingProducer::RingProducer( const std::string &name, const std::vector<std::string> &columns, const u64 capacity )
+    : m_ring(name, columns, capacity)
+    , m_written(0)
+{
+}
+
+void RingProducer::append( const f32 *rows, const u64 count )
+{
+    const u64 capacity = m_ring.getCapacity();
+    const u32 columns = m_ring.getColumnCount();
+
+    // Announced before the slots are overwritten, see SharedRing::read
+    RingHeader &header = m_ring.getHeader();
+    header.writing.store(m_written + count, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Only the last lap stays in the ring
+    const u64 skipped = count - std::min(count, capacity);
+    rows += skipped * columns;
+
+    for (u64 row = m_written + skipped; row < m_written + count;) {
+        const u64 slot = row % capacity;
+        const u64 span = std::min(m_written + count - row, capacity - slot);
+        std::memcpy(m_ring.getRows() + slot * columns, rows, span * columns * sizeof(f32));
+        rows += span * columns;
+        row += span;
+    }
+
+    m_written += count;
+    header.written.store(m_written, std::memory_order_release);
+}
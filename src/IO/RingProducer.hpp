@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+#include "IO/SharedRing.hpp"
+
+
+/**
+ * Producer side of a SharedRing, for simulators streaming rows into a running Plotty.<br>
+ * Part of the PlottyProducer library, which neither needs OpenGL nor the rest of Plotty:
+ * <pre>
+ * RingProducer producer("simulation", { "T", "X", "Y", "Z" }, 1 << 20);
+ * producer.append(rows, count); // count rows of 4 floats
+ * </pre>
+ * Appending never blocks, a reader that falls behind by more than capacity rows loses the oldest ones.
+ */
+class RingProducer {
+public:
+    /**
+     * Creates the ring name, see SharedRing.
+     * @param columns names of the floats of a row, Plotty draws X, Y, Z and colours by T
+     */
+    RingProducer( const std::string &name, const std::vector<std::string> &columns, u64 capacity );
+
+    bool isValid() const noexcept { return m_ring.isValid(); }
+
+    u32 getColumnCount() const noexcept { return m_ring.getColumnCount(); }
+
+    /**
+     * Copies count rows of getColumnCount() floats each into the ring and publishes them at once.
+     */
+    void append( const f32 *rows, u64 count );
+
+    /**
+     * @return rows appended so far
+     */
+    u64 getWritten() const noexcept { return m_written; }
+
+private:
+    SharedRing m_ring;
+    u64 m_written;
+};
@@ -0,0 +1,136 @@
+#include "SceneSnapshot.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+
+static constexpr u64 SNAPSHOT_MAGIC = 0x50414E53594C5450; // "PTLYSNAP"
+static constexpr u32 SNAPSHOT_VERSION = 1;
+
+// Arrays start at multiples of this
+static constexpr u64 SNAPSHOT_ALIGNMENT = 64;
+
+struct SnapshotHeader {
+    u64 magic;
+    u32 version;
+    u32 meshCount;
+};
+
+struct SnapshotEntry {
+    u64 sourceHash;
+    i32 parent;
+    u32 kind;
+    u32 mode;
+    u32 stride;
+    u32 cyclic;
+    u32 padding;
+    u64 vertexCount;
+    u64 sampleCount;
+    u64 vertexOffset; // bytes from the start of the file
+    u64 timeOffset;
+    u64 momentOffset;
+};
+
+
+static u64 align( const u64 offset )
+{
+    return (offset + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+}
+
+
+SceneSnapshot::SceneSnapshot( const std::string &path )
+    : m_file(path)
+    , m_valid(false)
+{
+    if (!m_file.isValid())
+        return;
+
+    SnapshotHeader header{ };
+    if (m_file.getSize() >= sizeof(header))
+        std::copy_n(m_file.getData(), sizeof(header), reinterpret_cast<u8 *>(&header));
+
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION
+        || sizeof(header) + static_cast<u64>(header.meshCount) * sizeof(SnapshotEntry) > m_file.getSize()) {
+        std::clog << "[ ERROR  ][Scene  ] \"" << path << "\" is no scene snapshot of this version" << std::endl;
+        return;
+    }
+
+    const u8 *data = m_file.getData();
+    const auto *entries = reinterpret_cast<const SnapshotEntry *>(data + sizeof(header));
+    const auto fits = [this]( const u64 offset, const u64 bytes ) {
+        return offset % SNAPSHOT_ALIGNMENT == 0 && offset <= m_file.getSize() && bytes <= m_file.getSize() - offset;
+    };
+
+    for (u32 i = 0; i < header.meshCount; i++) {
+        const SnapshotEntry &entry = entries[i];
+        if (entry.stride == 0 || !fits(entry.vertexOffset, entry.vertexCount * entry.stride * sizeof(f32))
+            || !fits(entry.timeOffset, entry.sampleCount * sizeof(f32)) || !fits(entry.momentOffset, entry.sampleCount * 3 * sizeof(f32))) {
+            std::clog << "[ ERROR  ][Scene  ] \"" << path << "\" is truncated" << std::endl;
+            m_meshes.clear();
+            return;
+        }
+
+        m_meshes.push_back({
+            entry.sourceHash, entry.parent, entry.kind, entry.mode, entry.stride, entry.cyclic != 0,
+            reinterpret_cast<const f32 *>(data + entry.vertexOffset), entry.vertexCount,
+            reinterpret_cast<const f32 *>(data + entry.timeOffset),
+            reinterpret_cast<const f32 *>(data + entry.momentOffset), entry.sampleCount
+        });
+    }
+    m_valid = true;
+}
+
+bool SceneSnapshot::write( const std::string &path, const std::vector<SnapshotMesh> &meshes )
+{
+    const SnapshotHeader header{ SNAPSHOT_MAGIC, SNAPSHOT_VERSION, static_cast<u32>(meshes.size()) };
+
+    // All offsets are known up front, so header, table and arrays go out in one sequential pass
+    std::vector<SnapshotEntry> entries;
+    u64 offset = sizeof(header) + meshes.size() * sizeof(SnapshotEntry);
+    for (const SnapshotMesh &mesh : meshes) {
+        SnapshotEntry &entry = entries.emplace_back(SnapshotEntry{
+            mesh.sourceHash, mesh.parent, mesh.kind, mesh.mode, mesh.stride, mesh.cyclic ? 1u : 0u, 0,
+            mesh.vertexCount, mesh.sampleCount, 0, 0, 0
+        });
+        entry.vertexOffset = align(offset);
+        entry.timeOffset = align(entry.vertexOffset + entry.vertexCount * entry.stride * sizeof(f32));
+        entry.momentOffset = align(entry.timeOffset + entry.sampleCount * sizeof(f32));
+        offset = entry.momentOffset + entry.sampleCount * 3 * sizeof(f32);
+    }
+
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::clog << "[ ERROR  ][Scene  ] Cannot write \"" << path << '"' << std::endl;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(SnapshotEntry)));
+        offset = sizeof(header) + entries.size() * sizeof(SnapshotEntry);
+
+        const char zeros[SNAPSHOT_ALIGNMENT]{ };
+        const auto put = [&]( const u64 at, const f32 *values, const u64 count ) {
+            file.write(zeros, static_cast<std::streamsize>(at - offset));
+            file.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(f32)));
+            offset = at + count * sizeof(f32);
+        };
+        for (u64 i = 0; i < meshes.size(); i++) {
+            put(entries[i].vertexOffset, meshes[i].vertices, meshes[i].vertexCount * meshes[i].stride);
+            put(entries[i].timeOffset, meshes[i].times, meshes[i].sampleCount);
+            put(entries[i].momentOffset, meshes[i].moments, meshes[i].sampleCount * 3);
+        }
+
+        if (!file) {
+            std::clog << "[ ERROR  ][Scene  ] Cannot write \"" << path << '"' << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    return !error;
+}
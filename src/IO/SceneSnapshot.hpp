@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+#include "IO/MappedFile.hpp"
+
+
+/**
+ * One built mesh of a SceneSnapshot, pointing into the mapped file or, for writing, into the mesh.
+ */
+struct SnapshotMesh {
+    u64 sourceHash; // of everything the mesh was built from, see Scene::open
+    i32 parent;
+    u32 kind;       // MeshSpec::Kind
+    u32 mode;
+    u32 stride;
+    bool cyclic;
+    const f32 *vertices; // vertexCount vertices of stride floats
+    u64 vertexCount;
+    const f32 *times;    // sampleCount spline parameters, curves only
+    const f32 *moments;  // sampleCount spline moments of three floats, curves only
+    u64 sampleCount;
+};
+
+
+/**
+ * The built meshes of a Scene, so it reopens without reading its CSV files and solving its splines:
+ * <pre>
+ * header | table (one entry per mesh) | vertices, times and moments of mesh 0 | mesh 1 | ...
+ * </pre>
+ * Written front to back in a single pass and read through a memory mapping, the arrays start 64 byte aligned.
+ */
+class SceneSnapshot {
+public:
+    /**
+     * Maps the snapshot at path, invalid if it is missing, truncated or of another version.
+     */
+    explicit SceneSnapshot( const std::string &path );
+
+    SceneSnapshot( const SceneSnapshot & ) = delete;
+
+    bool isValid() const noexcept { return m_valid; }
+
+    u32 getMeshCount() const noexcept { return static_cast<u32>(m_meshes.size()); }
+
+    /**
+     * Mesh index, its arrays stay mapped as long as this snapshot.
+     */
+    const SnapshotMesh &getMesh( const u32 index ) const noexcept { return m_meshes[index]; }
+
+    /**
+     * Writes meshes to path, through a temporary file so a concurrent open never sees half a snapshot.
+     */
+    static bool write( const std::string &path, const std::vector<SnapshotMesh> &meshes );
+
+private:
+    MappedFile m_file;
+    std::vector<SnapshotMesh> m_meshes;
+    bool m_valid;
+};
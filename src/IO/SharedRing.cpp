@@ -0,0 +1,213 @@
+#include "SharedRing.hpp"
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static u64 getDataOffset()
+{
+    return (sizeof(RingHeader) + 63) / 64 * 64;
+}
+
+/**
+ * Whether the segment of size bytes at data holds a complete ring.
+ */
+static bool isComplete( const u8 *data, const u64 size )
+{
+    if (size < sizeof(RingHeader))
+        return false;
+
+    const auto *header = reinterpret_cast<const RingHeader *>(data);
+    return header->magic == RingHeader::MAGIC && header->version == RingHeader::VERSION
+           && header->columns > 0 && header->columns <= RingHeader::MAX_COLUMNS && header->capacity > 0
+           && header->dataOffset >= sizeof(RingHeader) && header->dataOffset % sizeof(f32) == 0
+           && (size - header->dataOffset) / sizeof(f32) / header->columns >= header->capacity;
+}
+
+
+#ifdef _WIN32
+
+SharedRing::SharedRing( const std::string &name )
+    : m_header(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_name(name)
+    , m_owner(false)
+    , m_mapping(nullptr)
+{
+    m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (m_mapping)
+        m_data = static_cast<u8 *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    MEMORY_BASIC_INFORMATION info{ };
+    if (m_data && VirtualQuery(m_data, &info, sizeof(info)))
+        m_size = info.RegionSize;
+
+    if (!isComplete(m_data, m_size)) {
+        std::clog << "[ ERROR  ][Stream ] \"" << name << "\" is no shared ring" << std::endl;
+        return;
+    }
+    m_header = reinterpret_cast<RingHeader *>(m_data);
+}
+
+SharedRing::SharedRing( const std::string &name, const std::vector<std::string> &columns, const u64 capacity )
+    : m_header(nullptr)
+    , m_data(nullptr)
+    , m_size(getDataOffset() + capacity * columns.size() * sizeof(f32))
+    , m_name(name)
+    , m_owner(true)
+    , m_mapping(nullptr)
+{
+    if (columns.empty() || columns.size() > RingHeader::MAX_COLUMNS || capacity == 0) {
+        std::clog << "[ ERROR  ][Stream ] \"" << name << "\" needs 1 to " << RingHeader::MAX_COLUMNS << " columns and a capacity" << std::endl;
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(m_size >> 32),
+                                   static_cast<DWORD>(m_size), name.c_str());
+    if (m_mapping && GetLastError() == ERROR_ALREADY_EXISTS) {
+        std::clog << "[ ERROR  ][Stream ] \"" << name << "\" is still in use" << std::endl;
+        return;
+    }
+    if (m_mapping)
+        m_data = static_cast<u8 *>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (!m_data) {
+        std::clog << "[ ERROR  ][Stream ] Cannot create \"" << name << '"' << std::endl;
+        return;
+    }
+
+    initialize(columns, capacity);
+}
+
+SharedRing::~SharedRing()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+}
+
+#else
+
+/**
+ * POSIX shared memory names start with a single slash.
+ */
+static std::string getPath( const std::string &name )
+{
+    return (!name.empty() && name.front() == '/') ? name : '/' + name;
+}
+
+SharedRing::SharedRing( const std::string &name )
+    : m_header(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_name(name)
+    , m_owner(false)
+{
+    const int segment = shm_open(getPath(name).c_str(), O_RDONLY, 0);
+    struct stat status{ };
+    if (segment < 0 || fstat(segment, &status) != 0) {
+        std::clog << "[ ERROR  ][Stream ] Cannot open \"" << name << '"' << std::endl;
+        if (segment >= 0)
+            close(segment);
+        return;
+    }
+
+    void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, segment, 0);
+    close(segment);
+    if (data == MAP_FAILED) {
+        std::clog << "[ ERROR  ][Stream ] Cannot map \"" << name << '"' << std::endl;
+        return;
+    }
+
+    m_data = static_cast<u8 *>(data);
+    m_size = static_cast<u64>(status.st_size);
+    if (!isComplete(m_data, m_size)) {
+        std::clog << "[ ERROR  ][Stream ] \"" << name << "\" is no shared ring" << std::endl;
+        return;
+    }
+    m_header = reinterpret_cast<RingHeader *>(m_data);
+}
+
+SharedRing::SharedRing( const std::string &name, const std::vector<std::string> &columns, const u64 capacity )
+    : m_header(nullptr)
+    , m_data(nullptr)
+    , m_size(getDataOffset() + capacity * columns.size() * sizeof(f32))
+    , m_name(name)
+    , m_owner(true)
+{
+    if (columns.empty() || columns.size() > RingHeader::MAX_COLUMNS || capacity == 0) {
+        std::clog << "[ ERROR  ][Stream ] \"" << name << "\" needs 1 to " << RingHeader::MAX_COLUMNS << " columns and a capacity" << std::endl;
+        return;
+    }
+
+    // A new segment, readers of a previous one keep theirs
+    const std::string path = getPath(name);
+    shm_unlink(path.c_str());
+    const int segment = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (segment < 0 || ftruncate(segment, static_cast<off_t>(m_size)) != 0) {
+        std::clog << "[ ERROR  ][Stream ] Cannot create \"" << name << '"' << std::endl;
+        if (segment >= 0) {
+            close(segment);
+            shm_unlink(path.c_str());
+        }
+        return;
+    }
+
+    void *data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, segment, 0);
+    close(segment);
+    if (data == MAP_FAILED) {
+        std::clog << "[ ERROR  ][Stream ] Cannot map \"" << name << '"' << std::endl;
+        shm_unlink(path.c_str());
+        return;
+    }
+
+    m_data = static_cast<u8 *>(data);
+    initialize(columns, capacity);
+}
+
+SharedRing::~SharedRing()
+{
+    if (m_data)
+        munmap(m_data, m_size);
+    if (m_owner && m_header)
+        shm_unlink(getPath(m_name).c_str());
+}
+
+#endif
+
+
+void SharedRing::initialize( const std::vector<std::string> &columns, const u64 capacity )
+{
+    auto *header = new (m_data) RingHeader{ };
+    header->version = RingHeader::VERSION;
+    header->columns = static_cast<u32>(columns.size());
+    header->capacity = capacity;
+    header->dataOffset = getDataOffset();
+    for (u32 i = 0; i < columns.size(); i++)
+        std::strncpy(header->names[i], columns[i].c_str(), RingHeader::NAME_LENGTH - 1);
+    header->written.store(0, std::memory_order_relaxed);
+    header->writing.store(0, std::memory_order_relaxed);
+
+    // Last, so readers opening the segment early see an incomplete ring
+    std::atomic_ref(header->magic).store(RingHeader::MAGIC, std::memory_order_release);
+    m_header = header;
+}
+
+i32 SharedRing::findColumn( const std::string &name ) const noexcept
+{
+    for (u32 i = 0; i < m_header->columns; i++) {
+        if (std::strncmp(m_header->names[i], name.c_str(), RingHeader::NAME_LENGTH) == 0)
+            return static_cast<i32>(i);
+    }
+    return -1;
+}
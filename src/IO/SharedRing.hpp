@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+
+/**
+ * Start of a shared memory ring, followed by capacity rows of columns floats at dataOffset.<br>
+ * The producer announces rows by advancing writing, writes row r into slot r % capacity and then
+ * publishes them by advancing written. It never waits for readers, a reader more than capacity rows
+ * behind loses the oldest ones, and rows read while writing was more than capacity ahead of them may be torn.
+ */
+struct RingHeader {
+    static constexpr u64 MAGIC = 0x474E4952594C5450; // "PTLYRING"
+    static constexpr u32 VERSION = 1;
+    static constexpr u32 MAX_COLUMNS = 16;
+    static constexpr u32 NAME_LENGTH = 16;
+
+    u64 magic;
+    u32 version;
+    u32 columns;    // floats per row
+    u64 capacity;   // rows
+    u64 dataOffset; // bytes from the start of the segment to slot 0
+    char names[MAX_COLUMNS][NAME_LENGTH]; // column names, NUL-terminated
+
+    // Rows published so far, stored with release after their data
+    alignas(64) std::atomic<u64> written;
+
+    // Rows being written, stored before their data, ahead of written during an append
+    std::atomic<u64> writing;
+};
+
+static_assert(std::atomic<u64>::is_always_lock_free, "The cursor is shared between processes");
+
+
+/**
+ * Rows [begin, end) of a SharedRing.
+ */
+struct RowRange {
+    u64 begin;
+    u64 end;
+};
+
+
+/**
+ * A named shared memory segment holding a ring of binary rows, see RingHeader.<br>
+ * Written by a single producer process through RingProducer and read by Plotty without any parsing,
+ * e.g. by a RingStream, which uploads the new rows straight from the mapping.
+ */
+class SharedRing {
+public:
+    /**
+     * Maps the existing segment name read-only, for readers.
+     */
+    explicit SharedRing( const std::string &name );
+
+    /**
+     * Creates the segment name, replacing an existing one, for the producer.
+     * Removes it again when destroyed, readers keep their mapping.
+     * @param columns names of the floats of a row, at most RingHeader::MAX_COLUMNS
+     * @param capacity rows kept
+     */
+    SharedRing( const std::string &name, const std::vector<std::string> &columns, u64 capacity );
+
+    SharedRing( const SharedRing & ) = delete;
+
+    ~SharedRing();
+
+    bool isValid() const noexcept { return nullptr != m_header; }
+
+    const std::string &getName() const noexcept { return m_name; }
+
+    const RingHeader &getHeader() const noexcept { return *m_header; }
+    RingHeader &getHeader() noexcept { return *m_header; }
+    u32 getColumnCount() const noexcept { return m_header->columns; }
+    u64 getCapacity() const noexcept { return m_header->capacity; }
+
+    /**
+     * @return index of column name, -1 if there is none
+     */
+    i32 findColumn( const std::string &name ) const noexcept;
+
+    /**
+     * Slot 0, capacity rows of getColumnCount() floats each.
+     */
+    const f32 *getRows() const noexcept { return reinterpret_cast<const f32 *>(m_data + m_header->dataOffset); }
+    f32 *getRows() noexcept { return reinterpret_cast<f32 *>(m_data + m_header->dataOffset); }
+
+    /**
+     * Hands the rows published since row next to read(row, rows, count), as up to two spans split at the wrap,
+     * oldest first, and advances next past them. Rows overwritten before they could be read are skipped.
+     * @return rows read now or before that are still intact, older ones may have been overwritten meanwhile
+     */
+    template<typename F>
+    RowRange read( u64 &next, F &&read ) const;
+
+private:
+    void initialize( const std::vector<std::string> &columns, u64 capacity );
+
+    RingHeader *m_header;
+    u8 *m_data;
+    u64 m_size;
+    std::string m_name;
+    bool m_owner;
+
+#ifdef _WIN32
+    void *m_mapping;
+#endif
+};
+
+
+template<typename F>
+RowRange SharedRing::read( u64 &next, F &&read ) const
+{
+    const u64 capacity = m_header->capacity;
+    const u64 end = m_header->written.load(std::memory_order_acquire);
+
+    for (u64 row = std::max(next, end - std::min(end, capacity)); row < end;) {
+        const u64 slot = row % capacity;
+        const u64 count = std::min(end - row, capacity - slot);
+        read(row, getRows() + slot * m_header->columns, count);
+        row += count;
+    }
+    next = end;
+
+    // Everything the producer started to write meanwhile may have overwritten the rows one lap before
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const u64 writing = m_header->writing.load(std::memory_order_relaxed);
+    return { std::min(end, writing - std::min(writing, capacity)), end };
+}
@@ -0,0 +1,189 @@
+#include "TileFile.hpp"
+#include "IO/CSVReader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+
+static constexpr u32 TILE_MAGIC = 0x4C544C50; // "PLTL"
+static constexpr u32 TILE_VERSION = 1;
+
+// Tiles start at multiples of this, so advising one tile never touches its neighbours
+static constexpr u64 TILE_ALIGNMENT = 1u << 16;
+
+struct TileHeader {
+    u32 magic;
+    u32 version;
+    u32 stride;
+    u32 tileVertices;
+    u64 vertexCount;
+    u64 tileCount;
+};
+
+
+static u64 countTiles( const u64 vertexCount, const u32 tileVertices )
+{
+    // Tiles share their last vertex with the next one
+    return (vertexCount <= 1) ? vertexCount : (vertexCount - 2) / tileVertices + 1;
+}
+
+
+TileFile::TileFile( const std::string &path )
+    : m_file(path)
+    , m_tiles(nullptr)
+    , m_stride(0)
+    , m_tileVertices(0)
+    , m_vertexCount(0)
+    , m_tileCount(0)
+{
+    if (!m_file.isValid())
+        return;
+
+    TileHeader header{ };
+    if (m_file.getSize() >= sizeof(header))
+        std::copy_n(m_file.getData(), sizeof(header), reinterpret_cast<u8 *>(&header));
+
+    const bool headerOk = header.magic == TILE_MAGIC && header.version == TILE_VERSION && header.stride >= 3 && header.tileVertices > 0
+                          && header.tileCount == countTiles(header.vertexCount, header.tileVertices)
+                          && sizeof(header) + header.tileCount * sizeof(TileInfo) <= m_file.getSize();
+    if (!headerOk) {
+        std::clog << "[ ERROR  ][Tiles  ] \"" << path << "\" is not a tile file" << std::endl;
+        return;
+    }
+
+    const auto *tiles = reinterpret_cast<const TileInfo *>(m_file.getData() + sizeof(header));
+    for (u64 t = 0; t < header.tileCount; t++) {
+        if (tiles[t].offset + static_cast<u64>(tiles[t].vertexCount) * header.stride * sizeof(f32) > m_file.getSize()) {
+            std::clog << "[ ERROR  ][Tiles  ] \"" << path << "\" is truncated" << std::endl;
+            return;
+        }
+    }
+
+    m_tiles = tiles;
+    m_stride = header.stride;
+    m_tileVertices = header.tileVertices;
+    m_vertexCount = header.vertexCount;
+    m_tileCount = header.tileCount;
+}
+
+u64 TileFile::getMaxTileSpan() const noexcept
+{
+    return (getMaxTileSize() + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+}
+
+void TileFile::advise( const u64 tile, const MappedFile::Advice advice ) const
+{
+    const TileInfo &info = m_tiles[tile];
+    const u64 end = info.offset + static_cast<u64>(info.vertexCount) * m_stride * sizeof(f32);
+    m_file.advise(info.offset, (end + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT - info.offset, advice);
+}
+
+bool TileFile::write( const std::string &path, const u64 vertexCount, const u32 stride, const Source &source, const u32 tileVertices )
+{
+    const TileHeader header{ TILE_MAGIC, TILE_VERSION, stride, tileVertices, vertexCount, countTiles(vertexCount, tileVertices) };
+    std::vector<TileInfo> tiles(header.tileCount);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::clog << "[ ERROR  ][Tiles  ] Cannot write \"" << path << '"' << std::endl;
+        return false;
+    }
+
+    // The table is written last, once all bounds are known
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(tiles.data()), static_cast<std::streamsize>(tiles.size() * sizeof(TileInfo)));
+
+    std::vector<f32> vertices((static_cast<size_t>(tileVertices) + 1) * stride);
+    u64 offset = sizeof(header) + tiles.size() * sizeof(TileInfo);
+
+    for (u64 t = 0; t < header.tileCount; t++) {
+        const u64 first = t * tileVertices;
+        const u64 count = std::min<u64>(tileVertices + 1, vertexCount - first);
+        if (!source(first, count, vertices.data())) {
+            std::clog << "[ ERROR  ][Tiles  ] Cannot read vertices " << first << " to " << first + count << std::endl;
+            return false;
+        }
+
+        TileInfo &tile = tiles[t];
+        std::fill_n(tile.min, 3, std::numeric_limits<f32>::infinity());
+        std::fill_n(tile.max, 3, -std::numeric_limits<f32>::infinity());
+        for (u64 v = 0; v < count; v++) {
+            for (u32 c = 0; c < 3; c++) {
+                tile.min[c] = std::min(tile.min[c], vertices[v * stride + c]);
+                tile.max[c] = std::max(tile.max[c], vertices[v * stride + c]);
+            }
+        }
+
+        const u64 aligned = (offset + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+        const std::vector<char> padding(aligned - offset, 0);
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        tile.vertexCount = static_cast<u32>(count);
+        tile.offset = aligned;
+        file.write(reinterpret_cast<const char *>(vertices.data()), static_cast<std::streamsize>(count * stride * sizeof(f32)));
+        offset = aligned + count * stride * sizeof(f32);
+    }
+
+    file.seekp(sizeof(header));
+    file.write(reinterpret_cast<const char *>(tiles.data()), static_cast<std::streamsize>(tiles.size() * sizeof(TileInfo)));
+
+    if (!file) {
+        std::clog << "[ ERROR  ][Tiles  ] Cannot write \"" << path << '"' << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TileFile::convert( const std::string &input, const std::string &output, const u32 tileVertices )
+{
+    constexpr u32 STRIDE = 4;
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    bool written = false;
+    u64 vertexCount = 0;
+
+    if (std::filesystem::path(input).extension() == ".csv") {
+        CSVFile csv(input);
+        if (!csv.read(','))
+            return false;
+
+        // Same columns and defaults as the meshes of a Scene
+        const std::vector<f32> *columns[STRIDE] = { csv.getValues("X"), csv.getValues("Y"), csv.getValues("Z"), csv.getValues("T") };
+        vertexCount = csv.getRowCount();
+        written = write(output, vertexCount, STRIDE, [&columns]( const u64 first, const u64 count, f32 *destination ) {
+            for (u64 r = first; r < first + count; r++) {
+                for (u32 c = 0; c < STRIDE; c++)
+                    *destination++ = columns[c] ? (*columns[c])[r] : (c == 3 ? static_cast<f32>(r) : 0.0f);
+            }
+            return true;
+        }, tileVertices);
+    }
+    else {
+        std::ifstream file(input, std::ios::binary);
+        std::error_code error;
+        const u64 size = std::filesystem::file_size(input, error);
+        if (!file || error) {
+            std::clog << "[ ERROR  ][Tiles  ] Cannot read \"" << input << '"' << std::endl;
+            return false;
+        }
+
+        vertexCount = size / (STRIDE * sizeof(f32));
+        written = write(output, vertexCount, STRIDE, [&file]( const u64 first, const u64 count, f32 *destination ) {
+            file.seekg(static_cast<std::streamoff>(first * STRIDE * sizeof(f32)));
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(destination), static_cast<std::streamsize>(count * STRIDE * sizeof(f32))));
+        }, tileVertices);
+    }
+
+    if (written) {
+        const f64 seconds = std::chrono::duration<f64>(clock::now() - start).count();
+        std::cout << "[  INFO  ][Tiles  ] " << vertexCount << " vertices of \"" << input << "\" written to \"" << output << "\" in "
+                  << countTiles(vertexCount, tileVertices) << " tiles, " << seconds << " s" << std::endl;
+    }
+    return written;
+}
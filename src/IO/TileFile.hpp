@@ -0,0 +1,92 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "defines.hpp"
+#include "IO/MappedFile.hpp"
+
+
+/**
+ * Bounds and location of one tile, stored in the tile table of a TileFile.
+ */
+struct TileInfo {
+    f32 min[3];
+    f32 max[3];
+    u32 vertexCount;
+    u32 padding;
+    u64 offset; // bytes from the start of the file
+};
+
+
+/**
+ * A line strip too large for RAM, split into tiles of a fixed number of vertices on disk:
+ * <pre>
+ * header | tile table (TileInfo per tile) | tile 0 | tile 1 | ...
+ * </pre>
+ * Each tile starts page aligned and repeats the first vertex of the next one,
+ * so tiles are drawn as independent strips without gaps.
+ * The file is memory mapped, only the tiles accessed are read from disk.
+ */
+class TileFile {
+public:
+    // Vertices per tile of converted files, 1 MiB tiles at 4 floats per vertex
+    static constexpr u32 DEFAULT_TILE_VERTICES = 1u << 16;
+
+    /**
+     * Reads vertices [first, first + count) of stride floats each into destination.
+     */
+    using Source = std::function<bool( u64 first, u64 count, f32 *destination )>;
+
+    explicit TileFile( const std::string &path );
+
+    bool isValid() const noexcept { return nullptr != m_tiles; }
+
+    u32 getStride() const noexcept { return m_stride; }
+    u64 getVertexCount() const noexcept { return m_vertexCount; }
+    u64 getTileCount() const noexcept { return m_tileCount; }
+
+    /**
+     * @return bytes of the largest tile
+     */
+    u64 getMaxTileSize() const noexcept { return (static_cast<u64>(m_tileVertices) + 1) * m_stride * sizeof(f32); }
+
+    /**
+     * @return bytes of the file mapped for the largest tile, including the padding to the next one
+     */
+    u64 getMaxTileSpan() const noexcept;
+
+    const TileInfo &getInfo( const u64 tile ) const noexcept { return m_tiles[tile]; }
+
+    /**
+     * Mapped vertices of tile, pages not resident yet are read from disk on access.
+     */
+    const f32 *getVertices( const u64 tile ) const noexcept { return reinterpret_cast<const f32 *>(m_file.getData() + m_tiles[tile].offset); }
+
+    const MappedFile &getMapping() const noexcept { return m_file; }
+
+    /**
+     * Advises the pages of tile, including the padding up to the next one, which the system may map along with it.
+     */
+    void advise( u64 tile, MappedFile::Advice advice ) const;
+
+    /**
+     * Writes vertexCount vertices from source into a new tile file, one tile at a time.
+     */
+    static bool write( const std::string &path, u64 vertexCount, u32 stride, const Source &source,
+                       u32 tileVertices = DEFAULT_TILE_VERTICES );
+
+    /**
+     * Converts a CSV file (columns X, Y, Z, T) or a raw file of interleaved (x, y, z, t) floats.
+     */
+    static bool convert( const std::string &input, const std::string &output, u32 tileVertices = DEFAULT_TILE_VERTICES );
+
+private:
+    MappedFile m_file;
+    const TileInfo *m_tiles;
+    u32 m_stride;
+    u32 m_tileVertices;
+    u64 m_vertexCount;
+    u64 m_tileCount;
+};
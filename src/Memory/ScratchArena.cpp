@@ -0,0 +1,75 @@
+#include "ScratchArena.hpp"
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+
+/**
+ * Heap memory the arena needed beyond its buffer, counted to size the buffer of the next load.
+ */
+class OverflowResource : public std::pmr::memory_resource {
+public:
+    u64 allocated{ 0 };
+
+private:
+    void *do_allocate( const size_t bytes, const size_t alignment ) override
+    {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate( void *p, const size_t bytes, const size_t alignment ) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal( const std::pmr::memory_resource &other ) const noexcept override { return this == &other; }
+};
+
+struct ThreadArena {
+    std::unique_ptr<std::byte[]> buffer;
+    u64 capacity{ 0 };
+    u32 depth{ 0 };
+    OverflowResource overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> resource;
+};
+
+static thread_local ThreadArena t_arena;
+
+
+ScratchArena::ScratchArena()
+{
+    if (t_arena.depth++ > 0)
+        return;
+
+    t_arena.overflow.allocated = 0;
+    if (t_arena.capacity > 0)
+        t_arena.resource.emplace(t_arena.buffer.get(), t_arena.capacity, &t_arena.overflow);
+    else
+        t_arena.resource.emplace(&t_arena.overflow);
+}
+
+ScratchArena::~ScratchArena()
+{
+    if (--t_arena.depth > 0)
+        return;
+
+    // Returns the overflow, which the buffer absorbs next time
+    t_arena.resource.reset();
+
+    const u64 needed = std::min(t_arena.capacity + t_arena.overflow.allocated, MAX_RETAINED);
+    if (needed != t_arena.capacity) {
+        t_arena.buffer = std::make_unique_for_overwrite<std::byte[]>(needed);
+        t_arena.capacity = needed;
+    }
+}
+
+std::pmr::memory_resource *ScratchArena::getResource() const noexcept
+{
+    return &*t_arena.resource;
+}
+
+u64 ScratchArena::getCapacity() noexcept
+{
+    return t_arena.capacity;
+}
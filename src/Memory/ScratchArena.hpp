@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory_resource>
+
+#include "defines.hpp"
+
+
+/**
+ * Scratch memory of the calling thread for the temporaries of one load, e.g. a line of a CSV file
+ * or the matrices of a spline.<br>
+ * Allocations only bump a pointer and are released all at once when the outermost ScratchArena
+ * of the thread is destroyed. Nested arenas share its memory. The memory is kept for the next load
+ * and grown to the largest one so far, so repeated loads of similar files allocate nothing.
+ */
+class ScratchArena {
+public:
+    // Memory kept beyond this is returned after each load
+    static constexpr u64 MAX_RETAINED = 64ull << 20;
+
+    ScratchArena();
+
+    ScratchArena( const ScratchArena & ) = delete;
+
+    ~ScratchArena();
+
+    std::pmr::memory_resource *getResource() const noexcept;
+
+    /**
+     * @return bytes kept by the calling thread for the next load
+     */
+    static u64 getCapacity() noexcept;
+};
@@ -0,0 +1,128 @@
+#include "AxisGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+// Minimal distance of neighbouring lines on screen
+static constexpr f32 MIN_LINE_PIXELS = 32.0f;
+
+// Upper limit of lines per axis, when zoomed in far
+static constexpr f32 MAX_LINES = 256.0f;
+
+// Part of the data size added around the data
+static constexpr f32 MARGIN = 0.25f;
+
+
+/**
+ * @return smallest 1, 2 or 5 times a power of ten not below minimum
+ */
+static f32 roundUpToStep( const f32 minimum )
+{
+    const f32 decade = std::pow(10.0f, std::floor(std::log10(minimum)));
+    for (const f32 factor : { 1.0f, 2.0f, 5.0f, 10.0f }) {
+        if (decade * factor >= minimum)
+            return decade * factor;
+    }
+    return decade * 10.0f;
+}
+
+
+AxisGrid::AxisGrid()
+    : m_vaoID(0)
+    , m_center(0.0f)
+    , m_halfSize(1.0f)
+    , m_shaderVersion(0)
+{
+    // Core profiles draw nothing without a vertex array, even one without attributes
+    glCreateVertexArrays(1, &m_vaoID);
+}
+
+AxisGrid::~AxisGrid()
+{
+    glDeleteVertexArrays(1, &m_vaoID);
+}
+
+void AxisGrid::setBounds( const Bounds &bounds )
+{
+    if (bounds.isEmpty()) {
+        m_center = glm::fvec3(0.0f);
+        m_halfSize = glm::fvec3(1.0f);
+        return;
+    }
+
+    const glm::fvec3 extent = bounds.max - bounds.min;
+    f32 size = std::max({ extent.x, extent.y, extent.z });
+    if (!(size > 0.0f)) {
+        // A single point, sized relative to its magnitude
+        const glm::fvec3 magnitude = glm::abs(bounds.min);
+        size = std::max({ magnitude.x, magnitude.y, magnitude.z, 1.0f }) * 0.1f;
+    }
+
+    // Flat axes, e.g. z of a 2D plot, span the largest extent as well
+    m_center = (bounds.min + bounds.max) * 0.5f;
+    m_halfSize = glm::max(extent, glm::fvec3(size)) * (0.5f + MARGIN);
+}
+
+f32 AxisGrid::getSpacing( const FrameData &frame ) const
+{
+    const f32 size = std::max({ m_halfSize.x, m_halfSize.y, m_halfSize.z }) * 2.0f;
+    f32 spacing = size / MAX_LINES;
+
+    // Pixels per unit along each axis at the center
+    const glm::fvec4 center = frame.MVP * glm::fvec4(m_center, 1.0f);
+    if (center.w > 0.0f) {
+        f32 pixelsPerUnit = 0.0f;
+        for (u32 axis = 0; axis < 3; axis++) {
+            glm::fvec3 end = m_center;
+            end[axis] += size;
+            const glm::fvec4 projected = frame.MVP * glm::fvec4(end, 1.0f);
+            if (projected.w <= 0.0f)
+                continue;
+
+            const glm::fvec2 ndc = glm::fvec2(projected) / projected.w - glm::fvec2(center) / center.w;
+            const glm::fvec2 pixels = ndc * glm::fvec2(frame.viewport) * 0.5f;
+            pixelsPerUnit = std::max(pixelsPerUnit, std::sqrt(pixels.x * pixels.x + pixels.y * pixels.y) / size);
+        }
+        if (pixelsPerUnit > 0.0f)
+            spacing = std::max(spacing, MIN_LINE_PIXELS / pixelsPerUnit);
+    }
+
+    return roundUpToStep(spacing);
+}
+
+void AxisGrid::resolve( Shader &shader )
+{
+    if (shader.getVersion() == m_shaderVersion)
+        return;
+
+    m_shaderVersion = shader.getVersion();
+    m_minUniform = shader.getUniform<glm::fvec3>("gridMin");
+    m_maxUniform = shader.getUniform<glm::fvec3>("gridMax");
+    m_planesUniform = shader.getUniform<glm::fvec3>("gridPlanes");
+    m_spacingUniform = shader.getUniform<f32>("gridSpacing");
+    m_centerUniform = shader.getUniform<glm::fvec3>("gridCenter");
+    m_fadeUniform = shader.getUniform<f32>("gridFade");
+}
+
+void AxisGrid::render( Shader &shader, const FrameData &frame )
+{
+    resolve(shader);
+
+    const f32 spacing = getSpacing(frame);
+
+    // Snapped outwards to whole lines
+    const glm::fvec3 low = glm::floor((m_center - m_halfSize) / spacing) * spacing;
+    const glm::fvec3 high = glm::ceil((m_center + m_halfSize) / spacing) * spacing;
+    const glm::fvec3 planes = glm::clamp(glm::fvec3(0.0f), low, high);
+    const glm::fvec3 lines = glm::round((high - low) / spacing) + 1.0f;
+
+    shader.set(m_minUniform, low);
+    shader.set(m_maxUniform, high);
+    shader.set(m_planesUniform, planes);
+    shader.set(m_spacingUniform, spacing);
+    shader.set(m_centerUniform, m_center);
+    shader.set(m_fadeUniform, std::max({ m_halfSize.x, m_halfSize.y, m_halfSize.z }) * 0.25f);
+
+    glBindVertexArray(m_vaoID);
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(4.0f * (lines.x + lines.y + lines.z)));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glad.h>
+#include <glm/glm.hpp>
+#include "defines.hpp"
+#include "3D/Bounds.hpp"
+#include "Rendering/FrameUniforms.hpp"
+#include "Rendering/Shader.hpp"
+
+
+/**
+ * Reference grid in the three axis planes around the data, generated in the vertex shader
+ * from gl_VertexID (res/shader/cartesianSystem), so it has no vertex buffer.<br>
+ * The spacing is a 1-2-5 step chosen per frame, so lines stay a few pixels apart when zooming,
+ * for data ranges of any magnitude.
+ */
+class AxisGrid {
+public:
+    AxisGrid();
+
+    AxisGrid( const AxisGrid & ) = delete;
+
+    ~AxisGrid();
+
+    /**
+     * Covers bounds with some margin, the unit cube if they are empty.
+     */
+    void setBounds( const Bounds &bounds );
+
+    /**
+     * Draws the grid with shader bound.
+     */
+    void render( Shader &shader, const FrameData &frame );
+
+private:
+    /**
+     * @return spacing at which the lines are at least MIN_LINE_PIXELS apart at the center
+     */
+    f32 getSpacing( const FrameData &frame ) const;
+
+    /**
+     * Resolves the uniforms of res/shader/cartesianSystem again if shader has a new program.
+     */
+    void resolve( Shader &shader );
+
+    GLuint m_vaoID;
+    glm::fvec3 m_center;
+    glm::fvec3 m_halfSize;
+
+    u64 m_shaderVersion; // of the program the uniforms below belong to
+    Uniform<glm::fvec3> m_minUniform;
+    Uniform<glm::fvec3> m_maxUniform;
+    Uniform<glm::fvec3> m_planesUniform;
+    Uniform<f32> m_spacingUniform;
+    Uniform<glm::fvec3> m_centerUniform;
+    Uniform<f32> m_fadeUniform;
+};
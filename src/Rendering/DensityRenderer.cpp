@@ -0,0 +1,138 @@
+#include "DensityRenderer.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+
+DensityRenderer::DensityRenderer()
+    : m_framebufferID(0)
+    , m_countTexture(0)
+    , m_maximumBuffer(0)
+    , m_vaoID(0)
+    , m_previousFramebuffer(0)
+    , m_subpixelBits(0)
+    , m_width(0)
+    , m_height(0)
+{
+    glCreateBuffers(1, &m_maximumBuffer);
+    glNamedBufferStorage(m_maximumBuffer, sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glCreateVertexArrays(1, &m_vaoID);
+    glGetIntegerv(GL_SUBPIXEL_BITS, &m_subpixelBits);
+}
+
+DensityRenderer::~DensityRenderer()
+{
+    glDeleteFramebuffers(1, &m_framebufferID);
+    glDeleteTextures(1, &m_countTexture);
+    glDeleteBuffers(1, &m_maximumBuffer);
+    glDeleteVertexArrays(1, &m_vaoID);
+}
+
+void DensityRenderer::resize( const int width, const int height )
+{
+    if (width == m_width && height == m_height)
+        return;
+
+    glDeleteFramebuffers(1, &m_framebufferID);
+    glDeleteTextures(1, &m_countTexture);
+    m_width = width;
+    m_height = height;
+
+    // Exact counts up to 2^24 points per pixel
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_countTexture);
+    glTextureStorage2D(m_countTexture, 1, GL_R32F, m_width, m_height);
+    glTextureParameteri(m_countTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_countTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glCreateFramebuffers(1, &m_framebufferID);
+    glNamedFramebufferTexture(m_framebufferID, GL_COLOR_ATTACHMENT0, m_countTexture, 0);
+}
+
+void DensityRenderer::begin( const int width, const int height )
+{
+    resize(width, height);
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferID);
+
+    constexpr f32 zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearNamedFramebufferfv(m_framebufferID, GL_COLOR, 0, zero);
+
+    // Every point counts, however many fall onto the same pixel at whatever depth
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+}
+
+void DensityRenderer::end()
+{
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(m_previousFramebuffer));
+}
+
+void DensityRenderer::upload( const std::vector<u32> &counts, const int width, const int height )
+{
+    resize(width, height);
+
+    std::vector<f32> values(counts.begin(), counts.end());
+    glTextureSubImage2D(m_countTexture, 0, 0, 0, m_width, m_height, GL_RED, GL_FLOAT, values.data());
+}
+
+void DensityRenderer::resolve( Shader &maximum, Shader &resolve )
+{
+    if (m_width == 0 || m_height == 0)
+        return;
+
+    constexpr u32 zero = 0;
+    glNamedBufferSubData(m_maximumBuffer, 0, sizeof(zero), &zero);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DENSITY_MAXIMUM_BINDING, m_maximumBuffer);
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    maximum.Bind();
+    glBindImageTexture(0, m_countTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+    glDispatchCompute((m_width + 15) / 16, (m_height + 15) / 16, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    resolve.Bind();
+    glBindTextureUnit(0, m_countTexture);
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(m_vaoID);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void DensityRenderer::readCounts( std::vector<f32> &counts ) const
+{
+    counts.resize(static_cast<size_t>(m_width) * m_height);
+    glGetTextureImage(m_countTexture, 0, GL_RED, GL_FLOAT, static_cast<GLsizei>(counts.size() * sizeof(f32)), counts.data());
+}
+
+void DensityRenderer::bin( const f32 *vertices, const u64 count, const u32 stride, const glm::fmat4 &MVP,
+                           const int width, const int height, std::vector<u32> &counts ) const
+{
+    counts.resize(static_cast<size_t>(width) * height, 0);
+    u32 *const bins = counts.data();
+    const f32 subpixels = std::ldexp(1.0f, m_subpixelBits);
+
+    // Few points per pixel collide, relaxed atomic increments are cheaper than a histogram per thread
+    ThreadPool::getShared().parallelFor(0, count, 1 << 16, [=]( const u64 first, const u64 last ) {
+        for (u64 i = first; i < last; i++) {
+            const f32 *v = vertices + i * stride;
+            const glm::fvec4 clip = MVP * glm::fvec4(v[0], v[1], v[2], 1.0f);
+            if (!(std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && std::abs(clip.z) <= clip.w))
+                continue;
+
+            // Window coordinates on the subpixel grid, a point of size 1 covers the pixel whose centre lies in its
+            // square, which excludes the right and top edges, so a point right on a pixel border counts to the lower one
+            const f32 x = std::round((clip.x / clip.w * 0.5f + 0.5f) * static_cast<f32>(width) * subpixels) / subpixels;
+            const f32 y = std::round((clip.y / clip.w * 0.5f + 0.5f) * static_cast<f32>(height) * subpixels) / subpixels;
+            const int px = std::min(static_cast<int>(std::ceil(x)) - 1, width - 1);
+            const int py = std::min(static_cast<int>(std::ceil(y)) - 1, height - 1);
+            if (px < 0 || py < 0)
+                continue;
+            std::atomic_ref(bins[static_cast<size_t>(py) * width + px]).fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+#include <glad.h>
+#include <glm/glm.hpp>
+#include "defines.hpp"
+#include "Rendering/Shader.hpp"
+
+
+// Shader storage binding of the largest count, found by res/shader/densityMax
+constexpr GLuint DENSITY_MAXIMUM_BINDING = 3;
+
+/**
+ * Draws point clouds as a density image instead of overdrawing them into a blob.<br>
+ * The points are counted per pixel in an R32F target, either splatted additively on the GPU between begin() and end(),
+ * or binned on the CPU by bin() and uploaded. resolve() finds the largest count and maps log(1 + count) relative
+ * to it onto a colormap, so both ways give the same image.
+ */
+class DensityRenderer {
+public:
+    DensityRenderer();
+
+    DensityRenderer( const DensityRenderer & ) = delete;
+
+    ~DensityRenderer();
+
+    /**
+     * Clears the counts to width x height and binds them as target with additive blending.
+     * Draw the points with a program with the layout of res/shader/density bound, then call end().
+     */
+    void begin( int width, int height );
+
+    /**
+     * Restores the target bound before begin().
+     */
+    void end();
+
+    /**
+     * Replaces the counts by width x height counts binned on the CPU, row by row from the bottom like the GPU ones.
+     */
+    void upload( const std::vector<u32> &counts, int width, int height );
+
+    /**
+     * Draws the counts over the bound target, pixels without points stay untouched.
+     * @param maximum program of res/shader/densityMax
+     * @param resolve program of res/shader/densityResolve
+     */
+    void resolve( Shader &maximum, Shader &resolve );
+
+    /**
+     * Reads the counts back, width x height from the bottom row.
+     */
+    void readCounts( std::vector<f32> &counts ) const;
+
+    int getWidth() const noexcept { return m_width; }
+    int getHeight() const noexcept { return m_height; }
+
+    /**
+     * Counts the vertices into the pixels of a width x height viewport they are rasterized to as points,
+     * in parallel, adding to counts. Vertices outside the view volume are clipped, and the window coordinates are
+     * snapped to the subpixel grid of the rasterizer, like on the GPU.
+     * @param vertices count vertices of stride floats, the first three cartesian
+     */
+    void bin( const f32 *vertices, u64 count, u32 stride, const glm::fmat4 &MVP, int width, int height, std::vector<u32> &counts ) const;
+
+private:
+    void resize( int width, int height );
+
+    GLuint m_framebufferID;
+    GLuint m_countTexture;
+    GLuint m_maximumBuffer;
+    GLuint m_vaoID; // without attributes, the resolve triangle is built from gl_VertexID
+    GLint m_previousFramebuffer;
+    GLint m_subpixelBits;
+    int m_width;
+    int m_height;
+};
@@ -0,0 +1,64 @@
+#include "EnvelopeRenderer.hpp"
+#include <algorithm>
+
+
+EnvelopeRenderer::EnvelopeRenderer()
+    : m_vaoID(0)
+    , m_bufferID(0)
+    , m_capacity(0)
+{
+    glCreateVertexArrays(1, &m_vaoID);
+
+    // (t, value, 0) and normalized t, like the stride 4 meshes
+    glVertexArrayAttribFormat(m_vaoID, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(m_vaoID, 0, 0);
+    glEnableVertexArrayAttrib(m_vaoID, 0);
+
+    glVertexArrayAttribFormat(m_vaoID, 1, 1, GL_FLOAT, GL_FALSE, 3 * sizeof(f32));
+    glVertexArrayAttribBinding(m_vaoID, 1, 0);
+    glEnableVertexArrayAttrib(m_vaoID, 1);
+}
+
+EnvelopeRenderer::~EnvelopeRenderer()
+{
+    glDeleteVertexArrays(1, &m_vaoID);
+    glDeleteBuffers(1, &m_bufferID);
+}
+
+void EnvelopeRenderer::reserve( const GLsizeiptr size )
+{
+    if (size <= m_capacity)
+        return;
+
+    m_capacity = std::max(size, 2 * m_capacity);
+    glDeleteBuffers(1, &m_bufferID);
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, m_capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glVertexArrayVertexBuffer(m_vaoID, 0, m_bufferID, 0, 4 * sizeof(f32));
+}
+
+void EnvelopeRenderer::render( const std::vector<std::shared_ptr<const SignalEnvelope>> &envelopes, const FrameData &frame )
+{
+    m_vertices.clear();
+    m_firsts.clear();
+    m_counts.clear();
+
+    for (const auto &envelope : envelopes) {
+        const auto first = static_cast<GLint>(m_vertices.size() / 4);
+        const u32 count = envelope->writeEnvelope(frame.MVP, frame.viewport, m_vertices);
+        if (count > 1) {
+            m_firsts.push_back(first);
+            m_counts.push_back(static_cast<GLsizei>(count));
+        }
+    }
+
+    if (m_counts.empty())
+        return;
+
+    const auto size = static_cast<GLsizeiptr>(m_vertices.size() * sizeof(f32));
+    reserve(size);
+    glNamedBufferSubData(m_bufferID, 0, size, m_vertices.data());
+
+    glBindVertexArray(m_vaoID);
+    glMultiDrawArrays(GL_LINE_STRIP, m_firsts.data(), m_counts.data(), static_cast<GLsizei>(m_counts.size()));
+}
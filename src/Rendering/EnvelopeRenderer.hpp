@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glad.h>
+#include "defines.hpp"
+#include "3D/Signal/SignalEnvelope.hpp"
+#include "Rendering/FrameUniforms.hpp"
+
+
+/**
+ * Draws SignalEnvelopes, whose vertices depend on the view and are rewritten every frame
+ * into one streaming buffer. Expects a program with the layout of res/shader/streamed bound.
+ */
+class EnvelopeRenderer {
+public:
+    EnvelopeRenderer();
+
+    EnvelopeRenderer( const EnvelopeRenderer & ) = delete;
+
+    ~EnvelopeRenderer();
+
+    void render( const std::vector<std::shared_ptr<const SignalEnvelope>> &envelopes, const FrameData &frame );
+
+    /**
+     * @return vertices drawn by the last render()
+     */
+    u64 getVertexCount() const noexcept { return m_vertices.size() / 4; }
+
+private:
+    void reserve( GLsizeiptr size );
+
+    std::vector<f32> m_vertices;
+    std::vector<GLint> m_firsts;
+    std::vector<GLsizei> m_counts;
+
+    GLuint m_vaoID;
+    GLuint m_bufferID;
+    GLsizeiptr m_capacity;
+};
@@ -0,0 +1,87 @@
+#include "FrameReadback.hpp"
+#include <cstring>
+
+
+FrameReadback::FrameReadback( const int width, const int height, Callback callback )
+    : m_next(0)
+    , m_pending(0)
+    , m_width(width)
+    , m_height(height)
+    , m_callback(std::move(callback))
+{
+    const auto size = static_cast<GLsizeiptr>(width) * height * 4;
+    constexpr GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Persistently mapped, so delivering a frame is a single memcpy without map/unmap round trips
+    for (Slot &slot : m_slots) {
+        glCreateBuffers(1, &slot.bufferID);
+        glNamedBufferStorage(slot.bufferID, size, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+        slot.mapped = static_cast<const u8 *>(glMapNamedBufferRange(slot.bufferID, 0, size, flags));
+    }
+}
+
+FrameReadback::~FrameReadback()
+{
+    finish();
+
+    for (Slot &slot : m_slots) {
+        glUnmapNamedBuffer(slot.bufferID);
+        glDeleteBuffers(1, &slot.bufferID);
+    }
+}
+
+void FrameReadback::read( const GLuint framebuffer, const u64 index )
+{
+    // Deliver whatever is done already, in order
+    while (m_pending > 0 && collect(false));
+
+    // Only stalls if the GPU is more than SLOTS frames behind
+    if (m_pending == SLOTS)
+        collect(true);
+
+    Slot &slot = m_slots[m_next];
+    slot.index = index;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.bufferID);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    m_next = (m_next + 1) % SLOTS;
+    m_pending++;
+}
+
+void FrameReadback::finish()
+{
+    while (m_pending > 0)
+        collect(true);
+}
+
+bool FrameReadback::collect( const bool wait )
+{
+    Slot &slot = m_slots[(m_next + SLOTS - m_pending) % SLOTS];
+
+    if (wait) {
+        GLenum status;
+        do {
+            status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000ull);
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    else if (const GLenum status = glClientWaitSync(slot.fence, 0, 0); status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    m_pending--;
+
+    FramePixels pixels{ slot.index, m_width, m_height, std::vector<u8>(slot.mapped, slot.mapped + static_cast<size_t>(m_width) * m_height * 4) };
+    m_callback(std::move(pixels));
+    return true;
+}
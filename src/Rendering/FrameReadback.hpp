@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <glad.h>
+#include "defines.hpp"
+
+
+/**
+ * Pixels of one rendered frame, RGBA8 with the bottom row first as delivered by OpenGL.
+ */
+struct FramePixels {
+    u64 index;
+    int width;
+    int height;
+    std::vector<u8> rgba;
+};
+
+
+/**
+ * Asynchronous framebuffer readback through a ring of pixel pack buffers.<br>
+ * read() only issues the copy into the next buffer and a fence, the pixels are handed
+ * to the callback once the GPU is done, at the latest when the buffer is needed again
+ * SLOTS frames later. Frames are delivered in order.
+ */
+class FrameReadback {
+public:
+    static constexpr u32 SLOTS = 3;
+
+    using Callback = std::function<void( FramePixels && )>;
+
+    FrameReadback( int width, int height, Callback callback );
+
+    FrameReadback( const FrameReadback & ) = delete;
+
+    ~FrameReadback();
+
+    /**
+     * Queues a readback of the first color attachment of framebuffer.
+     * @param index passed on with the pixels
+     */
+    void read( GLuint framebuffer, u64 index );
+
+    /**
+     * Waits for all queued readbacks and delivers them.
+     */
+    void finish();
+
+private:
+    struct Slot {
+        GLuint bufferID{ 0 };
+        const u8 *mapped{ nullptr };
+        GLsync fence{ nullptr };
+        u64 index{ 0 };
+    };
+
+    /**
+     * Delivers the oldest pending slot.
+     * @param wait block until the GPU finished it
+     * @return false if it is not done yet
+     */
+    bool collect( bool wait );
+
+    Slot m_slots[SLOTS];
+    u32 m_next;    // slot the next read goes to
+    u32 m_pending; // slots in flight, the oldest is m_next - m_pending
+
+    int m_width;
+    int m_height;
+    Callback m_callback;
+};
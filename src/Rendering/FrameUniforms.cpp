@@ -0,0 +1,21 @@
+#include "FrameUniforms.hpp"
+
+
+FrameUniforms::FrameUniforms()
+    : m_bufferID(0)
+{
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, sizeof(FrameData), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, m_bufferID);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    glDeleteBuffers(1, &m_bufferID);
+}
+
+void FrameUniforms::update( const FrameData &frame ) const
+{
+    glNamedBufferSubData(m_bufferID, 0, sizeof(FrameData), &frame);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, m_bufferID);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad.h>
+#include <glm/glm.hpp>
+#include "defines.hpp"
+
+
+// Uniform block binding of the per-frame data, shared by all programs
+constexpr GLuint FRAME_UNIFORM_BINDING = 0;
+
+/**
+ * Per-frame data, laid out as std140 to match the Frame uniform block:
+ * <pre>
+ * layout (std140, binding=0) uniform Frame {
+ *     mat4 MVP;
+ *     vec4 viewport; // (width, height, 1/width, 1/height)
+ *     float time;
+ * };
+ * </pre>
+ */
+struct FrameData {
+    glm::fmat4 MVP{ 1.0f };
+    glm::fvec4 viewport{ 0.0f };
+    f32 time{ 0.0f };
+    f32 padding[3]{ };
+};
+
+
+/**
+ * Uniform buffer holding FrameData.<br>
+ * update() writes the whole block and binds it once for all programs.
+ */
+class FrameUniforms {
+public:
+    FrameUniforms();
+
+    FrameUniforms( const FrameUniforms & ) = delete;
+
+    ~FrameUniforms();
+
+    void update( const FrameData &frame ) const;
+
+    constexpr GLuint getID() const noexcept { return m_bufferID; }
+
+private:
+    GLuint m_bufferID;
+};
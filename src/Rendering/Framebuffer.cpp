@@ -0,0 +1,83 @@
+#include "Framebuffer.hpp"
+
+
+Framebuffer::Framebuffer( const int width, const int height, const int samples )
+    : m_framebufferID(0)
+    , m_colorTexture(0)
+    , m_depthBuffer(0)
+    , m_multisampleID(0)
+    , m_multisampleColor(0)
+    , m_multisampleDepth(0)
+    , m_width(width)
+    , m_height(height)
+    , m_samples(samples)
+{
+    create();
+}
+
+Framebuffer::~Framebuffer()
+{
+    destroy();
+}
+
+void Framebuffer::resize( const int width, const int height )
+{
+    if (width == m_width && height == m_height)
+        return;
+
+    destroy();
+    m_width = width;
+    m_height = height;
+    create();
+}
+
+void Framebuffer::create()
+{
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_colorTexture);
+    glTextureStorage2D(m_colorTexture, 1, GL_RGBA8, m_width, m_height);
+    glTextureParameteri(m_colorTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_colorTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glCreateRenderbuffers(1, &m_depthBuffer);
+    glNamedRenderbufferStorage(m_depthBuffer, GL_DEPTH_COMPONENT24, m_width, m_height);
+
+    glCreateFramebuffers(1, &m_framebufferID);
+    glNamedFramebufferTexture(m_framebufferID, GL_COLOR_ATTACHMENT0, m_colorTexture, 0);
+    glNamedFramebufferRenderbuffer(m_framebufferID, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+    if (m_samples > 0) {
+        glCreateRenderbuffers(1, &m_multisampleColor);
+        glNamedRenderbufferStorageMultisample(m_multisampleColor, m_samples, GL_RGBA8, m_width, m_height);
+        glCreateRenderbuffers(1, &m_multisampleDepth);
+        glNamedRenderbufferStorageMultisample(m_multisampleDepth, m_samples, GL_DEPTH_COMPONENT24, m_width, m_height);
+
+        glCreateFramebuffers(1, &m_multisampleID);
+        glNamedFramebufferRenderbuffer(m_multisampleID, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_multisampleColor);
+        glNamedFramebufferRenderbuffer(m_multisampleID, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_multisampleDepth);
+    }
+}
+
+void Framebuffer::destroy()
+{
+    glDeleteFramebuffers(1, &m_framebufferID);
+    glDeleteTextures(1, &m_colorTexture);
+    glDeleteRenderbuffers(1, &m_depthBuffer);
+    glDeleteFramebuffers(1, &m_multisampleID);
+    glDeleteRenderbuffers(1, &m_multisampleColor);
+    glDeleteRenderbuffers(1, &m_multisampleDepth);
+
+    m_framebufferID = m_colorTexture = m_depthBuffer = 0;
+    m_multisampleID = m_multisampleColor = m_multisampleDepth = 0;
+}
+
+void Framebuffer::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, getDrawID());
+    glViewport(0, 0, m_width, m_height);
+}
+
+void Framebuffer::resolve() const
+{
+    if (m_samples > 0)
+        glBlitNamedFramebuffer(m_multisampleID, m_framebufferID, 0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glad.h>
+#include "defines.hpp"
+
+
+/**
+ * Offscreen render target with RGBA8 color and a depth buffer.<br>
+ * With samples > 0 rendering goes to a multisampled framebuffer and resolve()
+ * blits it into a single sampled one, which is what getReadID() returns.
+ */
+class Framebuffer {
+public:
+    Framebuffer( int width, int height, int samples = 0 );
+
+    Framebuffer( const Framebuffer & ) = delete;
+
+    ~Framebuffer();
+
+    void resize( int width, int height );
+
+    /**
+     * Binds the framebuffer for drawing and sets the viewport.
+     */
+    void bind() const;
+
+    void resolve() const;
+
+    constexpr GLuint getDrawID() const noexcept { return m_samples > 0 ? m_multisampleID : m_framebufferID; }
+    constexpr GLuint getReadID() const noexcept { return m_framebufferID; }
+    constexpr GLuint getColorTexture() const noexcept { return m_colorTexture; }
+
+    constexpr int getWidth() const noexcept { return m_width; }
+    constexpr int getHeight() const noexcept { return m_height; }
+
+private:
+    void create();
+    void destroy();
+
+    GLuint m_framebufferID;
+    GLuint m_colorTexture;
+    GLuint m_depthBuffer;
+
+    GLuint m_multisampleID;
+    GLuint m_multisampleColor;
+    GLuint m_multisampleDepth;
+
+    int m_width;
+    int m_height;
+    int m_samples;
+};
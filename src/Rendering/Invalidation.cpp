@@ -0,0 +1,23 @@
+#include "Invalidation.hpp"
+
+
+std::atomic<u64> Invalidation::s_content{ 0 };
+std::atomic<u64> Invalidation::s_requests{ 0 };
+
+
+void Invalidation::invalidate() noexcept
+{
+    s_content.fetch_add(1, std::memory_order_acq_rel);
+    requestRedraw();
+}
+
+void Invalidation::requestRedraw() noexcept
+{
+    s_requests.fetch_add(1, std::memory_order_acq_rel);
+    s_requests.notify_all();
+}
+
+void Invalidation::waitForRedraw( const u64 seen ) noexcept
+{
+    s_requests.wait(seen, std::memory_order_acquire);
+}
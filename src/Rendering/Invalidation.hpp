@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include "defines.hpp"
+
+
+/**
+ * Change tracking for redrawing on demand.<br>
+ * invalidate() marks the scene content as changed (mesh uploads, shader programs),
+ * requestRedraw() only asks for a new frame (camera, input, finished reloads).
+ * Both wake a render thread blocked in waitForRedraw(). Safe to call from any thread.
+ */
+class Invalidation {
+public:
+    static void invalidate() noexcept;
+
+    static void requestRedraw() noexcept;
+
+    static u64 getContentVersion() noexcept { return s_content.load(std::memory_order_acquire); }
+
+    static u64 getRedrawRequests() noexcept { return s_requests.load(std::memory_order_acquire); }
+
+    /**
+     * Blocks until a redraw was requested after seen was read from getRedrawRequests().
+     */
+    static void waitForRedraw( u64 seen ) noexcept;
+
+private:
+    static std::atomic<u64> s_content;
+    static std::atomic<u64> s_requests;
+};
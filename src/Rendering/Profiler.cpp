@@ -0,0 +1,292 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+static f64 steadySeconds()
+{
+    using namespace std::chrono;
+    return duration<f64>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void writeJSONString( std::ostream &out, const char *str )
+{
+    out << '"';
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            out << '\\';
+        out << *str;
+    }
+    out << '"';
+}
+
+
+Profiler::Profiler( const u32 frameCapacity )
+    : m_frames(std::max(frameCapacity, 1u))
+    , m_frameIndex(0)
+    , m_inFrame(false)
+    , m_hasTimer(GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query)
+    , m_origin(steadySeconds())
+{
+    for (ProfileFrame &frame : m_frames) {
+        frame.index = ~0ull;
+        frame.duration = -1.0;
+    }
+}
+
+Profiler::~Profiler()
+{
+    for (GpuFrame &gpuFrame : m_gpuFrames) {
+        if (!gpuFrame.queries.empty())
+            glDeleteQueries(static_cast<GLsizei>(gpuFrame.queries.size()), gpuFrame.queries.data());
+    }
+}
+
+f64 Profiler::now() const
+{
+    return steadySeconds() - m_origin;
+}
+
+void Profiler::beginFrame()
+{
+    ProfileFrame &frame = currentFrame();
+    frame.index = m_frameIndex;
+    frame.start = now();
+    frame.duration = -1.0;
+    frame.events.clear();
+
+    m_cpuStack.clear();
+    m_gpuStack.clear();
+    m_inFrame = true;
+
+    if (!m_hasTimer)
+        return;
+
+    // Pick up whatever the GPU already finished, then make room for this frame
+    for (GpuFrame &gpuFrame : m_gpuFrames)
+        collect(gpuFrame, false);
+
+    GpuFrame &gpuFrame = m_gpuFrames[m_frameIndex % GPU_LATENCY];
+    collect(gpuFrame, true);
+
+    gpuFrame.frameIndex = m_frameIndex;
+    gpuFrame.cpuStart = frame.start;
+    glGetInteger64v(GL_TIMESTAMP, &gpuFrame.gpuStart);
+    gpuFrame.usedQueries = 0;
+    gpuFrame.scopes.clear();
+}
+
+void Profiler::endFrame()
+{
+    if (!m_inFrame)
+        return;
+
+    // Close scopes left open by an early return
+    while (!m_cpuStack.empty())
+        endScope();
+    while (!m_gpuStack.empty())
+        endGpuScope();
+
+    ProfileFrame &frame = currentFrame();
+    frame.duration = now() - frame.start;
+
+    if (m_hasTimer) {
+        GpuFrame &gpuFrame = m_gpuFrames[m_frameIndex % GPU_LATENCY];
+        gpuFrame.pending = !gpuFrame.scopes.empty();
+    }
+
+    m_inFrame = false;
+    m_frameIndex++;
+}
+
+void Profiler::beginScope( const char *name )
+{
+    if (!m_inFrame)
+        return;
+
+    std::vector<ProfileEvent> &events = currentFrame().events;
+    m_cpuStack.push_back(static_cast<u32>(events.size()));
+    events.push_back({ name, now(), 0.0, static_cast<u16>(m_cpuStack.size() - 1), false });
+}
+
+void Profiler::endScope()
+{
+    if (!m_inFrame || m_cpuStack.empty())
+        return;
+
+    ProfileEvent &event = currentFrame().events[m_cpuStack.back()];
+    event.duration = now() - event.start;
+    m_cpuStack.pop_back();
+}
+
+void Profiler::beginGpuScope( const char *name )
+{
+    if (!m_inFrame || !m_hasTimer)
+        return;
+
+    GpuFrame &gpuFrame = m_gpuFrames[m_frameIndex % GPU_LATENCY];
+    const u32 beginQuery = issueTimestamp(gpuFrame);
+    m_gpuStack.push_back(static_cast<u32>(gpuFrame.scopes.size()));
+    gpuFrame.scopes.push_back({ name, static_cast<u16>(m_gpuStack.size() - 1), beginQuery, beginQuery });
+}
+
+void Profiler::endGpuScope()
+{
+    if (!m_inFrame || !m_hasTimer || m_gpuStack.empty())
+        return;
+
+    GpuFrame &gpuFrame = m_gpuFrames[m_frameIndex % GPU_LATENCY];
+    gpuFrame.scopes[m_gpuStack.back()].endQuery = issueTimestamp(gpuFrame);
+    m_gpuStack.pop_back();
+}
+
+u32 Profiler::issueTimestamp( GpuFrame &gpuFrame )
+{
+    if (gpuFrame.usedQueries == gpuFrame.queries.size()) {
+        GLuint query = 0;
+        glCreateQueries(GL_TIMESTAMP, 1, &query);
+        gpuFrame.queries.push_back(query);
+    }
+
+    glQueryCounter(gpuFrame.queries[gpuFrame.usedQueries], GL_TIMESTAMP);
+    return gpuFrame.usedQueries++;
+}
+
+void Profiler::collect( GpuFrame &gpuFrame, const bool wait )
+{
+    if (!gpuFrame.pending)
+        return;
+
+    // Queries complete in order, the last one tells about all others
+    if (!wait) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(gpuFrame.queries[gpuFrame.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE)
+            return;
+    }
+    gpuFrame.pending = false;
+
+    ProfileFrame &frame = m_frames[gpuFrame.frameIndex % m_frames.size()];
+    if (frame.index != gpuFrame.frameIndex)
+        return; // already overwritten by a newer frame
+
+    for (const GpuScope &scope : gpuFrame.scopes) {
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(gpuFrame.queries[scope.beginQuery], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(gpuFrame.queries[scope.endQuery], GL_QUERY_RESULT, &end);
+
+        const f64 start = gpuFrame.cpuStart + static_cast<f64>(static_cast<GLint64>(begin) - gpuFrame.gpuStart) * 1e-9;
+        frame.events.push_back({ scope.name, start, static_cast<f64>(end - begin) * 1e-9, scope.depth, true });
+    }
+}
+
+std::vector<const ProfileFrame *> Profiler::getFrames() const
+{
+    std::vector<const ProfileFrame *> frames;
+    const u64 count = std::min<u64>(m_frameIndex, m_frames.size());
+    frames.reserve(count);
+
+    for (u64 i = m_frameIndex - count; i < m_frameIndex; i++) {
+        const ProfileFrame &frame = m_frames[i % m_frames.size()];
+        if (frame.index == i && frame.duration >= 0.0)
+            frames.push_back(&frame);
+    }
+
+    return frames;
+}
+
+ProfileStatistics Profiler::computeStatistics( std::vector<f64> &values )
+{
+    if (values.empty())
+        return { };
+
+    std::sort(values.begin(), values.end());
+
+    const auto percentile = [&values]( const f64 p ) {
+        return values[static_cast<size_t>(p * static_cast<f64>(values.size() - 1) + 0.5)];
+    };
+
+    f64 sum = 0.0;
+    for (const f64 value : values)
+        sum += value;
+
+    return { sum / static_cast<f64>(values.size()), percentile(0.5), percentile(0.95), percentile(0.99), values.back() };
+}
+
+ProfileStatistics Profiler::getFrameStatistics() const
+{
+    std::vector<f64> durations;
+    for (const ProfileFrame *frame : getFrames())
+        durations.push_back(frame->duration);
+
+    return computeStatistics(durations);
+}
+
+std::vector<ScopeStatistics> Profiler::getScopeStatistics() const
+{
+    struct Accumulator {
+        const char *name;
+        bool gpu;
+        f64 frameSum;
+        std::vector<f64> perFrame;
+    };
+    std::vector<Accumulator> scopes;
+
+    for (const ProfileFrame *frame : getFrames()) {
+        for (const ProfileEvent &event : frame->events) {
+            auto it = std::find_if(scopes.begin(), scopes.end(), [&event]( const Accumulator &scope ) {
+                return scope.gpu == event.gpu && std::strcmp(scope.name, event.name) == 0;
+            });
+            if (it == scopes.end())
+                it = scopes.insert(scopes.end(), { event.name, event.gpu, 0.0, { } });
+            it->frameSum += event.duration;
+        }
+
+        for (Accumulator &scope : scopes) {
+            if (scope.frameSum > 0.0)
+                scope.perFrame.push_back(scope.frameSum);
+            scope.frameSum = 0.0;
+        }
+    }
+
+    std::vector<ScopeStatistics> statistics;
+    for (Accumulator &scope : scopes)
+        statistics.push_back({ scope.name, scope.gpu, computeStatistics(scope.perFrame) });
+
+    return statistics;
+}
+
+bool Profiler::exportChromeTrace( const std::string &filename ) const
+{
+    std::ofstream out(filename);
+    if (!out) {
+        std::clog << "[WARNING ][Profile] Cannot write \"" << filename << '"' << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << R"({"name":"thread_name","ph":"M","pid":1,"tid":1,"args":{"name":"CPU"}},)" << '\n';
+    out << R"({"name":"thread_name","ph":"M","pid":1,"tid":2,"args":{"name":"GPU"}})";
+
+    for (const ProfileFrame *frame : getFrames()) {
+        out << ",\n" << R"({"name":"Frame","cat":"frame","ph":"X","pid":1,"tid":1,"ts":)" << frame->start * 1e6
+            << ",\"dur\":" << frame->duration * 1e6 << ",\"args\":{\"index\":" << frame->index << "}}";
+
+        for (const ProfileEvent &event : frame->events) {
+            out << ",\n{\"name\":";
+            writeJSONString(out, event.name);
+            out << ",\"cat\":\"" << (event.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (event.gpu ? 2 : 1)
+                << ",\"ts\":" << event.start * 1e6 << ",\"dur\":" << event.duration * 1e6 << '}';
+        }
+    }
+
+    out << "\n]}\n";
+
+    std::cout << "[  INFO  ][Profile] Wrote trace " << filename << std::endl;
+    return static_cast<bool>(out);
+}
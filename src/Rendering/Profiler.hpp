@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <glad.h>
+#include "defines.hpp"
+
+
+struct ProfileEvent {
+    const char *name; // static storage, e.g. a string literal
+    f64 start;        // seconds since profiler creation
+    f64 duration;     // seconds
+    u16 depth;
+    bool gpu;
+};
+
+struct ProfileFrame {
+    u64 index;
+    f64 start;
+    f64 duration;
+    std::vector<ProfileEvent> events;
+};
+
+struct ProfileStatistics {
+    f64 mean;
+    f64 p50;
+    f64 p95;
+    f64 p99;
+    f64 max;
+};
+
+struct ScopeStatistics {
+    const char *name;
+    bool gpu;
+    ProfileStatistics time; // summed per frame
+};
+
+
+/**
+ * Frame-time instrumentation with nested CPU scopes and GPU timestamp queries.<br>
+ * The last frameCapacity frames are kept in a ring buffer. GPU results are collected
+ * GPU_LATENCY frames later without stalling and merged into the frame that issued them,
+ * mapped to the CPU timeline through a timestamp taken at the start of that frame.
+ * Scopes do not allocate once the ring buffer is warmed up.
+ */
+class Profiler {
+public:
+    static constexpr u32 GPU_LATENCY = 4;
+
+    explicit Profiler( u32 frameCapacity = 240 );
+
+    Profiler( const Profiler & ) = delete;
+
+    ~Profiler();
+
+    void beginFrame();
+    void endFrame();
+
+    void beginScope( const char *name );
+    void endScope();
+
+    void beginGpuScope( const char *name );
+    void endGpuScope();
+
+    /**
+     * Frames in chronological order, only the ones which are complete.
+     */
+    std::vector<const ProfileFrame *> getFrames() const;
+
+    ProfileStatistics getFrameStatistics() const;
+
+    std::vector<ScopeStatistics> getScopeStatistics() const;
+
+    /**
+     * Writes all recorded frames in the Chrome trace-event format (chrome://tracing, Perfetto).
+     */
+    bool exportChromeTrace( const std::string &filename ) const;
+
+    static ProfileStatistics computeStatistics( std::vector<f64> &values );
+
+private:
+    struct GpuScope {
+        const char *name;
+        u16 depth;
+        u32 beginQuery;
+        u32 endQuery;
+    };
+
+    struct GpuFrame {
+        u64 frameIndex{ 0 };
+        f64 cpuStart{ 0.0 };
+        GLint64 gpuStart{ 0 };
+        u32 usedQueries{ 0 };
+        std::vector<GLuint> queries;
+        std::vector<GpuScope> scopes;
+        bool pending{ false };
+    };
+
+    f64 now() const;
+
+    ProfileFrame &currentFrame() { return m_frames[m_frameIndex % m_frames.size()]; }
+
+    u32 issueTimestamp( GpuFrame &gpuFrame );
+
+    void collect( GpuFrame &gpuFrame, bool wait );
+
+    std::vector<ProfileFrame> m_frames;
+    u64 m_frameIndex;
+    bool m_inFrame;
+
+    std::vector<u32> m_cpuStack; // indices into events of the current frame
+    std::vector<u32> m_gpuStack; // indices into scopes of the current GPU frame
+
+    std::array<GpuFrame, GPU_LATENCY> m_gpuFrames;
+    bool m_hasTimer;
+
+    f64 m_origin;
+};
+
+
+class ProfileScope {
+public:
+    ProfileScope( Profiler &profiler, const char *name )
+        : m_profiler(profiler)
+    {
+        m_profiler.beginScope(name);
+    }
+
+    ~ProfileScope() { m_profiler.endScope(); }
+
+private:
+    Profiler &m_profiler;
+};
+
+
+class GpuProfileScope {
+public:
+    GpuProfileScope( Profiler &profiler, const char *name )
+        : m_profiler(profiler)
+    {
+        m_profiler.beginGpuScope(name);
+    }
+
+    ~GpuProfileScope() { m_profiler.endGpuScope(); }
+
+private:
+    Profiler &m_profiler;
+};
@@ -0,0 +1,133 @@
+#include "RingStream.hpp"
+#include "Rendering/Invalidation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+
+// How often the watcher checks the cursor of the ring, about once per update tick
+static constexpr auto WATCH_INTERVAL = std::chrono::milliseconds(4);
+
+
+RingStream::RingStream( std::unique_ptr<const SharedRing> ring )
+    : m_ring(std::move(ring))
+    , m_positionColumn(0)
+    , m_positionSize(0)
+    , m_rowSize(m_ring->getColumnCount() * sizeof(f32))
+    , m_vaoID(0)
+    , m_bufferID(0)
+    , m_next(0)
+    , m_first(0)
+    , m_received(0)
+    , m_lost(0)
+    , m_watching(true)
+{
+    const i32 x = m_ring->findColumn("X");
+    const i32 y = m_ring->findColumn("Y");
+    const i32 z = m_ring->findColumn("Z");
+    const i32 t = m_ring->findColumn("T");
+
+    if (x < 0 || (y >= 0 && y != x + 1) || (z >= 0 && (y < 0 || z != y + 1))) {
+        std::clog << "[ ERROR  ][Stream ] \"" << m_ring->getName() << "\" needs a column X, followed by Y and Z if present" << std::endl;
+        return;
+    }
+    m_positionColumn = static_cast<u32>(x);
+    m_positionSize = (z >= 0) ? 3 : (y >= 0) ? 2 : 1;
+
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, static_cast<GLsizeiptr>((m_ring->getCapacity() + 1) * m_rowSize), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    // Reads the rows in the layout of the ring, the missing components of P are 0
+    glCreateVertexArrays(1, &m_vaoID);
+    glVertexArrayVertexBuffer(m_vaoID, 0, m_bufferID, 0, static_cast<GLsizei>(m_rowSize));
+    glVertexArrayAttribFormat(m_vaoID, 0, static_cast<GLint>(m_positionSize), GL_FLOAT, GL_FALSE, m_positionColumn * sizeof(f32));
+    glVertexArrayAttribBinding(m_vaoID, 0, 0);
+    glEnableVertexArrayAttrib(m_vaoID, 0);
+    if (t >= 0) {
+        glVertexArrayAttribFormat(m_vaoID, 1, 1, GL_FLOAT, GL_FALSE, static_cast<GLuint>(t) * sizeof(f32));
+        glVertexArrayAttribBinding(m_vaoID, 1, 0);
+        glEnableVertexArrayAttrib(m_vaoID, 1);
+    }
+
+    std::cout << "[  INFO  ][Stream ] \"" << m_ring->getName() << "\": " << m_ring->getColumnCount() << " columns, "
+              << m_ring->getCapacity() << " rows, " << m_ring->getHeader().written.load() << " written so far" << std::endl;
+
+    m_watcher = std::thread(&RingStream::watch, this);
+}
+
+RingStream::~RingStream()
+{
+    m_watching = false;
+    if (m_watcher.joinable())
+        m_watcher.join();
+
+    glDeleteVertexArrays(1, &m_vaoID);
+    glDeleteBuffers(1, &m_bufferID);
+}
+
+void RingStream::watch()
+{
+    u64 seen = 0;
+    while (m_watching) {
+        const u64 written = m_ring->getHeader().written.load(std::memory_order_acquire);
+        if (written != seen) {
+            seen = written;
+            Invalidation::invalidate();
+        }
+        std::this_thread::sleep_for(WATCH_INTERVAL);
+    }
+}
+
+bool RingStream::update()
+{
+    if (!isValid())
+        return false;
+
+    const u64 capacity = m_ring->getCapacity();
+    const u32 columns = m_ring->getColumnCount();
+    const Bounds previous = m_bounds;
+
+    u64 expected = m_next;
+    const RowRange intact = m_ring->read(m_next, [&]( const u64 row, const f32 *rows, const u64 count ) {
+        m_lost += row - expected;
+        m_received += count;
+        expected = row + count;
+
+        const u64 slot = row % capacity;
+        glNamedBufferSubData(m_bufferID, static_cast<GLintptr>(slot * m_rowSize), static_cast<GLsizeiptr>(count * m_rowSize), rows);
+        if (slot == 0)
+            glNamedBufferSubData(m_bufferID, static_cast<GLintptr>(capacity * m_rowSize), static_cast<GLsizeiptr>(m_rowSize), rows);
+
+        for (u64 r = 0; r < count; r++) {
+            const f32 *position = rows + r * columns + m_positionColumn;
+            glm::fvec3 point(0.0f);
+            for (u32 i = 0; i < m_positionSize; i++)
+                point[i] = position[i];
+            m_bounds.extend(point);
+        }
+    });
+    m_first = std::max(m_first, intact.begin);
+
+    return m_bounds.min != previous.min || m_bounds.max != previous.max;
+}
+
+void RingStream::render() const
+{
+    const u64 count = m_next - m_first;
+    if (!isValid() || count < 2)
+        return;
+
+    const u64 capacity = m_ring->getCapacity();
+    const auto first = static_cast<GLint>(m_first % capacity);
+
+    glBindVertexArray(m_vaoID);
+    if (m_first % capacity + count <= capacity) {
+        glDrawArrays(GL_LINE_STRIP, first, static_cast<GLsizei>(count));
+        return;
+    }
+
+    // Up to the repeated slot 0 at the end, then on from slot 0
+    const GLint firsts[2] = { first, 0 };
+    const GLsizei counts[2] = { static_cast<GLsizei>(capacity + 1 - first), static_cast<GLsizei>(m_next % capacity) };
+    glMultiDrawArrays(GL_LINE_STRIP, firsts, counts, 2);
+}
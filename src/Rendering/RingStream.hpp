@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <glad.h>
+#include "defines.hpp"
+#include "3D/Bounds.hpp"
+#include "IO/SharedRing.hpp"
+
+
+/**
+ * Draws the newest rows of a SharedRing, up to its capacity, as a line strip.<br>
+ * New rows are uploaded straight from the shared mapping into a GPU ring of the same layout, nothing is
+ * parsed or converted on the way. X, Y and Z are found by name and have to be adjacent in that order,
+ * missing trailing ones are 0. T colours the strip like the normalized time of curves.
+ * A thread watches the cursor of the ring and invalidates the view whenever rows arrive.
+ */
+class RingStream {
+public:
+    explicit RingStream( std::unique_ptr<const SharedRing> ring );
+
+    RingStream( const RingStream & ) = delete;
+
+    ~RingStream();
+
+    /**
+     * @return false if the ring has no usable X, Y, Z columns
+     */
+    bool isValid() const noexcept { return 0 != m_vaoID; }
+
+    /**
+     * Uploads the rows published since the last update. Call once per frame before render().
+     * @return true if the bounds grew
+     */
+    bool update();
+
+    /**
+     * Expects a program with the layout of res/shader/streamed bound.
+     */
+    void render() const;
+
+    /**
+     * Bounds of all rows received so far.
+     */
+    const Bounds &getBounds() const noexcept { return m_bounds; }
+
+    u64 getReceived() const noexcept { return m_received; }
+
+    /**
+     * @return rows the producer overwrote before they were read
+     */
+    u64 getLost() const noexcept { return m_lost; }
+
+private:
+    void watch();
+
+    std::unique_ptr<const SharedRing> m_ring;
+    u32 m_positionColumn;
+    u32 m_positionSize; // adjacent columns of X, Y, Z
+    u64 m_rowSize;      // bytes
+
+    GLuint m_vaoID;
+    GLuint m_bufferID; // capacity + 1 rows, the last repeats slot 0 so wrapped strips stay connected
+
+    u64 m_next;           // first row not read yet
+    u64 m_first;          // drawn rows [m_first, m_next)
+    u64 m_received;
+    u64 m_lost;
+    Bounds m_bounds;
+
+    std::atomic<bool> m_watching;
+    std::thread m_watcher;
+};
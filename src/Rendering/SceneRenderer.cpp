@@ -0,0 +1,383 @@
+#include "SceneRenderer.hpp"
+#include "Invalidation.hpp"
+#include <algorithm>
+#include <numeric>
+
+
+struct DrawArraysIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint first;
+    GLuint baseInstance;
+};
+
+
+static bool isLineMode( const GLenum mode )
+{
+    return mode == GL_LINES || mode == GL_LINE_STRIP || mode == GL_LINE_LOOP;
+}
+
+/**
+ * Segments of a line mesh of length vertices, drawn as one quad each.
+ */
+static u32 getSegmentCount( const GLenum mode, const u32 length )
+{
+    switch (mode) {
+        case GL_LINES: return length / 2;
+        case GL_LINE_STRIP: return length > 0 ? length - 1 : 0;
+        case GL_LINE_LOOP: return length > 1 ? length : 0;
+        default: return 0;
+    }
+}
+
+static const char *getModeName( const GLenum mode )
+{
+    switch (mode) {
+        case GL_POINTS: return "draw points";
+        case GL_LINES: return "draw lines";
+        case GL_LINE_STRIP: return "draw line strips";
+        case GL_LINE_LOOP: return "draw line loops";
+        case GL_TRIANGLES: return "draw triangles";
+        default: return "draw";
+    }
+}
+
+
+SceneRenderer::SceneRenderer( const GLsizeiptr arenaCapacity )
+    : m_arena(arenaCapacity)
+    , m_lineLayout(0)
+    , m_lines{ 0, GL_LINES, 0, 0 }
+    , m_commandBuffer(0)
+    , m_parameterBuffer(0)
+    , m_drawIndexBuffer(0)
+    , m_capacity(0)
+    , m_dirty(true)
+{}
+
+SceneRenderer::~SceneRenderer()
+{
+    for (const auto &[stride, vaoID] : m_layouts)
+        glDeleteVertexArrays(1, &vaoID);
+    glDeleteVertexArrays(1, &m_lineLayout);
+
+    glDeleteBuffers(1, &m_commandBuffer);
+    glDeleteBuffers(1, &m_parameterBuffer);
+    glDeleteBuffers(1, &m_drawIndexBuffer);
+}
+
+u32 SceneRenderer::add( const Mesh &mesh, const MeshParameters &parameters )
+{
+    Entry &entry = m_entries.emplace_back(Entry{ { }, mesh.getStride(), mesh.getDrawLength(), mesh.getMode(), parameters, true, false });
+    upload(entry, mesh);
+
+    m_dirty = true;
+    return static_cast<u32>(m_entries.size() - 1);
+}
+
+void SceneRenderer::update( const u32 handle, const Mesh &mesh )
+{
+    Entry &entry = m_entries[handle];
+    const u32 oldFirst = static_cast<u32>(entry.range.offset / (entry.stride * sizeof(f32)));
+    const bool layoutChanged = entry.stride != mesh.getStride() || entry.mode != mesh.getMode() || entry.length != mesh.getDrawLength();
+
+    entry.stride = mesh.getStride();
+    entry.length = mesh.getDrawLength();
+    entry.mode = mesh.getMode();
+    upload(entry, mesh);
+
+    if (layoutChanged || oldFirst != entry.range.offset / (entry.stride * sizeof(f32)))
+        m_dirty = true;
+}
+
+void SceneRenderer::setParameters( const u32 handle, const MeshParameters &parameters )
+{
+    m_entries[handle].parameters = parameters;
+    Invalidation::invalidate();
+    if (!m_dirty) {
+        const MeshParameters uploaded = getParameters(m_entries[handle]);
+        glNamedBufferSubData(m_parameterBuffer, handle * sizeof(MeshParameters), sizeof(MeshParameters), &uploaded);
+    }
+}
+
+MeshParameters SceneRenderer::getParameters( const Entry &entry ) const
+{
+    MeshParameters parameters = entry.parameters;
+    parameters.first = static_cast<u32>(entry.range.offset / sizeof(f32));
+    parameters.stride = entry.stride;
+    parameters.length = entry.length;
+    parameters.mode = entry.mode;
+    return parameters;
+}
+
+void SceneRenderer::setVisible( const u32 handle, const bool visible )
+{
+    if (m_entries[handle].visible == visible)
+        return;
+
+    m_entries[handle].visible = visible;
+    m_dirty = true;
+    Invalidation::invalidate();
+}
+
+void SceneRenderer::setDensity( const u32 handle, const bool density )
+{
+    if (m_entries[handle].density == density)
+        return;
+
+    m_entries[handle].density = density;
+    m_dirty = true;
+    Invalidation::invalidate();
+}
+
+void SceneRenderer::upload( Entry &entry, const Mesh &mesh )
+{
+    const auto size = static_cast<GLsizeiptr>(static_cast<size_t>(entry.length) * entry.stride * sizeof(f32));
+    const auto alignment = static_cast<GLsizeiptr>(entry.stride * sizeof(f32));
+
+    if (entry.range.size < size || entry.range.offset % alignment != 0) {
+        m_arena.release(entry.range);
+        entry.range = { };
+        while (!m_arena.allocate(size, alignment, entry.range)) {
+            m_arena.grow(std::max(2 * m_arena.getCapacity(), m_arena.getCapacity() + size + alignment));
+            for (const auto &[stride, vaoID] : m_layouts)
+                bindVertexLayout(vaoID, stride);
+        }
+    }
+    else if (entry.range.size > size) {
+        // Shrinking in place, give the tail back to the arena
+        m_arena.release({ entry.range.offset + size, entry.range.size - size });
+        entry.range.size = size;
+    }
+
+    if (size > 0) {
+        // The mesh writes straight into the buffer, e.g. a curve its samples, without a staging copy
+        mesh.writeDrawVertices(static_cast<f32 *>(m_arena.map(entry.range)));
+        m_arena.unmap();
+    }
+
+    Invalidation::invalidate();
+}
+
+void SceneRenderer::rebuild()
+{
+    const auto meshCount = static_cast<u32>(m_entries.size());
+
+    if (meshCount > m_capacity) {
+        m_capacity = std::max(meshCount, 2 * m_capacity);
+
+        glDeleteBuffers(1, &m_commandBuffer);
+        glDeleteBuffers(1, &m_parameterBuffer);
+        glDeleteBuffers(1, &m_drawIndexBuffer);
+
+        glCreateBuffers(1, &m_commandBuffer);
+        glNamedBufferStorage(m_commandBuffer, m_capacity * sizeof(DrawArraysIndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        glCreateBuffers(1, &m_parameterBuffer);
+        glNamedBufferStorage(m_parameterBuffer, m_capacity * sizeof(MeshParameters), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        // baseInstance + 0 reads the mesh index from this identity table
+        std::vector<GLuint> drawIndices(m_capacity);
+        std::iota(drawIndices.begin(), drawIndices.end(), 0u);
+        glCreateBuffers(1, &m_drawIndexBuffer);
+        glNamedBufferStorage(m_drawIndexBuffer, m_capacity * sizeof(GLuint), drawIndices.data(), 0);
+
+        for (const auto &[stride, vaoID] : m_layouts)
+            bindVertexLayout(vaoID, stride);
+        if (m_lineLayout)
+            glVertexArrayVertexBuffer(m_lineLayout, 1, m_drawIndexBuffer, 0, sizeof(GLuint));
+    }
+
+    // Group the commands by (stride, mode), so each group is one multi draw
+    std::vector<u32> order(meshCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [this]( const u32 a, const u32 b ) {
+        const Entry &ea = m_entries[a];
+        const Entry &eb = m_entries[b];
+        return (ea.stride != eb.stride) ? ea.stride < eb.stride : ea.mode < eb.mode;
+    });
+
+    std::vector<DrawArraysIndirectCommand> commands;
+    std::vector<DrawArraysIndirectCommand> lineCommands;
+    std::vector<DrawArraysIndirectCommand> densityCommands;
+    std::vector<MeshParameters> parameters;
+    commands.reserve(meshCount);
+    parameters.reserve(meshCount);
+    m_batches.clear();
+    m_densityBatches.clear();
+
+    for (const u32 index : order) {
+        const Entry &entry = m_entries[index];
+        if (entry.density) {
+            // Every vertex is a point, whatever the mode
+            if (m_densityBatches.empty() || m_densityBatches.back().stride != entry.stride)
+                m_densityBatches.push_back({ entry.stride, GL_POINTS, static_cast<u32>(densityCommands.size()), 0 });
+            m_densityBatches.back().commandCount++;
+
+            densityCommands.push_back({
+                entry.length,
+                entry.visible ? 1u : 0u,
+                static_cast<GLuint>(entry.range.offset / (entry.stride * sizeof(f32))),
+                index
+            });
+            continue;
+        }
+
+        if (isLineMode(entry.mode)) {
+            // Six vertices per segment, the shader finds the mesh through the parameters
+            lineCommands.push_back({ 6 * getSegmentCount(entry.mode, entry.length), entry.visible ? 1u : 0u, 0, index });
+            continue;
+        }
+
+        if (m_batches.empty() || m_batches.back().stride != entry.stride || m_batches.back().mode != entry.mode)
+            m_batches.push_back({ entry.stride, entry.mode, static_cast<u32>(commands.size()), 0 });
+        m_batches.back().commandCount++;
+
+        commands.push_back({
+            entry.length,
+            entry.visible ? 1u : 0u,
+            static_cast<GLuint>(entry.range.offset / (entry.stride * sizeof(f32))),
+            index
+        });
+    }
+
+    m_lines.firstCommand = static_cast<u32>(commands.size());
+    m_lines.commandCount = static_cast<u32>(lineCommands.size());
+    commands.insert(commands.end(), lineCommands.begin(), lineCommands.end());
+    for (Batch &batch : m_densityBatches)
+        batch.firstCommand += static_cast<u32>(commands.size());
+    commands.insert(commands.end(), densityCommands.begin(), densityCommands.end());
+
+    for (const Entry &entry : m_entries)
+        parameters.push_back(getParameters(entry));
+
+    glNamedBufferSubData(m_commandBuffer, 0, static_cast<GLsizeiptr>(commands.size() * sizeof(DrawArraysIndirectCommand)), commands.data());
+    glNamedBufferSubData(m_parameterBuffer, 0, static_cast<GLsizeiptr>(parameters.size() * sizeof(MeshParameters)), parameters.data());
+
+    m_dirty = false;
+}
+
+GLuint SceneRenderer::getVertexLayout( const u32 stride )
+{
+    if (const auto it = m_layouts.find(stride); it != m_layouts.end())
+        return it->second;
+
+    GLuint vaoID = 0;
+    glCreateVertexArrays(1, &vaoID);
+
+    // Same attribute layout as Mesh::push, but relative to a single binding
+    glVertexArrayAttribFormat(vaoID, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(vaoID, 0, 0);
+    glEnableVertexArrayAttrib(vaoID, 0);
+
+    for (u32 i = 1; i + 2 < stride; i++) {
+        glVertexArrayAttribFormat(vaoID, i, 1, GL_FLOAT, GL_FALSE, (i + 2) * sizeof(f32));
+        glVertexArrayAttribBinding(vaoID, i, 0);
+        glEnableVertexArrayAttrib(vaoID, i);
+    }
+
+    glVertexArrayAttribIFormat(vaoID, DRAW_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0);
+    glVertexArrayAttribBinding(vaoID, DRAW_INDEX_ATTRIBUTE, 1);
+    glVertexArrayBindingDivisor(vaoID, 1, 1);
+    glEnableVertexArrayAttrib(vaoID, DRAW_INDEX_ATTRIBUTE);
+
+    bindVertexLayout(vaoID, stride);
+    m_layouts[stride] = vaoID;
+    return vaoID;
+}
+
+void SceneRenderer::bindVertexLayout( const GLuint vaoID, const u32 stride ) const
+{
+    glVertexArrayVertexBuffer(vaoID, 0, m_arena.getID(), 0, static_cast<GLsizei>(stride * sizeof(f32)));
+    glVertexArrayVertexBuffer(vaoID, 1, m_drawIndexBuffer, 0, sizeof(GLuint));
+}
+
+void SceneRenderer::render( Profiler *profiler )
+{
+    if (m_entries.empty())
+        return;
+
+    if (m_dirty)
+        rebuild();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_PARAMETER_BINDING, m_parameterBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+    for (const Batch &batch : m_batches) {
+        if (profiler)
+            profiler->beginGpuScope(getModeName(batch.mode));
+
+        glBindVertexArray(getVertexLayout(batch.stride));
+        glMultiDrawArraysIndirect(batch.mode,
+                                  reinterpret_cast<const void *>(batch.firstCommand * sizeof(DrawArraysIndirectCommand)),
+                                  static_cast<GLsizei>(batch.commandCount), 0);
+
+        if (profiler)
+            profiler->endGpuScope();
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void SceneRenderer::renderLines( Profiler *profiler )
+{
+    if (m_entries.empty())
+        return;
+
+    if (m_dirty)
+        rebuild();
+
+    if (m_lines.commandCount == 0)
+        return;
+
+    if (!m_lineLayout) {
+        glCreateVertexArrays(1, &m_lineLayout);
+        glVertexArrayAttribIFormat(m_lineLayout, DRAW_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0);
+        glVertexArrayAttribBinding(m_lineLayout, DRAW_INDEX_ATTRIBUTE, 1);
+        glVertexArrayBindingDivisor(m_lineLayout, 1, 1);
+        glEnableVertexArrayAttrib(m_lineLayout, DRAW_INDEX_ATTRIBUTE);
+        glVertexArrayVertexBuffer(m_lineLayout, 1, m_drawIndexBuffer, 0, sizeof(GLuint));
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_PARAMETER_BINDING, m_parameterBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VERTEX_ARENA_BINDING, m_arena.getID());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+    if (profiler)
+        profiler->beginGpuScope("draw wide lines");
+
+    glBindVertexArray(m_lineLayout);
+    glMultiDrawArraysIndirect(GL_TRIANGLES, reinterpret_cast<const void *>(m_lines.firstCommand * sizeof(DrawArraysIndirectCommand)),
+                              static_cast<GLsizei>(m_lines.commandCount), 0);
+
+    if (profiler)
+        profiler->endGpuScope();
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void SceneRenderer::renderDensity( Profiler *profiler )
+{
+    if (m_entries.empty())
+        return;
+
+    if (m_dirty)
+        rebuild();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_PARAMETER_BINDING, m_parameterBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+    for (const Batch &batch : m_densityBatches) {
+        if (profiler)
+            profiler->beginGpuScope("splat points");
+
+        glBindVertexArray(getVertexLayout(batch.stride));
+        glMultiDrawArraysIndirect(GL_POINTS,
+                                  reinterpret_cast<const void *>(batch.firstCommand * sizeof(DrawArraysIndirectCommand)),
+                                  static_cast<GLsizei>(batch.commandCount), 0);
+
+        if (profiler)
+            profiler->endGpuScope();
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <glad.h>
+#include <glm/glm.hpp>
+#include "defines.hpp"
+#include "3D/CoordinateSystem.hpp"
+#include "3D/Mesh.hpp"
+#include "Rendering/VertexArena.hpp"
+#include "Rendering/Profiler.hpp"
+
+
+// Vertex attribute location carrying the per-draw mesh index (fed by baseInstance)
+constexpr GLuint DRAW_INDEX_ATTRIBUTE = 7;
+
+// Shader storage binding of the per-mesh parameter array
+constexpr GLuint MESH_PARAMETER_BINDING = 0;
+
+// Shader storage binding of the vertex arena, read by res/shader/line
+constexpr GLuint VERTEX_ARENA_BINDING = 2;
+
+/**
+ * Per-mesh data, laid out as std430 for the parameter SSBO.
+ */
+struct MeshParameters {
+    glm::fmat4 model{ 1.0f };
+    glm::fvec4 color{ 1.0f };
+    CoordinateSystem system{ CoordinateSystem::Cartesian }; // converted in the vertex shader
+
+    // Filled in by the SceneRenderer, where res/shader/line finds the vertices in the arena
+    u32 first{ 0 };  // floats
+    u32 stride{ 0 }; // floats
+    u32 length{ 0 }; // vertices
+    GLenum mode{ GL_LINE_STRIP };
+    u32 padding[3]{ };
+};
+
+
+/**
+ * Renders many meshes with a handful of state changes.<br>
+ * Vertex data of all meshes lives in one VertexArena, every mesh becomes one
+ * DrawArraysIndirectCommand and all meshes of the same stride and draw mode are
+ * drawn by a single glMultiDrawArraysIndirect call.
+ * The baseInstance of each command is the mesh index into the parameter SSBO.<br>
+ * Lines, strips and loops of all strides are drawn by renderLines() instead, as one multi draw of six vertices per
+ * segment. The vertex shader reads the segment and its neighbours from the arena, bound as SSBO, and widens it
+ * into a quad in screen space, so wide lines neither depend on glLineWidth nor need MSAA.
+ */
+class SceneRenderer {
+public:
+    explicit SceneRenderer( GLsizeiptr arenaCapacity = 16 << 20 );
+
+    SceneRenderer( const SceneRenderer & ) = delete;
+
+    ~SceneRenderer();
+
+    /**
+     * Uploads the vertices of mesh into the arena.
+     * @return handle for later updates
+     */
+    u32 add( const Mesh &mesh, const MeshParameters &parameters = { } );
+
+    /**
+     * Re-uploads the vertices of mesh, its range is reallocated if it grew.
+     */
+    void update( u32 handle, const Mesh &mesh );
+
+    void setParameters( u32 handle, const MeshParameters &parameters );
+
+    /**
+     * Hidden meshes keep their vertices but are skipped by render(), e.g. curves drawn by a TubeRenderer instead.
+     */
+    void setVisible( u32 handle, bool visible );
+
+    /**
+     * Density meshes are skipped by render() and renderLines(), renderDensity() splats their vertices instead.
+     */
+    void setDensity( u32 handle, bool density );
+
+    /**
+     * Draws all meshes but lines with the currently bound program.
+     * @param profiler if set, every multi draw is measured as a GPU scope
+     */
+    void render( Profiler *profiler = nullptr );
+
+    /**
+     * Draws all lines, strips and loops, expects a program with the layout of res/shader/line bound.
+     * @param profiler if set, the multi draw is measured as a GPU scope
+     */
+    void renderLines( Profiler *profiler = nullptr );
+
+    /**
+     * Draws the vertices of all density meshes as points, one multi draw per stride,
+     * expects a program with the layout of res/shader/density bound.
+     * @param profiler if set, every multi draw is measured as a GPU scope
+     */
+    void renderDensity( Profiler *profiler = nullptr );
+
+    constexpr u32 getMeshCount() const noexcept { return static_cast<u32>(m_entries.size()); }
+
+private:
+    struct Entry {
+        ArenaRange range;
+        u32 stride;
+        u32 length;
+        GLenum mode;
+        MeshParameters parameters;
+        bool visible;
+        bool density;
+    };
+
+    struct Batch {
+        u32 stride;
+        GLenum mode;
+        u32 firstCommand;
+        u32 commandCount;
+    };
+
+    void upload( Entry &entry, const Mesh &mesh );
+    void rebuild();
+
+    /**
+     * Parameters of entry, with the arena range filled in.
+     */
+    MeshParameters getParameters( const Entry &entry ) const;
+
+    GLuint getVertexLayout( u32 stride );
+    void bindVertexLayout( GLuint vaoID, u32 stride ) const;
+
+    VertexArena m_arena;
+    std::vector<Entry> m_entries;
+    std::vector<Batch> m_batches;
+    std::map<u32, GLuint> m_layouts; // stride -> VAO
+    GLuint m_lineLayout; // the draw index only, the line shader reads the arena itself
+    Batch m_lines; // its commands follow those of m_batches
+    std::vector<Batch> m_densityBatches; // their commands follow those of m_lines
+
+    GLuint m_commandBuffer;
+    GLuint m_parameterBuffer;
+    GLuint m_drawIndexBuffer;
+    u32 m_capacity;  // meshes the three buffers above can hold
+    bool m_dirty;
+};
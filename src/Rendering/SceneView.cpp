@@ -0,0 +1,254 @@
+#include "SceneView.hpp"
+#include "3D/Interpolation/SmoothICurve.hpp"
+#include <algorithm>
+#include <iostream>
+
+
+// Of the curves and other line meshes, in pixels
+constexpr f32 LINE_WIDTH = 4.0f;
+
+
+SceneView::SceneView( const Scene &scene )
+    : m_scene(scene)
+    , m_cpuBinning(false)
+    , m_sceneShader("./res/shader/batched", false)
+    , m_lineShader("./res/shader/line", false)
+    , m_lineShaderVersion(0)
+    , m_gridShader("./res/shader/cartesianSystem", false)
+    , m_streamedShader("./res/shader/streamed", false)
+    , m_tubeShader("./res/shader/tube", false)
+    , m_densityShader("./res/shader/density", false)
+    , m_densityMaxShader("./res/shader/densityMax", false)
+    , m_densityResolveShader("./res/shader/densityResolve", false)
+{
+    for (u32 i = 0; i < m_scene.getMeshCount(); i++) {
+        const auto mesh = m_scene.getMesh(i);
+        MeshParameters parameters;
+        parameters.system = m_scene.getShaderSystem(i);
+        m_renderer.add(*mesh, parameters);
+        m_meshBounds.push_back(mesh->computeBounds(parameters.system));
+        const MeshSpec &spec = m_scene.getSpec(i);
+        if (spec.kind == MeshSpec::Kind::Signal)
+            m_signals.push_back(i);
+
+        if (spec.density) {
+            m_renderer.setDensity(i, true);
+            m_density.push_back(i);
+        }
+        else if (spec.kind == MeshSpec::Kind::Curve && spec.sweep != MeshSpec::Sweep::Line) {
+            // The polyline stays in the arena, hidden, the tube is built from the frames of the same samples
+            m_renderer.setVisible(i, false);
+            m_swept.emplace_back(i, m_tubeRenderer.add(static_cast<const SmoothICurve &>(*mesh), spec.sweep, spec.radius));
+        }
+    }
+    m_densityVertices.resize(m_density.size());
+    updateGrid();
+
+    Shader::defineInclude("transforms.glsl", CoordinateTransforms::generateGLSL());
+    Shader::LoadAll({ &m_sceneShader, &m_lineShader, &m_gridShader, &m_streamedShader, &m_tubeShader,
+                      &m_densityShader, &m_densityMaxShader, &m_densityResolveShader });
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClearDepth(1.0);
+    glEnable(GL_MULTISAMPLE);
+    glEnable(GL_LINE_SMOOTH);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void SceneView::update( const std::vector<u32> &meshes )
+{
+    for (const u32 index : meshes) {
+        const auto mesh = m_scene.getMesh(index);
+        m_renderer.update(index, *mesh);
+        m_meshBounds[index] = mesh->computeBounds(m_scene.getShaderSystem(index));
+    }
+    for (const auto &[index, handle] : m_swept) {
+        if (std::find(meshes.begin(), meshes.end(), index) != meshes.end())
+            m_tubeRenderer.update(handle, static_cast<const SmoothICurve &>(*m_scene.getMesh(index)));
+    }
+    for (u32 i = 0; i < m_density.size(); i++) {
+        if (std::find(meshes.begin(), meshes.end(), m_density[i]) != meshes.end())
+            m_densityVertices[i].clear();
+    }
+    updateGrid();
+}
+
+void SceneView::updateGrid()
+{
+    Bounds bounds = m_tileBounds;
+    for (const Bounds &mesh : m_meshBounds)
+        bounds.extend(mesh);
+    for (const auto &stream : m_streams)
+        bounds.extend(stream->getBounds());
+    m_grid.setBounds(bounds);
+}
+
+void SceneView::binDensity( const FrameData &frame )
+{
+    const auto width = static_cast<int>(frame.viewport.x);
+    const auto height = static_cast<int>(frame.viewport.y);
+    std::vector<u32> counts;
+    for (u32 i = 0; i < m_density.size(); i++) {
+        const auto mesh = m_scene.getMesh(m_density[i]);
+        std::vector<f32> &vertices = m_densityVertices[i];
+        if (vertices.empty() && mesh->getDrawLength() > 0) {
+            vertices.resize(static_cast<size_t>(mesh->getDrawLength()) * mesh->getStride());
+            mesh->writeDrawVertices(vertices.data());
+            CoordinateTransforms::toCartesian(m_scene.getShaderSystem(m_density[i]), vertices.data(), mesh->getDrawLength(), mesh->getStride());
+        }
+        m_densityRenderer.bin(vertices.data(), vertices.size() / mesh->getStride(), mesh->getStride(), frame.MVP, width, height, counts);
+    }
+    counts.resize(static_cast<size_t>(width) * height, 0);
+    m_densityRenderer.upload(counts, width, height);
+}
+
+bool SceneView::addTiles( const std::string &path, const ResidencyBudget &budget )
+{
+    auto file = std::make_shared<const TileFile>(path);
+    if (!file->isValid())
+        return false;
+
+    std::cout << "[  INFO  ][Tiles  ] \"" << path << "\": " << file->getVertexCount() << " vertices in " << file->getTileCount()
+              << " tiles, budget " << (budget.ram >> 20) << " MiB RAM, " << (budget.vram >> 20) << " MiB VRAM" << std::endl;
+    // Bounds from the tile table, without touching the tiles themselves
+    for (u64 tile = 0; tile < file->getTileCount(); tile++) {
+        const TileInfo &info = file->getInfo(tile);
+        m_tileBounds.extend(Bounds{ { info.min[0], info.min[1], info.min[2] }, { info.max[0], info.max[1], info.max[2] } });
+    }
+    updateGrid();
+
+    m_tiles.push_back(std::make_unique<TileResidency>(std::move(file), budget));
+    return true;
+}
+
+bool SceneView::addStream( const std::string &name )
+{
+    auto ring = std::make_unique<const SharedRing>(name);
+    if (!ring->isValid())
+        return false;
+
+    auto stream = std::make_unique<RingStream>(std::move(ring));
+    if (!stream->isValid())
+        return false;
+
+    m_streams.push_back(std::move(stream));
+    return true;
+}
+
+ResidencyStatistics SceneView::getTileStatistics() const
+{
+    ResidencyStatistics sum;
+    for (const auto &tiles : m_tiles) {
+        const ResidencyStatistics &statistics = tiles->getStatistics();
+        sum.visible += statistics.visible;
+        sum.drawn += statistics.drawn;
+        sum.ramTiles += statistics.ramTiles;
+        sum.vramTiles += statistics.vramTiles;
+        sum.prefetched += statistics.prefetched;
+        sum.uploaded += statistics.uploaded;
+        sum.evicted += statistics.evicted;
+    }
+    return sum;
+}
+
+void SceneView::render( const FrameData &frame, Profiler &profiler )
+{
+    m_frameUniforms.update(frame);
+
+    if (!m_streams.empty()) {
+        const ProfileScope scope(profiler, "stream upload");
+        bool grown = false;
+        for (const auto &stream : m_streams)
+            grown |= stream->update();
+        if (grown)
+            updateGrid();
+    }
+
+    {
+        const ProfileScope scope(profiler, "grid");
+        const GpuProfileScope gpuScope(profiler, "grid");
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // glDisable(GL_DEPTH_TEST);
+        glLineWidth(1.0f);
+        m_gridShader.Bind();
+        m_grid.render(m_gridShader, frame);
+    }
+
+    if (!m_density.empty()) {
+        const ProfileScope scope(profiler, "density");
+        const GpuProfileScope gpuScope(profiler, "density");
+        if (m_cpuBinning)
+            binDensity(frame);
+        else {
+            m_densityRenderer.begin(static_cast<int>(frame.viewport.x), static_cast<int>(frame.viewport.y));
+            m_densityShader.Bind();
+            m_renderer.renderDensity(&profiler);
+            m_densityRenderer.end();
+        }
+        m_densityRenderer.resolve(m_densityMaxShader, m_densityResolveShader);
+    }
+
+    {
+        const ProfileScope scope(profiler, "scene");
+        const GpuProfileScope gpuScope(profiler, "scene");
+        glClear(GL_DEPTH_BUFFER_BIT);
+        m_sceneShader.Bind();
+        m_renderer.render(&profiler);
+
+        // Antialiased in the shader, the coverage goes into alpha, the alpha of the target stays opaque
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+        m_lineShader.Bind();
+        if (m_lineShader.getVersion() != m_lineShaderVersion) {
+            // Constant, only a new program needs it
+            m_lineShaderVersion = m_lineShader.getVersion();
+            m_lineShader.set(m_lineShader.getUniform<f32>("width"), LINE_WIDTH);
+        }
+        m_renderer.renderLines(&profiler);
+        glDisable(GL_BLEND);
+    }
+
+    if (!m_tubeRenderer.isEmpty()) {
+        const ProfileScope scope(profiler, "tubes");
+        const GpuProfileScope gpuScope(profiler, "tubes");
+        m_tubeShader.Bind();
+        m_tubeRenderer.render(m_tubeShader);
+    }
+
+    if (!m_signals.empty()) {
+        const ProfileScope scope(profiler, "envelope");
+        const GpuProfileScope gpuScope(profiler, "envelope");
+
+        // Rewritten every frame, only the visible part at screen resolution
+        std::vector<std::shared_ptr<const SignalEnvelope>> envelopes;
+        for (const u32 index : m_signals)
+            envelopes.push_back(std::static_pointer_cast<const SignalEnvelope>(m_scene.getMesh(index)));
+
+        // Aliased single pixel lines, smooth ones would widen the envelope at the bucket borders
+        glDisable(GL_LINE_SMOOTH);
+        glLineWidth(1.0f);
+        m_streamedShader.Bind();
+        m_envelopeRenderer.render(envelopes, frame);
+        glEnable(GL_LINE_SMOOTH);
+    }
+
+    if (!m_tiles.empty()) {
+        const ProfileScope scope(profiler, "tiles");
+        const GpuProfileScope gpuScope(profiler, "tiles");
+        glLineWidth(1.0f);
+        m_streamedShader.Bind();
+        for (const auto &tiles : m_tiles) {
+            tiles->update(frame.MVP);
+            tiles->render();
+        }
+    }
+
+    if (!m_streams.empty()) {
+        const ProfileScope scope(profiler, "streams");
+        const GpuProfileScope gpuScope(profiler, "streams");
+        glLineWidth(1.0f);
+        m_streamedShader.Bind();
+        for (const auto &stream : m_streams)
+            stream->render();
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+#include "3D/Mesh.hpp"
+#include "3D/Scene.hpp"
+#include "Rendering/AxisGrid.hpp"
+#include "Rendering/Shader.hpp"
+#include "Rendering/SceneRenderer.hpp"
+#include "Rendering/EnvelopeRenderer.hpp"
+#include "Rendering/TubeRenderer.hpp"
+#include "Rendering/DensityRenderer.hpp"
+#include "Rendering/RingStream.hpp"
+#include "Rendering/TileResidency.hpp"
+#include "Rendering/FrameUniforms.hpp"
+#include "Rendering/Profiler.hpp"
+
+
+/**
+ * Everything needed to draw a Scene into the bound framebuffer: the batched
+ * renderer, the swept curves, the density images, the signal envelopes, the paged tile files, the live streams, the shaders, the reference grid fitted to all of them
+ * and the per-frame uniforms.<br>
+ * Shared by the interactive window and the headless renderer.
+ */
+class SceneView {
+public:
+    explicit SceneView( const Scene &scene );
+
+    SceneView( const SceneView & ) = delete;
+
+    /**
+     * Re-uploads the given scene meshes, e.g. the ones returned by ReloadService::applyPending().
+     */
+    void update( const std::vector<u32> &meshes );
+
+    /**
+     * Draws the line strip of a TileFile after the scene, paged in within budget.
+     * @return false if path is not a valid tile file
+     */
+    bool addTiles( const std::string &path, const ResidencyBudget &budget );
+
+    /**
+     * Draws the rows of the SharedRing name after the scene, as they arrive.
+     * @return false if there is no such ring or it lacks X, Y, Z columns
+     */
+    bool addStream( const std::string &name );
+
+    /**
+     * Counts the points of density meshes on the CPU instead of splatting them on the GPU, see DensityRenderer.
+     */
+    void setCpuBinning( bool cpuBinning ) noexcept { m_cpuBinning = cpuBinning; }
+
+    /**
+     * Clears and draws grid, density images, scene, swept curves, tiles and streams.
+     */
+    void render( const FrameData &frame, Profiler &profiler );
+
+    /**
+     * @return statistics of all tile files, summed up
+     */
+    ResidencyStatistics getTileStatistics() const;
+
+    const std::vector<std::unique_ptr<RingStream>> &getStreams() const noexcept { return m_streams; }
+
+    /**
+     * @return the counts of the last render() are in getDensityRenderer() if true
+     */
+    bool hasDensity() const noexcept { return !m_density.empty(); }
+    const DensityRenderer &getDensityRenderer() const noexcept { return m_densityRenderer; }
+
+    Shader &getSceneShader() noexcept { return m_sceneShader; }
+    Shader &getGridShader() noexcept { return m_gridShader; }
+    Shader &getStreamedShader() noexcept { return m_streamedShader; }
+    Shader &getTubeShader() noexcept { return m_tubeShader; }
+    Shader &getLineShader() noexcept { return m_lineShader; }
+    Shader &getDensityShader() noexcept { return m_densityShader; }
+    Shader &getDensityMaxShader() noexcept { return m_densityMaxShader; }
+    Shader &getDensityResolveShader() noexcept { return m_densityResolveShader; }
+
+private:
+    /**
+     * Fits the grid to the bounds of all meshes, tiles and streams.
+     */
+    void updateGrid();
+
+    /**
+     * Counts the points of all density meshes on the CPU, from cartesian copies of their vertices.
+     */
+    void binDensity( const FrameData &frame );
+
+    const Scene &m_scene;
+
+    SceneRenderer m_renderer;
+    EnvelopeRenderer m_envelopeRenderer;
+    std::vector<u32> m_signals; // scene meshes drawn by m_envelopeRenderer
+    TubeRenderer m_tubeRenderer;
+    std::vector<std::pair<u32, u32>> m_swept; // scene mesh and its m_tubeRenderer handle
+    DensityRenderer m_densityRenderer;
+    std::vector<u32> m_density; // scene meshes drawn by m_densityRenderer
+    std::vector<std::vector<f32>> m_densityVertices; // per m_density, for CPU binning, empty until needed
+    bool m_cpuBinning;
+    std::vector<std::unique_ptr<TileResidency>> m_tiles;
+    std::vector<std::unique_ptr<RingStream>> m_streams;
+    Shader m_sceneShader;
+    Shader m_lineShader;
+    u64 m_lineShaderVersion; // program the line width was last set on
+    Shader m_gridShader;
+    Shader m_streamedShader;
+    Shader m_tubeShader;
+    Shader m_densityShader;
+    Shader m_densityMaxShader;
+    Shader m_densityResolveShader;
+    AxisGrid m_grid;
+    std::vector<Bounds> m_meshBounds; // per scene mesh, in cartesian coordinates
+    Bounds m_tileBounds;
+    FrameUniforms m_frameUniforms;
+};
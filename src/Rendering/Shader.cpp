@@ -1,26 +1,85 @@
 #include "Shader.hpp"
+#include "ShaderCache.hpp"
+#include "Invalidation.hpp"
+#include "hash.hpp"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <sstream>
 
 
-bool loadShaderProgram( const std::string &filename, GLint shaderType, GLuint &shaderID )
+static ShaderCache &getShaderCache()
 {
-    std::string sourceCode;
-    std::ifstream shaderFile(filename);
+    static ShaderCache cache;
+    return cache;
+}
+
 
-    if (shaderFile) {
-        std::stringstream sourceStringStream;
-        sourceStringStream << shaderFile.rdbuf();
+// Source of Shader::getVersion(), programs are also created on the reload thread
+static std::atomic<u64> s_versions{ 0 };
 
-        shaderFile.close();
+static std::mutex s_includeMutex;
+static std::unordered_map<std::string, std::string> s_includes;
 
-        sourceCode = sourceStringStream.str();
+/**
+ * Expands the lines #include "name" of sourceCode with the sources given to Shader::defineInclude.
+ * Unknown ones are left in place, so the compiler reports them.
+ */
+static void expandIncludes( const std::string &filename, std::string &sourceCode )
+{
+    static constexpr std::string_view DIRECTIVE = "#include \"";
+
+    std::lock_guard lock(s_includeMutex);
+    for (size_t begin = sourceCode.find(DIRECTIVE); begin != std::string::npos; begin = sourceCode.find(DIRECTIVE, begin)) {
+        const size_t nameBegin = begin + DIRECTIVE.size();
+        const size_t nameEnd = sourceCode.find('"', nameBegin);
+        const size_t lineEnd = std::min(sourceCode.find('\n', begin), sourceCode.size());
+        if (nameEnd >= lineEnd) {
+            std::cerr << "[ ERROR  ][Shader ] Malformed #include in: " << filename << std::endl;
+            return;
+        }
+
+        const auto include = s_includes.find(sourceCode.substr(nameBegin, nameEnd - nameBegin));
+        if (include == s_includes.end()) {
+            std::cerr << "[ ERROR  ][Shader ] Unknown include " << sourceCode.substr(begin, nameEnd + 1 - begin) << " in: " << filename << std::endl;
+            return;
+        }
+
+        sourceCode.replace(begin, lineEnd - begin, include->second);
+        begin += include->second.size();
     }
-    else {
+}
+
+
+bool readShaderSource( const std::string &filename, std::string &sourceCode )
+{
+    // Avoid a failing open for each stage that does not exist
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filename, error))
+        return false;
+
+    std::ifstream shaderFile(filename);
+    if (!shaderFile)
+        return false;
+
+    std::stringstream sourceStringStream;
+    sourceStringStream << shaderFile.rdbuf();
+    sourceCode = sourceStringStream.str();
+    expandIncludes(filename, sourceCode);
+    return true;
+}
+
+
+bool loadShaderProgram( const std::string &filename, GLint shaderType, GLuint &shaderID )
+{
+    std::string sourceCode;
+    if (!readShaderSource(filename, sourceCode))
         return false;
-    }
 
     int success;
     char infoLog[1024];
@@ -42,17 +101,21 @@ bool loadShaderProgram( const std::string &filename, GLint shaderType, GLuint &s
 }
 
 
-Shader::Shader( const std::string &shaderPath )
+Shader::Shader( const std::string &shaderPath, const bool load )
     : m_shaderName(shaderPath)
 {
-    Load();
+    if (load)
+        Load();
 }
 
 Shader &Shader::operator=( Shader &&shader ) noexcept
 {
-    m_programID = shader.m_programID;
-    m_uniforms = std::move(shader.m_uniforms);
-    m_shaderName = std::move(shader.m_shaderName);
+    std::swap(m_programID, shader.m_programID);
+    std::swap(m_version, shader.m_version);
+    std::swap(m_uniforms, shader.m_uniforms);
+    m_shaderName = shader.m_shaderName;
+
+    Invalidation::invalidate();
     return *this;
 }
 
@@ -61,58 +124,141 @@ bool Shader::Reload()
     if (m_programID != 0) {
         glUseProgram(0);
         glDeleteProgram(m_programID);
+        m_programID = 0;
     }
 
     m_uniforms.clear();
+    Invalidation::invalidate();
     return Load();
 }
 
 bool Shader::Load()
 {
+    return BeginLoad() && FinishLoad();
+}
+
+bool Shader::LoadAll( const std::initializer_list<Shader *> shaders )
+{
+    // Issue all compiles before the first status query, so the driver can work on them in parallel
+    bool success = true;
+    for (Shader *const shader : shaders)
+        success &= shader->BeginLoad();
+    for (Shader *const shader : shaders)
+        success &= shader->FinishLoad();
+
+    return success;
+}
+
+void Shader::enableParallelCompile()
+{
+    // 0xFFFFFFFF: as many threads as the driver likes
+    if (GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+}
+
+void Shader::defineInclude( const std::string &name, const std::string &source )
+{
+    std::lock_guard lock(s_includeMutex);
+    s_includes[name] = source;
+}
+
+bool Shader::BeginLoad()
+{
+    struct Stage {
+        const char *extension;
+        GLenum type;
+    };
+    static constexpr Stage STAGES[] = {
+        { ".vert", GL_VERTEX_SHADER },
+        { ".frag", GL_FRAGMENT_SHADER },
+        { ".geom", GL_GEOMETRY_SHADER },
+        { ".comp", GL_COMPUTE_SHADER }
+    };
+
     std::cout << "[  INFO  ][Shader ] Create Shader: " << m_shaderName << '\n';
 
-    GLuint vertexID(0), fragmentID(0), geometryID(0), computeID(0);
-    bool hasVertex = loadShaderProgram(m_shaderName + ".vert", GL_VERTEX_SHADER, vertexID);
-    bool hasFragment = loadShaderProgram(m_shaderName + ".frag", GL_FRAGMENT_SHADER, fragmentID);
-    bool hasGeometry = loadShaderProgram(m_shaderName + ".geom", GL_GEOMETRY_SHADER, geometryID);
-    bool hasCompute = loadShaderProgram(m_shaderName + ".comp", GL_COMPUTE_SHADER, computeID);
+    const ShaderCache &cache = getShaderCache();
+
+    std::string sources[std::size(STAGES)];
+    bool hasAnyStage = false;
+    u64 key = cache.getDriverKey();
+
+    for (u32 i = 0; i < std::size(STAGES); i++) {
+        if (!readShaderSource(m_shaderName + STAGES[i].extension, sources[i]))
+            continue;
+
+        key = hashBytes(key, STAGES[i].extension);
+        key = hashBytes(key, sources[i]);
+        hasAnyStage = true;
+    }
 
     // no shader source found
-    if (!hasVertex && !hasFragment && !hasGeometry && !hasCompute)
+    if (!hasAnyStage)
         return false;
 
-    // Create and Link the Shader Program, attach and delete available Shaders
+    m_cacheKey = key;
+    m_programID = glCreateProgram();
+    m_version = ++s_versions;
+    if (cache.load(m_shaderName, key, m_programID)) {
+        std::cout << "[  INFO  ][Shader ] Loaded cached binary: " << m_shaderName << '\n';
+        return true;
+    }
+
+    // A rejected binary leaves the program in a failed state, start over with a fresh one
+    glDeleteProgram(m_programID);
     m_programID = glCreateProgram();
+    glProgramParameteri(m_programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-    if (hasVertex)
-        glAttachShader(m_programID, vertexID);
-    if (hasFragment)
-        glAttachShader(m_programID, fragmentID);
-    if (hasGeometry)
-        glAttachShader(m_programID, geometryID);
-    if (hasCompute)
-        glAttachShader(m_programID, computeID);
+    // Create and Link the Shader Program, attach available Shaders
+    for (u32 i = 0; i < std::size(STAGES); i++) {
+        if (sources[i].empty())
+            continue;
+
+        const char *source_cptr = sources[i].c_str();
+        const GLuint shaderID = glCreateShader(STAGES[i].type);
+        glShaderSource(shaderID, 1, &source_cptr, nullptr);
+        glCompileShader(shaderID);
+        glAttachShader(m_programID, shaderID);
+
+        m_pendingStages.push_back({ m_shaderName + STAGES[i].extension, shaderID });
+    }
 
     glLinkProgram(m_programID);
+    m_pendingLink = true;
 
-    if (hasVertex)
-        glDeleteShader(vertexID);
-    if (hasFragment)
-        glDeleteShader(fragmentID);
-    if (hasGeometry)
-        glDeleteShader(geometryID);
-    if (hasCompute)
-        glDeleteShader(computeID);
+    return true;
+}
+
+bool Shader::FinishLoad()
+{
+    if (!m_pendingLink)
+        return m_programID != 0;
+    m_pendingLink = false;
 
     int success;
     char infoLog[1024];
+    bool compiled = true;
+
+    // First status query blocks until the (parallel) compilation is done
+    for (const PendingStage &stage : m_pendingStages) {
+        glGetShaderiv(stage.shaderID, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(stage.shaderID, 1024, nullptr, infoLog);
+            std::cerr << "[ ERROR  ][Shader ] Error in: " << stage.filename << std::endl << infoLog << std::endl;
+            compiled = false;
+        }
+        glDeleteShader(stage.shaderID);
+    }
+    m_pendingStages.clear();
+
     glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
-    if (!success) {
+    if (!compiled || !success) {
         glGetProgramInfoLog(m_programID, 1024, nullptr, infoLog);
         std::cout << "[ ERROR  ][Shader ] Link:" << std::endl << infoLog << std::endl;
         return false;
     }
 
+    getShaderCache().store(m_shaderName, m_cacheKey, m_programID);
     return true;
 }
 
@@ -173,9 +319,67 @@ void Shader::setMatrixFloat4( const std::string &name, const glm::fmat4 &matrix
 
 GLint Shader::getUniformLocation( const std::string &name )
 {
-    if (!m_uniforms.contains(name))
-        m_uniforms[name] = glGetUniformLocation(m_programID, name.data());
-    return m_uniforms[name];
+    if (const auto it = m_uniforms.find(name); it != m_uniforms.end())
+        return it->second;
+
+    const GLint location = glGetUniformLocation(m_programID, name.data());
+    m_uniforms.emplace(name, location);
+    return location;
+}
+
+void Shader::set( const Uniform<bool> uniform, const bool value ) const
+{
+    glProgramUniform1i(m_programID, uniform.location, static_cast<int>(value));
+}
+
+void Shader::set( const Uniform<i32> uniform, const i32 value ) const
+{
+    glProgramUniform1i(m_programID, uniform.location, value);
+}
+
+void Shader::set( const Uniform<u32> uniform, const u32 value ) const
+{
+    glProgramUniform1ui(m_programID, uniform.location, value);
+}
+
+void Shader::set( const Uniform<f32> uniform, const f32 value ) const
+{
+    glProgramUniform1f(m_programID, uniform.location, value);
+}
+
+void Shader::set( const Uniform<glm::fvec2> uniform, const glm::fvec2 &value ) const
+{
+    glProgramUniform2fv(m_programID, uniform.location, 1, &value.x);
+}
+
+void Shader::set( const Uniform<glm::fvec3> uniform, const glm::fvec3 &value ) const
+{
+    glProgramUniform3fv(m_programID, uniform.location, 1, &value.x);
+}
+
+void Shader::set( const Uniform<glm::fvec4> uniform, const glm::fvec4 &value ) const
+{
+    glProgramUniform4fv(m_programID, uniform.location, 1, &value.x);
+}
+
+void Shader::set( const Uniform<f64> uniform, const f64 value ) const
+{
+    glProgramUniform1d(m_programID, uniform.location, value);
+}
+
+void Shader::set( const Uniform<glm::dvec2> uniform, const glm::dvec2 &value ) const
+{
+    glProgramUniform2dv(m_programID, uniform.location, 1, &value.x);
+}
+
+void Shader::set( const Uniform<glm::dvec3> uniform, const glm::dvec3 &value ) const
+{
+    glProgramUniform3dv(m_programID, uniform.location, 1, &value.x);
+}
+
+void Shader::set( const Uniform<glm::fmat4> uniform, const glm::fmat4 &matrix ) const
+{
+    glProgramUniformMatrix4fv(m_programID, uniform.location, 1, GL_FALSE, &matrix[0].x);
 }
 
 Shader::~Shader()
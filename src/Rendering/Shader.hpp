@@ -1,21 +1,45 @@
 #pragma once
 
+#include <initializer_list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <glad.h>
 #include <glm/glm.hpp>
 #include "defines.hpp"
 
+bool readShaderSource( const std::string &filename, std::string &sourceCode );
+
 bool loadShaderProgram( const std::string &filename, GLint shaderType, GLuint &shaderID );
 
 
+/**
+ * Typed, pre-resolved uniform location of one program.<br>
+ * Obtained once after Load() by Shader::getUniform, must be resolved again whenever Shader::getVersion() changed.
+ */
+template<typename T>
+struct Uniform {
+    GLint location{ -1 };
+
+    constexpr bool isValid() const noexcept { return location >= 0; }
+};
+
+
 class Shader {
 public:
     Shader() = default;
 
-    explicit Shader( const std::string &shaderPath );
+    /**
+     * @param shaderPath path without extension, stages are read from .vert/.frag/.geom/.comp
+     * @param load compile and link immediately, otherwise call Load() or LoadAll() later
+     */
+    explicit Shader( const std::string &shaderPath, bool load = true );
 
+    /**
+     * Takes over the program of shader, the previous program is released together with shader.
+     * Uniform handles of the previous program have to be resolved again.
+     */
     Shader &operator=( Shader &&shader ) noexcept;
 
     ~Shader();
@@ -24,8 +48,40 @@ public:
     bool Reload();
     bool Load();
 
+    /**
+     * Starts loading from the program binary cache or compiling and linking the sources
+     * without waiting for the driver. FinishLoad() checks the results.
+     */
+    bool BeginLoad();
+    bool FinishLoad();
+
+    /**
+     * Loads several shaders, so that drivers with parallel shader compilation can build them concurrently.
+     */
+    static bool LoadAll( std::initializer_list<Shader *> shaders );
+
+    /**
+     * Lets the driver compile on several threads, if it supports ARB_parallel_shader_compile.
+     * Call once per context after loading GL.
+     */
+    static void enableParallelCompile();
+
+    /**
+     * Replaces lines <code>#include "name"</code> in the sources of all shaders loaded afterwards,
+     * e.g. with generated code.
+     */
+    static void defineInclude( const std::string &name, const std::string &source );
+
     constexpr GLuint getID() const { return m_programID; }
 
+    /**
+     * Changes with every new program, by Load(), Reload() or assigning a reloaded shader.
+     * Uniform handles and values set once are kept until then.
+     */
+    u64 getVersion() const noexcept { return m_version; }
+
+    const std::string &getName() const noexcept { return m_shaderName; }
+
     void setBool( const std::string &name, bool value );
 
     void setInt( const std::string &name, i32 value );
@@ -44,8 +100,37 @@ public:
 
     GLint getUniformLocation(const std::string &name);
 
+    template<typename T>
+    Uniform<T> getUniform( const std::string &name ) { return { getUniformLocation(name) }; }
+
+    void set( Uniform<bool> uniform, bool value ) const;
+
+    void set( Uniform<i32> uniform, i32 value ) const;
+    void set( Uniform<u32> uniform, u32 value ) const;
+
+    void set( Uniform<f32> uniform, f32 value ) const;
+    void set( Uniform<glm::fvec2> uniform, const glm::fvec2 &value ) const;
+    void set( Uniform<glm::fvec3> uniform, const glm::fvec3 &value ) const;
+    void set( Uniform<glm::fvec4> uniform, const glm::fvec4 &value ) const;
+
+    void set( Uniform<f64> uniform, f64 value ) const;
+    void set( Uniform<glm::dvec2> uniform, const glm::dvec2 &value ) const;
+    void set( Uniform<glm::dvec3> uniform, const glm::dvec3 &value ) const;
+
+    void set( Uniform<glm::fmat4> uniform, const glm::fmat4 &matrix ) const;
+
 private:
+    struct PendingStage {
+        std::string filename;
+        GLuint shaderID;
+    };
+
     GLuint m_programID{ 0 };
+    u64 m_version{ 0 };
     std::unordered_map<std::string, GLint> m_uniforms;
     std::string m_shaderName{ "-- This is no Shader --" };
+
+    std::vector<PendingStage> m_pendingStages;
+    u64 m_cacheKey{ 0 };
+    bool m_pendingLink{ false };
 };
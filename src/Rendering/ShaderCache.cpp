@@ -0,0 +1,116 @@
+#include "ShaderCache.hpp"
+#include "hash.hpp"
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+static constexpr u32 CACHE_MAGIC = 0x43534C50; // "PLSC"
+static constexpr u32 CACHE_VERSION = 1;
+
+struct CacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 format;
+    u32 length;
+};
+
+
+ShaderCache::ShaderCache( std::filesystem::path directory )
+    : m_directory(std::move(directory))
+    , m_driverKey(HASH_BASIS)
+    , m_enabled(false)
+{
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    m_enabled = formats > 0;
+
+    for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        if (const auto *str = reinterpret_cast<const char *>(glGetString(name)))
+            m_driverKey = hashBytes(m_driverKey, str);
+    }
+
+    if (m_enabled) {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if (error) {
+            std::clog << "[WARNING ][Shader ] Cannot create shader cache \"" << m_directory.string() << "\": " << error.message() << std::endl;
+            m_enabled = false;
+        }
+    }
+}
+
+std::filesystem::path ShaderCache::getEntryPath( const std::string &name ) const
+{
+    std::string fileName = std::filesystem::path(name).lexically_normal().string();
+    for (char &c : fileName) {
+        if (c == '/' || c == '\\' || c == '.' || c == ':')
+            c = '_';
+    }
+
+    return m_directory / (fileName + ".bin");
+}
+
+bool ShaderCache::load( const std::string &name, const u64 key, const GLuint programID ) const
+{
+    if (!m_enabled)
+        return false;
+
+    std::ifstream file(getEntryPath(name), std::ios::binary);
+    if (!file)
+        return false;
+
+    CacheHeader header{ };
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key)
+        return false;
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+        return false;
+
+    glProgramBinary(programID, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // The driver may reject a binary despite a matching key, the caller then compiles from source
+    GLint success = GL_FALSE;
+    glGetProgramiv(programID, GL_LINK_STATUS, &success);
+    return success == GL_TRUE;
+}
+
+void ShaderCache::store( const std::string &name, const u64 key, const GLuint programID ) const
+{
+    if (!m_enabled)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(programID, length, nullptr, &format, binary.data());
+
+    const CacheHeader header{ CACHE_MAGIC, CACHE_VERSION, key, format, static_cast<u32>(length) };
+
+    // Write to a temporary file first, a concurrently starting instance never reads half an entry
+    const std::filesystem::path path = getEntryPath(name);
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file)
+            return;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+}
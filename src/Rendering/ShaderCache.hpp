@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include <glad.h>
+#include "defines.hpp"
+
+
+/**
+ * On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).<br>
+ * Entries are keyed by a hash over all stage sources and the driver identification
+ * (vendor, renderer and version string), so a driver update or an edited source
+ * simply misses the cache and the caller compiles from source again.
+ */
+class ShaderCache {
+public:
+    explicit ShaderCache( std::filesystem::path directory = "cache/shaders" );
+
+    /**
+     * @return true if the driver exposes at least one program binary format
+     */
+    constexpr bool isEnabled() const noexcept { return m_enabled; }
+
+    /**
+     * Starts a key with the driver identification, extend it with hashBytes.
+     */
+    constexpr u64 getDriverKey() const noexcept { return m_driverKey; }
+
+    /**
+     * Loads the binary stored for name into programID.
+     * @return true if an entry with a matching key was found and linked successfully
+     */
+    bool load( const std::string &name, u64 key, GLuint programID ) const;
+
+    /**
+     * Stores the binary of the linked programID for name, replacing an older entry.
+     */
+    void store( const std::string &name, u64 key, GLuint programID ) const;
+
+private:
+    std::filesystem::path getEntryPath( const std::string &name ) const;
+
+    std::filesystem::path m_directory;
+    u64 m_driverKey;
+    bool m_enabled;
+};
@@ -0,0 +1,263 @@
+#include "TileResidency.hpp"
+#include "Rendering/Invalidation.hpp"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <iostream>
+
+
+// Tiles read and uploaded per frame at most, so a jump of the camera does not stall a single frame
+static constexpr u32 MAX_READS_PER_FRAME = 32;
+static constexpr u32 MAX_UPLOADS_PER_FRAME = 8;
+
+// Tiles within this multiple of the view frustum are read ahead
+static constexpr f32 NEARBY_MARGIN = 1.5f;
+
+// The camera movement of the last frame is extrapolated this many frames ahead for reading
+static constexpr f32 PREDICTION_FRAMES = 10.0f;
+
+// Tiles per parallel chunk of the frustum tests
+static constexpr u64 CULL_GRAIN = 4096;
+
+enum TileClass : u8 {
+    Outside,
+    Nearby,
+    Visible
+};
+
+
+void TileResidency::LRU::touch( const u64 tile )
+{
+    if (const auto it = positions.find(tile); it != positions.end()) {
+        order.splice(order.begin(), order, it->second);
+        return;
+    }
+    order.push_front(tile);
+    positions[tile] = order.begin();
+}
+
+void TileResidency::LRU::remove( const u64 tile )
+{
+    if (const auto it = positions.find(tile); it != positions.end()) {
+        order.erase(it->second);
+        positions.erase(it);
+    }
+}
+
+
+TileResidency::TileResidency( std::shared_ptr<const TileFile> file, const ResidencyBudget &budget )
+    : m_file(std::move(file))
+    , m_ramCapacity(std::max<u64>(budget.ram / m_file->getMaxTileSpan(), 1))
+    , m_slotCount(static_cast<u32>(std::clamp<u64>(budget.vram / m_file->getMaxTileSize(), 1, std::max<u64>(m_file->getTileCount(), 1))))
+    , m_slotSize(m_file->getMaxTileSize())
+    , m_states(std::make_unique<std::atomic<u8>[]>(m_file->getTileCount()))
+    , m_neededFrame(m_file->getTileCount(), 0)
+    , m_visibleFrame(m_file->getTileCount(), 0)
+    , m_frame(0)
+    , m_lastMVP(1.0f)
+    , m_warned(false)
+    , m_classes(m_file->getTileCount(), Outside)
+    , m_vaoID(0)
+    , m_bufferID(0)
+{
+    for (u32 slot = m_slotCount; slot > 0; slot--)
+        m_freeSlots.push_back(slot - 1);
+
+    const auto stride = static_cast<GLsizei>(m_file->getStride() * sizeof(f32));
+
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, static_cast<GLsizeiptr>(m_slotCount * m_slotSize), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    // Position and, if there is one, the 4th float as time
+    glCreateVertexArrays(1, &m_vaoID);
+    glVertexArrayVertexBuffer(m_vaoID, 0, m_bufferID, 0, stride);
+    glVertexArrayAttribFormat(m_vaoID, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(m_vaoID, 0, 0);
+    glEnableVertexArrayAttrib(m_vaoID, 0);
+    if (m_file->getStride() > 3) {
+        glVertexArrayAttribFormat(m_vaoID, 1, 1, GL_FLOAT, GL_FALSE, 3 * sizeof(f32));
+        glVertexArrayAttribBinding(m_vaoID, 1, 0);
+        glEnableVertexArrayAttrib(m_vaoID, 1);
+    }
+}
+
+TileResidency::~TileResidency()
+{
+    glDeleteVertexArrays(1, &m_vaoID);
+    glDeleteBuffers(1, &m_bufferID);
+}
+
+bool TileResidency::isInView( const u64 tile, const glm::fmat4 &MVP, const f32 margin ) const
+{
+    const TileInfo &info = m_file->getInfo(tile);
+
+    // Outside if all corners are beyond the same clip plane
+    bool outside[6] = { true, true, true, true, true, true };
+    for (u32 corner = 0; corner < 8; corner++) {
+        const glm::fvec4 p = MVP * glm::fvec4((corner & 1) ? info.max[0] : info.min[0],
+                                              (corner & 2) ? info.max[1] : info.min[1],
+                                              (corner & 4) ? info.max[2] : info.min[2], 1.0f);
+        const f32 w = margin * p.w;
+        outside[0] &= p.x < -w;
+        outside[1] &= p.x > w;
+        outside[2] &= p.y < -w;
+        outside[3] &= p.y > w;
+        outside[4] &= p.z < -p.w;
+        outside[5] &= p.z > p.w;
+    }
+
+    return std::none_of(outside, outside + 6, []( const bool b ) { return b; });
+}
+
+void TileResidency::prefetch( const u64 tile )
+{
+    m_states[tile] = Loading;
+    m_ram.touch(tile);
+    m_statistics.prefetched++;
+
+    m_reader.push([this, tile] {
+        const TileInfo &info = m_file->getInfo(tile);
+        const u64 size = static_cast<u64>(info.vertexCount) * m_file->getStride() * sizeof(f32);
+        const MappedFile &mapping = m_file->getMapping();
+        m_file->advise(tile, MappedFile::Advice::WillNeed);
+
+        // Touch every page, the upload on the render thread must not wait for the disk
+        u8 sum = 0;
+        for (u64 offset = 0; offset < size; offset += MappedFile::getPageSize())
+            sum ^= *static_cast<const volatile u8 *>(mapping.getData() + info.offset + offset);
+        (void)sum;
+
+        m_states[tile].store(Resident, std::memory_order_release);
+        Invalidation::invalidate();
+    });
+}
+
+bool TileResidency::reserveRam()
+{
+    while (m_ram.order.size() >= m_ramCapacity) {
+        // Least recently needed tile which is read completely and either not needed now or on the GPU already
+        auto it = std::find_if(m_ram.order.rbegin(), m_ram.order.rend(), [this]( const u64 tile ) {
+            return (m_neededFrame[tile] != m_frame || m_tileSlots.contains(tile)) && m_states[tile].load(std::memory_order_acquire) == Resident;
+        });
+        if (it == m_ram.order.rend())
+            return false;
+
+        const u64 tile = *it;
+        m_file->advise(tile, MappedFile::Advice::DontNeed);
+        m_states[tile] = Absent;
+        m_ram.remove(tile);
+        m_statistics.evicted++;
+    }
+    return true;
+}
+
+bool TileResidency::upload( const u64 tile, const bool evict )
+{
+    if (m_freeSlots.empty()) {
+        if (!evict)
+            return false;
+
+        const auto it = std::find_if(m_vram.order.rbegin(), m_vram.order.rend(), [this]( const u64 t ) { return m_visibleFrame[t] != m_frame; });
+        if (it == m_vram.order.rend())
+            return false;
+
+        const u64 evicted = *it;
+        m_freeSlots.push_back(m_tileSlots[evicted]);
+        m_tileSlots.erase(evicted);
+        m_vram.remove(evicted);
+    }
+
+    const u32 slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+
+    const TileInfo &info = m_file->getInfo(tile);
+    glNamedBufferSubData(m_bufferID, static_cast<GLintptr>(slot * m_slotSize),
+                         static_cast<GLsizeiptr>(static_cast<u64>(info.vertexCount) * m_file->getStride() * sizeof(f32)), m_file->getVertices(tile));
+
+    m_tileSlots[tile] = slot;
+    m_vram.touch(tile);
+    m_statistics.uploaded++;
+    return true;
+}
+
+void TileResidency::update( const glm::fmat4 &MVP )
+{
+    m_frame++;
+    const glm::fmat4 predicted = (m_frame == 1) ? MVP : MVP + (MVP - m_lastMVP) * PREDICTION_FRAMES;
+    m_lastMVP = MVP;
+
+    ThreadPool::getShared().parallelFor(0, m_file->getTileCount(), CULL_GRAIN, [&]( const u64 first, const u64 last ) {
+        for (u64 t = first; t < last; t++) {
+            if (isInView(t, MVP, 1.0f))
+                m_classes[t] = Visible;
+            else if (isInView(t, MVP, NEARBY_MARGIN) || isInView(t, predicted, 1.0f))
+                m_classes[t] = Nearby;
+            else
+                m_classes[t] = Outside;
+        }
+    });
+
+    std::vector<u64> visible;
+    std::vector<u64> nearby;
+    for (u64 t = 0; t < m_file->getTileCount(); t++) {
+        if (m_classes[t] == Outside)
+            continue;
+        (m_classes[t] == Visible ? visible : nearby).push_back(t);
+        m_neededFrame[t] = m_frame;
+        if (m_classes[t] == Visible)
+            m_visibleFrame[t] = m_frame;
+    }
+
+    if (visible.size() > m_slotCount && !m_warned) {
+        std::clog << "[WARNING ][Tiles  ] " << visible.size() << " tiles visible, only " << m_slotCount << " fit into the VRAM budget" << std::endl;
+        m_warned = true;
+    }
+
+    // Reads of tiles not on the GPU, visible ones first
+    u32 reads = 0;
+    for (const std::vector<u64> *tiles : { &visible, &nearby }) {
+        for (const u64 t : *tiles) {
+            if (m_tileSlots.contains(t))
+                continue;
+            if (m_states[t] != Absent)
+                m_ram.touch(t);
+            else if (reads < MAX_READS_PER_FRAME && reserveRam()) {
+                prefetch(t);
+                reads++;
+            }
+        }
+    }
+
+    // Uploads of tiles read completely, nearby ones only into free slots
+    u32 uploads = 0;
+    m_firsts.clear();
+    m_counts.clear();
+    for (const u64 t : visible) {
+        if (!m_tileSlots.contains(t)) {
+            if (uploads >= MAX_UPLOADS_PER_FRAME || m_states[t].load(std::memory_order_acquire) != Resident || !upload(t, true))
+                continue;
+            uploads++;
+        }
+
+        m_vram.touch(t);
+        m_firsts.push_back(static_cast<GLint>(m_tileSlots[t] * (m_slotSize / (m_file->getStride() * sizeof(f32)))));
+        m_counts.push_back(static_cast<GLsizei>(m_file->getInfo(t).vertexCount));
+    }
+    for (const u64 t : nearby) {
+        if (uploads < MAX_UPLOADS_PER_FRAME && !m_tileSlots.contains(t) && m_states[t].load(std::memory_order_acquire) == Resident && upload(t, false))
+            uploads++;
+    }
+
+    m_statistics.visible = visible.size();
+    m_statistics.drawn = m_counts.size();
+    m_statistics.ramTiles = m_ram.order.size();
+    m_statistics.vramTiles = m_tileSlots.size();
+}
+
+void TileResidency::render() const
+{
+    if (m_counts.empty())
+        return;
+
+    glBindVertexArray(m_vaoID);
+    glMultiDrawArrays(GL_LINE_STRIP, m_firsts.data(), m_counts.data(), static_cast<GLsizei>(m_counts.size()));
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glad.h>
+#include <glm/glm.hpp>
+#include "defines.hpp"
+#include "IO/TileFile.hpp"
+#include "Threading/TaskQueue.hpp"
+
+
+/**
+ * Upper limits for the tiles of one TileFile held in RAM and on the GPU.
+ */
+struct ResidencyBudget {
+    u64 ram{ 1ull << 30 };
+    u64 vram{ 512ull << 20 };
+};
+
+struct ResidencyStatistics {
+    u64 visible{ 0 };   // tiles in the view frustum
+    u64 drawn{ 0 };     // visible tiles on the GPU
+    u64 ramTiles{ 0 };  // tiles resident or being read
+    u64 vramTiles{ 0 }; // occupied GPU slots
+    u64 prefetched{ 0 };
+    u64 uploaded{ 0 };
+    u64 evicted{ 0 };
+};
+
+
+/**
+ * Keeps the tiles of a TileFile near the view in RAM and the visible ones on the GPU, each within its budget.<br>
+ * A background thread reads tiles in the view, in a margin around it and in the view the camera
+ * moves towards, so the render thread only uploads tiles already in RAM. When a budget is
+ * exhausted, the least recently needed tile is dropped. Tiles not on the GPU yet are skipped
+ * until their upload, Invalidation is notified whenever a read finishes.
+ */
+class TileResidency {
+public:
+    TileResidency( std::shared_ptr<const TileFile> file, const ResidencyBudget &budget );
+
+    TileResidency( const TileResidency & ) = delete;
+
+    ~TileResidency();
+
+    /**
+     * Selects the tiles for MVP, uploads ready ones and requests the missing ones. Call once per frame.
+     */
+    void update( const glm::fmat4 &MVP );
+
+    /**
+     * Draws the visible tiles on the GPU as line strips. Expects a program with the layout of res/shader/streamed bound.
+     */
+    void render() const;
+
+    const ResidencyStatistics &getStatistics() const noexcept { return m_statistics; }
+
+private:
+    enum State : u8 {
+        Absent,
+        Loading,
+        Resident
+    };
+
+    /**
+     * Recently used tiles in front, with their position for O(1) touches.
+     */
+    struct LRU {
+        std::list<u64> order;
+        std::unordered_map<u64, std::list<u64>::iterator> positions;
+
+        bool contains( const u64 tile ) const { return positions.contains(tile); }
+        void touch( u64 tile );
+        void remove( u64 tile );
+    };
+
+    bool isInView( u64 tile, const glm::fmat4 &MVP, f32 margin ) const;
+
+    void prefetch( u64 tile );
+
+    bool reserveRam();
+
+    /**
+     * @param evict replace the least recently visible tile if no GPU slot is free
+     */
+    bool upload( u64 tile, bool evict );
+
+    std::shared_ptr<const TileFile> m_file;
+    u64 m_ramCapacity;  // tiles
+    u32 m_slotCount;    // GPU tiles
+    u64 m_slotSize;     // bytes
+
+    std::unique_ptr<std::atomic<u8>[]> m_states;
+    std::vector<u64> m_neededFrame; // last frame a tile was visible or nearby
+    std::vector<u64> m_visibleFrame;
+    u64 m_frame;
+    glm::fmat4 m_lastMVP;
+    bool m_warned; // visible tiles exceeded the VRAM budget
+
+    LRU m_ram;
+    LRU m_vram;
+    std::vector<u32> m_freeSlots;
+    std::unordered_map<u64, u32> m_tileSlots;
+    std::vector<u8> m_classes; // per tile, see update()
+
+    GLuint m_vaoID;
+    GLuint m_bufferID;
+    std::vector<GLint> m_firsts;
+    std::vector<GLsizei> m_counts;
+
+    ResidencyStatistics m_statistics;
+
+    // Declared last, joined before anything its tasks touch is destroyed
+    TaskQueue m_reader;
+};
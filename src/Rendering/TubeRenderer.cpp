@@ -0,0 +1,88 @@
+#include "TubeRenderer.hpp"
+#include "Invalidation.hpp"
+#include <algorithm>
+#include <iostream>
+
+
+TubeRenderer::TubeRenderer()
+    : m_vaoID(0)
+    , m_shaderVersion(0)
+{
+    glCreateVertexArrays(1, &m_vaoID);
+}
+
+TubeRenderer::~TubeRenderer()
+{
+    for (const Entry &entry : m_entries)
+        glDeleteBuffers(1, &entry.bufferID);
+    glDeleteVertexArrays(1, &m_vaoID);
+}
+
+u32 TubeRenderer::add( const SmoothICurve &curve, const MeshSpec::Sweep sweep, const f32 radius )
+{
+    Entry &entry = m_entries.emplace_back(Entry{ 0, 0, 0, sweep, radius });
+    upload(entry, curve);
+
+    const u64 expanded = static_cast<u64>(entry.samples) * (sweep == MeshSpec::Sweep::Tube ? 2 * (SIDES + 1) : 2) * 7 * sizeof(f32);
+    std::cout << "[  INFO  ][Sweep  ] " << (sweep == MeshSpec::Sweep::Tube ? "Tube" : "Ribbon") << " along " << entry.samples
+              << " samples, " << (static_cast<u64>(entry.samples) * sizeof(CurveFrame) >> 10) << " KiB of frames ("
+              << (expanded >> 10) << " KiB expanded)" << std::endl;
+    return static_cast<u32>(m_entries.size() - 1);
+}
+
+void TubeRenderer::update( const u32 handle, const SmoothICurve &curve )
+{
+    upload(m_entries[handle], curve);
+}
+
+void TubeRenderer::upload( Entry &entry, const SmoothICurve &curve )
+{
+    entry.samples = curve.getDrawLength();
+    const auto size = static_cast<GLsizeiptr>(static_cast<u64>(entry.samples) * sizeof(CurveFrame));
+
+    if (size > entry.capacity) {
+        entry.capacity = std::max(size, static_cast<GLsizeiptr>(sizeof(CurveFrame)));
+        glDeleteBuffers(1, &entry.bufferID);
+        glCreateBuffers(1, &entry.bufferID);
+        glNamedBufferStorage(entry.bufferID, entry.capacity, nullptr, GL_MAP_WRITE_BIT);
+    }
+
+    if (entry.samples > 0) {
+        // The curve writes straight into the buffer, without a staging copy
+        void *frames = glMapNamedBufferRange(entry.bufferID, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        curve.writeFrames(static_cast<CurveFrame *>(frames));
+        glUnmapNamedBuffer(entry.bufferID);
+    }
+
+    Invalidation::invalidate();
+}
+
+void TubeRenderer::render( Shader &shader )
+{
+    if (shader.getVersion() != m_shaderVersion) {
+        m_shaderVersion = shader.getVersion();
+        m_radiusUniform = shader.getUniform<f32>("radius");
+        m_sidesUniform = shader.getUniform<u32>("sides");
+    }
+
+    glBindVertexArray(m_vaoID);
+    for (const Entry &entry : m_entries) {
+        if (entry.samples < 2)
+            continue;
+
+        const bool tube = entry.sweep == MeshSpec::Sweep::Tube;
+        shader.set(m_radiusUniform, entry.radius);
+        shader.set(m_sidesUniform, tube ? SIDES : 0);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CURVE_FRAME_BINDING, entry.bufferID);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, tube ? 2 * (SIDES + 1) : 4, static_cast<GLsizei>(entry.samples - 1));
+    }
+}
+
+u64 TubeRenderer::getSampleCount() const noexcept
+{
+    u64 samples = 0;
+    for (const Entry &entry : m_entries)
+        samples += entry.samples;
+    return samples;
+}
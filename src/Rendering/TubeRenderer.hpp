@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include <glad.h>
+#include "defines.hpp"
+#include "3D/Scene.hpp"
+#include "3D/Interpolation/SmoothICurve.hpp"
+#include "Rendering/Shader.hpp"
+
+
+// Shader storage binding of the CurveFrame array of the drawn curve
+constexpr GLuint CURVE_FRAME_BINDING = 1;
+
+/**
+ * Draws curves as tubes or ribbons swept along their orthonormal frames.<br>
+ * Only one CurveFrame per sample is uploaded, 24 bytes. The vertex shader builds the geometry from it:
+ * every segment between two samples is one instance, a triangle strip around the tube or across the ribbon,
+ * whose vertices are placed by gl_VertexID. A tube of SIDES sides would take 2 * (SIDES + 1) vertices
+ * of position, normal and time per sample when expanded on the CPU.
+ */
+class TubeRenderer {
+public:
+    // Around a tube, even, so a normal flipping at an inflection point maps the ring onto itself
+    static constexpr u32 SIDES = 12;
+
+    TubeRenderer();
+
+    TubeRenderer( const TubeRenderer & ) = delete;
+
+    ~TubeRenderer();
+
+    /**
+     * Uploads the frames of curve.
+     * @param sweep Tube or Ribbon
+     * @return handle for later updates
+     */
+    u32 add( const SmoothICurve &curve, MeshSpec::Sweep sweep, f32 radius );
+
+    /**
+     * Re-uploads the frames of curve, its buffer is reallocated if it grew.
+     */
+    void update( u32 handle, const SmoothICurve &curve );
+
+    /**
+     * Expects a program with the layout of res/shader/tube bound.
+     */
+    void render( Shader &shader );
+
+    bool isEmpty() const noexcept { return m_entries.empty(); }
+
+    /**
+     * @return frames uploaded of all curves
+     */
+    u64 getSampleCount() const noexcept;
+
+private:
+    struct Entry {
+        GLuint bufferID;
+        GLsizeiptr capacity;
+        u32 samples;
+        MeshSpec::Sweep sweep;
+        f32 radius;
+    };
+
+    void upload( Entry &entry, const SmoothICurve &curve );
+
+    std::vector<Entry> m_entries;
+    GLuint m_vaoID; // without attributes, core profiles need one bound to draw
+
+    u64 m_shaderVersion; // of the program the uniforms below belong to
+    Uniform<f32> m_radiusUniform;
+    Uniform<u32> m_sidesUniform;
+};
@@ -0,0 +1,104 @@
+#include "VertexArena.hpp"
+
+
+VertexArena::VertexArena( const GLsizeiptr capacity )
+    : m_bufferID(0)
+    , m_capacity(capacity)
+    , m_used(0)
+    , m_free{ { 0, capacity } }
+{
+    glCreateBuffers(1, &m_bufferID);
+    glNamedBufferStorage(m_bufferID, m_capacity, nullptr, GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT);
+}
+
+VertexArena::~VertexArena()
+{
+    glDeleteBuffers(1, &m_bufferID);
+}
+
+bool VertexArena::allocate( const GLsizeiptr size, const GLsizeiptr alignment, ArenaRange &range )
+{
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+        const GLintptr misalignment = it->offset % alignment;
+        const GLintptr start = (misalignment == 0) ? it->offset : it->offset + alignment - misalignment;
+        const GLintptr end = it->offset + it->size;
+        if (start + size > end)
+            continue;
+
+        range = { start, size };
+        m_used += size;
+
+        // Split the free range into the padding in front and the remainder behind the allocation
+        const ArenaRange front{ it->offset, start - it->offset };
+        const ArenaRange back{ start + size, end - (start + size) };
+        it = m_free.erase(it);
+        if (back.size > 0)
+            it = m_free.insert(it, back);
+        if (front.size > 0)
+            m_free.insert(it, front);
+        return true;
+    }
+
+    return false;
+}
+
+void VertexArena::release( const ArenaRange &range )
+{
+    if (range.size == 0)
+        return;
+
+    m_used -= range.size;
+
+    auto it = m_free.begin();
+    while (it != m_free.end() && it->offset < range.offset)
+        ++it;
+    it = m_free.insert(it, range);
+
+    // Coalesce with the following range
+    if (const auto next = it + 1; next != m_free.end() && it->offset + it->size == next->offset) {
+        it->size += next->size;
+        m_free.erase(next);
+    }
+
+    // Coalesce with the preceding range
+    if (it != m_free.begin()) {
+        const auto prev = it - 1;
+        if (prev->offset + prev->size == it->offset) {
+            prev->size += it->size;
+            m_free.erase(it);
+        }
+    }
+}
+
+void VertexArena::grow( const GLsizeiptr newCapacity )
+{
+    if (newCapacity <= m_capacity)
+        return;
+
+    GLuint newBufferID = 0;
+    glCreateBuffers(1, &newBufferID);
+    glNamedBufferStorage(newBufferID, newCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT);
+    glCopyNamedBufferSubData(m_bufferID, newBufferID, 0, 0, m_capacity);
+    glDeleteBuffers(1, &m_bufferID);
+
+    release({ m_capacity, newCapacity - m_capacity });
+    m_used += newCapacity - m_capacity; // release() treats the appended space as previously used
+
+    m_bufferID = newBufferID;
+    m_capacity = newCapacity;
+}
+
+void VertexArena::upload( const ArenaRange &range, const void *data ) const
+{
+    glNamedBufferSubData(m_bufferID, range.offset, range.size, data);
+}
+
+void *VertexArena::map( const ArenaRange &range ) const
+{
+    return glMapNamedBufferRange(m_bufferID, range.offset, range.size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void VertexArena::unmap() const
+{
+    glUnmapNamedBuffer(m_bufferID);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include <glad.h>
+#include "defines.hpp"
+
+
+struct ArenaRange {
+    GLintptr offset{ 0 };
+    GLsizeiptr size{ 0 };
+};
+
+
+/**
+ * One large immutable GPU buffer from which vertex data of many meshes is sub-allocated.<br>
+ * Free space is tracked as a sorted list of ranges (first fit, neighbours are coalesced on release).
+ * Offsets of live allocations stay valid when the arena grows, only the buffer ID changes.
+ */
+class VertexArena {
+public:
+    explicit VertexArena( GLsizeiptr capacity );
+
+    VertexArena( const VertexArena & ) = delete;
+
+    ~VertexArena();
+
+    /**
+     * @param size requested bytes
+     * @param alignment the returned offset is a multiple of alignment (need not be a power of two)
+     * @param range receives the allocated range
+     * @return false if no free range is large enough
+     */
+    bool allocate( GLsizeiptr size, GLsizeiptr alignment, ArenaRange &range );
+
+    void release( const ArenaRange &range );
+
+    /**
+     * Reallocates the buffer with at least newCapacity bytes and copies all content on the GPU.
+     */
+    void grow( GLsizeiptr newCapacity );
+
+    void upload( const ArenaRange &range, const void *data ) const;
+
+    /**
+     * Maps range for writing, its previous content is discarded. Call unmap() before drawing.
+     */
+    void *map( const ArenaRange &range ) const;
+
+    void unmap() const;
+
+    constexpr GLuint getID() const noexcept { return m_bufferID; }
+    constexpr GLsizeiptr getCapacity() const noexcept { return m_capacity; }
+    constexpr GLsizeiptr getUsed() const noexcept { return m_used; }
+
+private:
+    GLuint m_bufferID;
+    GLsizeiptr m_capacity;
+    GLsizeiptr m_used;
+    std::vector<ArenaRange> m_free;
+};
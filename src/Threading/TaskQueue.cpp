@@ -0,0 +1,49 @@
+#include "TaskQueue.hpp"
+
+
+TaskQueue::TaskQueue( std::function<void()> onStart, std::function<void()> onStop )
+    : m_stop(false)
+    , m_thread(&TaskQueue::loop, this, std::move(onStart), std::move(onStop))
+{}
+
+TaskQueue::~TaskQueue()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void TaskQueue::push( std::function<void()> task )
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void TaskQueue::loop( const std::function<void()> &onStart, const std::function<void()> &onStop )
+{
+    if (onStart)
+        onStart();
+
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty())
+                break; // stopped and drained
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+
+    if (onStop)
+        onStop();
+}
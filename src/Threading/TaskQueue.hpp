@@ -0,0 +1,33 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * A single background thread working off tasks in submission order.<br>
+ * onStart/onStop run on the worker thread itself, e.g. to make a GL context current.
+ */
+class TaskQueue {
+public:
+    explicit TaskQueue( std::function<void()> onStart = { }, std::function<void()> onStop = { } );
+
+    TaskQueue( const TaskQueue & ) = delete;
+
+    // Finishes all queued tasks and joins the thread
+    ~TaskQueue();
+
+    void push( std::function<void()> task );
+
+private:
+    void loop( const std::function<void()> &onStart, const std::function<void()> &onStop );
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stop;
+    std::thread m_thread;
+};
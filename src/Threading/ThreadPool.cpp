@@ -0,0 +1,120 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+ThreadPool::ThreadPool( const u32 threadCount )
+    : m_stop(false)
+{
+    m_threads.reserve(threadCount);
+    for (u32 i = 0; i < threadCount; i++)
+        m_threads.emplace_back(&ThreadPool::loop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread &thread : m_threads)
+        thread.join();
+}
+
+// Workers the shared pool is created with, fixed once it was
+static std::mutex s_sharedMutex;
+static u32 s_sharedThreadCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+static bool s_sharedCreated = false;
+
+ThreadPool &ThreadPool::getShared()
+{
+    static ThreadPool pool([] {
+        std::lock_guard lock(s_sharedMutex);
+        s_sharedCreated = true;
+        return s_sharedThreadCount;
+    }());
+    return pool;
+}
+
+bool ThreadPool::setSharedThreadCount( const u32 threadCount )
+{
+    std::lock_guard lock(s_sharedMutex);
+    if (s_sharedCreated)
+        return false;
+
+    s_sharedThreadCount = threadCount;
+    return true;
+}
+
+void ThreadPool::loop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor( const u64 begin, const u64 end, const u64 grain, const std::function<void( u64, u64 )> &body )
+{
+    if (end <= begin)
+        return;
+
+    // A few chunks per thread balance uneven work without drowning in scheduling
+    const u64 count = end - begin;
+    const u64 maxChunks = std::max<u64>(count / std::max<u64>(grain, 1), 1);
+    const u64 targetChunks = std::min<u64>(maxChunks, 4ull * getConcurrency());
+    const u64 chunkSize = (count + targetChunks - 1) / targetChunks;
+    const u64 chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount == 1 || m_threads.empty()) {
+        body(begin, end);
+        return;
+    }
+
+    struct Job {
+        std::atomic<u64> next{ 0 };
+        std::atomic<u64> done{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    const auto job = std::make_shared<Job>();
+
+    // Helpers starting after the last chunk was taken return without touching body
+    const auto work = [job, begin, end, chunkCount, chunkSize, &body] {
+        u64 processed = 0;
+        for (u64 chunk = job->next++; chunk < chunkCount; chunk = job->next++) {
+            const u64 first = begin + chunk * chunkSize;
+            body(first, std::min(first + chunkSize, end));
+            processed++;
+        }
+
+        if (processed > 0 && job->done.fetch_add(processed) + processed == chunkCount) {
+            std::lock_guard lock(job->mutex);
+            job->finished.notify_all();
+        }
+    };
+
+    const u64 helpers = std::min<u64>(m_threads.size(), chunkCount - 1);
+    {
+        std::lock_guard lock(m_mutex);
+        for (u64 i = 0; i < helpers; i++)
+            m_tasks.emplace_back(work);
+    }
+    m_condition.notify_all();
+
+    work();
+
+    std::unique_lock lock(job->mutex);
+    job->finished.wait(lock, [&job, chunkCount] { return job->done == chunkCount; });
+}
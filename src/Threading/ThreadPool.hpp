@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "defines.hpp"
+
+
+/**
+ * Fixed set of worker threads for data-parallel loops.<br>
+ * parallelFor() splits a range into chunks which the workers and the calling thread
+ * pull until none are left, so nested calls from inside a chunk cannot deadlock.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool( u32 threadCount = std::max(std::thread::hardware_concurrency(), 1u) - 1 );
+
+    ThreadPool( const ThreadPool & ) = delete;
+
+    ~ThreadPool();
+
+    /**
+     * Calls body(first, last) for consecutive chunks [first, last) covering [begin, end)
+     * and returns once all of them are done.
+     * @param grain minimum number of elements per chunk
+     */
+    void parallelFor( u64 begin, u64 end, u64 grain, const std::function<void( u64, u64 )> &body );
+
+    /**
+     * @return workers plus the calling thread
+     */
+    u32 getConcurrency() const noexcept { return static_cast<u32>(m_threads.size()) + 1; }
+
+    /**
+     * Pool shared by everything that has no reason for its own, created on first use.
+     */
+    static ThreadPool &getShared();
+
+    /**
+     * Workers of the shared pool, instead of one less than the hardware threads, e.g. to limit a tool's CPU use.
+     * @return false if the shared pool was already created, it keeps its workers then
+     */
+    static bool setSharedThreadCount( u32 threadCount );
+
+private:
+    void loop();
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stop;
+    std::vector<std::thread> m_threads;
+};
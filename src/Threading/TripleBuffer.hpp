@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include "defines.hpp"
+
+
+/**
+ * Wait-free handoff of the latest value from one producer thread to one consumer thread.<br>
+ * The producer fills getWriteBuffer() and publishes it, the consumer picks up the most recent
+ * publication with fetch(). Neither side ever blocks the other, values published in between
+ * two fetches are skipped. The write buffer is recycled and has to be overwritten completely.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : m_middle(1)
+        , m_write(0)
+        , m_read(2)
+    {}
+
+    TripleBuffer( const TripleBuffer & ) = delete;
+
+    T &getWriteBuffer() noexcept { return m_buffers[m_write]; }
+
+    void publish() noexcept
+    {
+        m_write = m_middle.exchange(m_write | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * @return true if a value was published since the last fetch
+     */
+    bool fetch() noexcept
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+
+        m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T &getReadBuffer() const noexcept { return m_buffers[m_read]; }
+
+private:
+    static constexpr u8 INDEX = 0x3;
+    static constexpr u8 FRESH = 0x4;
+
+    T m_buffers[3];
+    std::atomic<u8> m_middle; // index of the buffer in between, FRESH if not fetched yet
+    u8 m_write;
+    u8 m_read;
+};
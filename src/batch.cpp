@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IO/CSVReader.hpp"
+#include "IO/GeometryWriter.hpp"
+#include "3D/CoordinateSystem.hpp"
+#include "3D/MeshSpec.hpp"
+#include "3D/Interpolation/SmoothICurve.hpp"
+#include "Threading/ThreadPool.hpp"
+
+
+/**
+ * One line of the job list:
+ * <pre>
+ * INPUT OUTPUT [key=value ...]
+ * </pre>
+ * with the keys T, X, Y, Z (column or expression), dt (time scaling or uniform delta t), kind (curve|mesh),
+ * system, cyclic, tolerance, frames, parent and parent-cyclic. Values with spaces are quoted in single quotes.<br>
+ * Columns and expressions given for T, X, Y or Z have to resolve, the job fails otherwise. Only the columns not given
+ * may be missing in INPUT, they default to uniform time steps of dt and coordinates 0.
+ */
+struct BatchJob {
+    MeshSpec spec;      // spec.file is the input, only T/X/Y/Z, kind, system, cyclic and tolerance are used
+    std::string output; // .csv or binary, see GeometryWriter
+    std::string parent; // CSV file of the curve (columns T, X, Y, Z) the job is placed along, empty for none
+    bool parentCyclic = false;
+    bool frames = false; // curves only: append tangent, normal and binormal of every sample
+    std::vector<std::string> columns; // of T/X/Y/Z given in the job line
+};
+
+struct BatchOptions {
+    std::string jobs;
+    u32 threads = std::max(std::thread::hardware_concurrency(), 1u);
+    u64 memory = 1024ull << 20;
+};
+
+// Rows assembled per write to the GeometryWriter
+constexpr u64 WRITE_BLOCK = 4096;
+
+// Peak memory of a job relative to its input: the text is kept while the columns are parsed, plus the vertices
+constexpr u64 JOB_MEMORY_FACTOR = 2;
+
+
+/**
+ * Blocks jobs until the memory they are estimated to need is free. A job larger than the whole budget runs alone.
+ */
+class MemoryBudget {
+public:
+    explicit MemoryBudget( const u64 bytes ) : m_limit(bytes), m_used(0) {}
+
+    void acquire( const u64 bytes )
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this, bytes] { return m_used == 0 || m_used + bytes <= m_limit; });
+        m_used += bytes;
+    }
+
+    void release( const u64 bytes )
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_used -= bytes;
+        }
+        m_condition.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    u64 m_limit;
+    u64 m_used;
+};
+
+
+static std::mutex s_logMutex;
+
+/**
+ * One line to std::cout, or std::clog if error, not interleaved with those of other jobs.
+ */
+template<typename... Args>
+static void log( const bool error, const Args &...args )
+{
+    std::lock_guard lock(s_logMutex);
+    std::ostream &stream = error ? std::clog : std::cout;
+    stream << (error ? "[ ERROR  ][Batch  ] " : "[  INFO  ][Batch  ] ");
+    (stream << ... << args) << std::endl;
+}
+
+
+/**
+ * Splits a line at whitespace outside of single quotes, which are removed.
+ */
+static std::vector<std::string> tokenize( const std::string &line )
+{
+    std::vector<std::string> tokens;
+    std::string token;
+    bool quoted = false;
+    bool pending = false;
+    for (const char c : line) {
+        if (c == '\'') {
+            quoted = !quoted;
+            pending = true;
+        }
+        else if (!quoted && std::isspace(static_cast<unsigned char>(c))) {
+            if (pending)
+                tokens.push_back(std::move(token));
+            token.clear();
+            pending = false;
+        }
+        else {
+            token += c;
+            pending = true;
+        }
+    }
+    if (pending)
+        tokens.push_back(std::move(token));
+    return tokens;
+}
+
+static bool parseJob( const std::vector<std::string> &tokens, BatchJob &job, std::string &error )
+{
+    if (tokens.size() < 2) {
+        error = "expected INPUT OUTPUT [key=value ...]";
+        return false;
+    }
+
+    job.spec.file = tokens[0];
+    job.spec.kind = MeshSpec::Kind::Curve;
+    job.output = tokens[1];
+
+    for (u64 i = 2; i < tokens.size(); i++) {
+        const u64 separator = tokens[i].find('=');
+        if (separator == std::string::npos) {
+            error = "expected key=value instead of " + tokens[i];
+            return false;
+        }
+
+        const std::string key = tokens[i].substr(0, separator);
+        const std::string value = tokens[i].substr(separator + 1);
+        try {
+            if (key == "T")
+                job.spec.T.first = job.columns.emplace_back(value);
+            else if (key == "X")
+                job.spec.X.first = job.columns.emplace_back(value);
+            else if (key == "Y")
+                job.spec.Y.first = job.columns.emplace_back(value);
+            else if (key == "Z")
+                job.spec.Z.first = job.columns.emplace_back(value);
+            else if (key == "dt")
+                job.spec.T.second = std::stof(value);
+            else if (key == "tolerance")
+                job.spec.tolerance = std::stof(value);
+            else if (key == "cyclic")
+                job.spec.cyclic = value != "0";
+            else if (key == "frames")
+                job.frames = value != "0";
+            else if (key == "parent")
+                job.parent = value;
+            else if (key == "parent-cyclic")
+                job.parentCyclic = value != "0";
+            else if (key == "kind" && (value == "curve" || value == "mesh"))
+                job.spec.kind = (value == "curve") ? MeshSpec::Kind::Curve : MeshSpec::Kind::Mesh;
+            else if (const CoordinateTransform *transform = CoordinateTransforms::find(value); key == "system" && transform)
+                job.spec.system = transform->system;
+            else {
+                error = "unknown " + tokens[i];
+                return false;
+            }
+        }
+        catch (const std::exception &) {
+            error = "no number in " + tokens[i];
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readJobs( const std::string &path, std::vector<BatchJob> &jobs )
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::clog << "[ ERROR  ][Batch  ] Cannot read \"" << path << '"' << std::endl;
+        return false;
+    }
+
+    std::string line;
+    for (u32 number = 1; std::getline(file, line); number++) {
+        const std::vector<std::string> tokens = tokenize(line);
+        if (tokens.empty() || tokens[0].starts_with('#'))
+            continue;
+
+        BatchJob job;
+        std::string error;
+        if (!parseJob(tokens, job, error)) {
+            std::clog << "[ ERROR  ][Batch  ] " << path << ':' << number << ": " << error << std::endl;
+            return false;
+        }
+        jobs.push_back(std::move(job));
+    }
+    return true;
+}
+
+
+/**
+ * Inverse of the octahedral mapping of CurveFrame.
+ */
+static glm::fvec3 unpackDirection( const u32 packed )
+{
+    const f32 x = std::max(static_cast<f32>(static_cast<i16>(packed & 0xFFFF)) / 32767.0f, -1.0f);
+    const f32 y = std::max(static_cast<f32>(static_cast<i16>(packed >> 16)) / 32767.0f, -1.0f);
+
+    glm::fvec3 v(x, y, 1.0f - std::abs(x) - std::abs(y));
+    if (v.z < 0.0f) {
+        v.x = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+        v.y = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+    }
+    return glm::normalize(v);
+}
+
+/**
+ * Streams the samples of mesh, and their frames if given, to writer in blocks of WRITE_BLOCK rows.
+ */
+static void writeSamples( GeometryWriter &writer, const std::vector<f32> &vertices, const u32 stride,
+                          const std::vector<CurveFrame> &frames, const u64 count )
+{
+    const u32 columns = stride + (frames.empty() ? 0 : 9);
+    std::vector<f32> block(WRITE_BLOCK * columns);
+
+    for (u64 first = 0; first < count; first += WRITE_BLOCK) {
+        const u64 rows = std::min(WRITE_BLOCK, count - first);
+        for (u64 r = 0; r < rows; r++) {
+            f32 *row = &block[r * columns];
+            std::copy_n(&vertices[(first + r) * stride], stride, row);
+            if (frames.empty())
+                continue;
+
+            const glm::fvec3 T = unpackDirection(frames[first + r].tangent);
+            const glm::fvec3 N = unpackDirection(frames[first + r].normal);
+            const glm::fvec3 B = glm::cross(T, N);
+            for (u32 c = 0; c < 3; c++) {
+                row[stride + c] = T[c];
+                row[stride + 3 + c] = N[c];
+                row[stride + 6 + c] = B[c];
+            }
+        }
+        writer.write(block.data(), rows);
+    }
+}
+
+struct JobResult {
+    u64 rows = 0;    // read
+    u64 samples = 0; // written
+    bool ok = false;
+};
+
+static JobResult runJob( const BatchJob &job, const Mesh *parent )
+{
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    JobResult result;
+
+    CSVFile csv(job.spec.file);
+    if (!csv.read(',')) {
+        log(true, job.spec.file, ": cannot read");
+        return result;
+    }
+    result.rows = csv.getRowCount();
+
+    for (const std::string &column : job.columns) {
+        const std::vector<f32> *values;
+        if (!csv.resolveValues(column, values) || !values) {
+            log(true, job.spec.file, ": no values for <", column, ">");
+            return result;
+        }
+    }
+
+    const std::shared_ptr<const Mesh> mesh = buildMesh(job.spec, csv, parent, job.spec.system);
+    if (!mesh) {
+        log(true, job.spec.file, ": cannot build");
+        return result;
+    }
+    const auto *curve = dynamic_cast<const SmoothICurve *>(mesh.get());
+
+    // Curves write their resampled polyline, meshes their data points
+    result.samples = mesh->getDrawLength();
+    std::vector<f32> vertices(result.samples * mesh->getStride());
+    mesh->writeDrawVertices(vertices.data());
+
+    std::vector<CurveFrame> frames;
+    if (job.frames && curve && result.samples >= 2) {
+        frames.resize(result.samples);
+        curve->writeFrames(frames.data());
+    }
+
+    std::vector<std::string> columns{ "X", "Y", "Z", "T" };
+    columns.resize(mesh->getStride(), "");
+    for (u32 c = 4; c < mesh->getStride(); c++)
+        columns[c] = "C" + std::to_string(c);
+    if (!frames.empty())
+        columns.insert(columns.end(), { "TX", "TY", "TZ", "NX", "NY", "NZ", "BX", "BY", "BZ" });
+
+    GeometryWriter writer(job.output, GeometryWriter::formatOf(job.output), columns);
+    writeSamples(writer, vertices, mesh->getStride(), frames, result.samples);
+    result.ok = writer.close();
+
+    const f64 seconds = std::chrono::duration<f64>(clock::now() - start).count();
+    if (result.ok) {
+        log(false, job.spec.file, " -> ", job.output, ": ", result.rows, " rows, ", result.samples, " samples in ",
+            seconds * 1e3, " ms (", result.rows / seconds * 1e-6, " M rows/s)");
+    }
+    return result;
+}
+
+
+static bool parseOptions( const int argc, char **argv, BatchOptions &options )
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (arg[0] != '-' && options.jobs.empty()) {
+            options.jobs = arg;
+            continue;
+        }
+        if (!value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        i++;
+
+        try {
+            if (std::strcmp(arg, "--threads") == 0) {
+                options.threads = std::max(std::stoi(value), 1);
+            }
+            else if (std::strcmp(arg, "--memory") == 0) {
+                options.memory = std::stoull(value) << 20;
+            }
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &) {
+            std::cerr << "No number for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    return !options.jobs.empty();
+}
+
+
+/**
+ * Builds curves and meshes from many CSV files without a window or GL context, e.g. for downstream tools.<br>
+ * Jobs run on a pool of --threads, at most --memory MiB worth of them at once, parents are built once and shared.
+ */
+int main( int argc, char **argv )
+{
+    BatchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " JOBS [--threads N] [--memory MB]" << std::endl;
+        return 1;
+    }
+
+    // Jobs run on the shared pool, like the parsing, resampling and placement within them, so --threads bounds all of it
+    ThreadPool::setSharedThreadCount(options.threads - 1);
+
+    std::vector<BatchJob> jobs;
+    if (!readJobs(options.jobs, jobs))
+        return 1;
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    ThreadPool &pool = ThreadPool::getShared();
+
+    // Parents first, each built once however many jobs are placed along it
+    std::map<std::pair<std::string, bool>, std::shared_ptr<const Mesh>> parents;
+    for (const BatchJob &job : jobs) {
+        if (!job.parent.empty())
+            parents[{ job.parent, job.parentCyclic }] = nullptr;
+    }
+    std::vector<std::pair<const std::pair<std::string, bool>, std::shared_ptr<const Mesh>> *> pending;
+    for (auto &parent : parents)
+        pending.push_back(&parent);
+
+    pool.parallelFor(0, pending.size(), 1, [&]( const u64 first, const u64 last ) {
+        for (u64 i = first; i < last; i++) {
+            auto &[key, mesh] = *pending[i];
+            CSVFile csv(key.first);
+            if (!csv.read(',')) {
+                log(true, key.first, ": cannot read parent");
+                continue;
+            }
+
+            MeshSpec spec;
+            spec.kind = MeshSpec::Kind::Curve;
+            spec.cyclic = key.second;
+            mesh = buildMesh(spec, csv, nullptr, spec.system);
+            if (!mesh)
+                log(true, key.first, ": cannot build parent");
+        }
+    });
+
+    MemoryBudget budget(options.memory);
+    std::vector<JobResult> results(jobs.size());
+    pool.parallelFor(0, jobs.size(), 1, [&]( const u64 first, const u64 last ) {
+        for (u64 i = first; i < last; i++) {
+            const BatchJob &job = jobs[i];
+            // Read only from here on, at() instead of operator[], which may insert
+            const Mesh *parent = job.parent.empty() ? nullptr : parents.at({ job.parent, job.parentCyclic }).get();
+            if (!job.parent.empty() && !parent)
+                continue;
+
+            std::error_code error;
+            const u64 bytes = JOB_MEMORY_FACTOR * std::filesystem::file_size(job.spec.file, error);
+
+            budget.acquire(bytes);
+            results[i] = runJob(job, parent);
+            budget.release(bytes);
+        }
+    });
+
+    u64 rows = 0;
+    u64 failed = 0;
+    for (const JobResult &result : results) {
+        rows += result.rows;
+        failed += result.ok ? 0 : 1;
+    }
+
+    const f64 seconds = std::chrono::duration<f64>(clock::now() - start).count();
+    std::cout << "[  INFO  ][Batch  ] " << jobs.size() - failed << " of " << jobs.size() << " jobs done in " << seconds << " s, "
+              << rows << " rows (" << rows / seconds * 1e-6 << " M rows/s) on " << options.threads << " threads" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
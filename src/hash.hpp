@@ -0,0 +1,24 @@
+#pragma once
+#include <string_view>
+
+#include "defines.hpp"
+
+
+// Start of every key extended by hashBytes
+constexpr u64 HASH_BASIS = 0xCBF29CE484222325ull; // FNV-1a offset basis
+
+/**
+ * Extends key by bytes with FNV-1a, e.g. for cache keys of files or shader sources.<br>
+ * The length is hashed as well, so "ab" + "c" differs from "a" + "bc".
+ */
+inline u64 hashBytes( u64 key, const std::string_view bytes ) noexcept
+{
+    for (const char c : bytes) {
+        key ^= static_cast<u8>(c);
+        key *= 0x100000001B3ull; // FNV-1a prime
+    }
+
+    key ^= bytes.size();
+    key *= 0x100000001B3ull;
+    return key;
+}
@@ -8,178 +8,602 @@
 #include <glad.h>
 
 #include "GUI/glWindow.hpp"
+#include "GUI/HeadlessContext.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include "IO/CSVReader.hpp"
+#include "IO/TileFile.hpp"
+#include "IO/FrameWriter.hpp"
+#include "IO/ReloadService.hpp"
+#include "3D/Scene.hpp"
+#include "3D/OrbitCamera.hpp"
 #include "3D/Interpolation/SmoothICurve.hpp"
-#include "Rendering/Shader.hpp"
+#include "Rendering/Framebuffer.hpp"
+#include "Rendering/FrameReadback.hpp"
+#include "Rendering/SceneView.hpp"
+#include "Rendering/Invalidation.hpp"
+#include "Rendering/Profiler.hpp"
+#include "GUI/ProfilerOverlay.hpp"
+#include "Threading/TripleBuffer.hpp"
 //#include <glm/glm.hpp>
 //#include <glm/ext.hpp>
 #include <glm/gtx/transform.hpp>
 
 
-static void render( glWindow &window, const glm::fmat4 &MVP, Shader &shader, const std::vector<Mesh *> &meshes )
+struct Options {
+    bool headless = false;
+    bool onDemand = false;
+    bool densityCpu = false;
+    u64 frames = 120;
+    int width = 1280;
+    int height = 720;
+    int samples = 0;
+    std::string output = "frames";
+    FrameFormat format = FrameFormat::Png;
+    std::string signal;
+    std::string signalValue = "Y";
+    std::string density;
+    std::string snapshot;
+    std::string tiles;
+    std::string makeTiles;
+    ResidencyBudget budget;
+    std::string stream;
+    MeshSpec::Sweep sweep = MeshSpec::Sweep::Line; // of the spiral
+    f32 radius = 0.01f;
+};
+
+
+/**
+ * Everything one frame is drawn from. Published by the update thread, read by the render thread.
+ */
+struct ViewSnapshot {
+    u64 sequence;
+    u64 viewVersion; // changes only if frame does
+    f64 time;
+    FrameData frame;
+    InputState input;
+};
+
+// Ticks per second of the update thread, independent of the display rate
+constexpr f64 UPDATE_RATE = 240.0;
+
+// Camera animation in radians per second and mouse drag in radians per pixel
+constexpr f64 ORBIT_SPEED = 0.125;
+constexpr f64 DRAG_SPEED = 0.005;
+
+// Where envelope pyramids of --signal files are kept between runs
+constexpr const char *ENVELOPE_CACHE = "cache/envelopes";
+
+
+static f64 now()
 {
-    shader.setMatrixFloat4("MVP", MVP);
-    shader.Bind();
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration<f64>(steady_clock::now() - start).count();
+}
 
-    for (const Mesh *mesh : meshes)
-        mesh->render();
+static void sleepUntil( const f64 time )
+{
+    std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::duration<f64>(time - now()));
 }
 
 
-Mesh createGridPlane( const int S, const f32 spacing = 1.0f )
+/**
+ * The demo scene, options.sweep draws the spiral as tube or ribbon of options.radius and options.signal,
+ * a CSV file with column T, is added as a SignalEnvelope of options.signalValue.
+ * options.density, a CSV file with columns X, Y, Z, is added as point cloud drawn as density image.
+ * With options.snapshot, meshes unchanged since the previous run are restored from it instead of built.
+ */
+static bool buildScene( Scene &scene, const Options &options )
 {
-    std::vector<f32> vertices;
-    for (int i = -S; i < S; i++) {
-        vertices.push_back(i * spacing);
-        vertices.push_back(0.0f);
-        vertices.push_back(-S * spacing);
+    MeshSpec circle;
+    circle.file = "res/meshes/geodesicSphere.csv";
+    circle.kind = MeshSpec::Kind::Curve;
+    circle.cyclic = true;
+    const u32 circleIndex = scene.add(circle);
+
+    MeshSpec spiral;
+    spiral.file = "res/meshes/spiral.csv";
+    spiral.kind = MeshSpec::Kind::Curve;
+    spiral.parent = static_cast<i32>(circleIndex);
+    spiral.cyclic = true;
+    spiral.sweep = options.sweep;
+    spiral.radius = options.radius;
+    const u32 spiralIndex = scene.add(spiral);
+
+    MeshSpec tbnSpiral;
+    tbnSpiral.file = "res/meshes/ONF.csv";
+    tbnSpiral.parent = static_cast<i32>(spiralIndex);
+    tbnSpiral.mode = GL_LINES;
+    scene.add(tbnSpiral);
+
+    if (!options.density.empty()) {
+        MeshSpec cloud;
+        cloud.file = options.density;
+        cloud.mode = GL_POINTS;
+        cloud.density = true;
+        scene.add(cloud);
+    }
 
-        vertices.push_back(i * spacing);
-        vertices.push_back(0.0f);
-        vertices.push_back(S * spacing);
+    if (!options.signal.empty()) {
+        MeshSpec envelope;
+        envelope.file = options.signal;
+        envelope.kind = MeshSpec::Kind::Signal;
+        envelope.Y.first = options.signalValue;
+        envelope.envelopeCache = ENVELOPE_CACHE;
+        scene.add(envelope);
+    }
 
-        vertices.push_back(-S * spacing);
-        vertices.push_back(0.0f);
-        vertices.push_back(i * spacing);
+    return options.snapshot.empty() ? scene.load() : scene.open(options.snapshot);
+}
 
-        vertices.push_back(S * spacing);
-        vertices.push_back(0.0f);
-        vertices.push_back(i * spacing);
 
+static FrameData getFrame( const OrbitCamera &camera, const f64 time, const int width, const int height )
+{
+    const auto w = static_cast<f32>(width);
+    const auto h = static_cast<f32>(height);
+    return { camera.getViewProjection(width, height), { w, h, 1.0f / w, 1.0f / h }, static_cast<f32>(time) };
+}
 
-        vertices.push_back(i * spacing);
-        vertices.push_back(-S * spacing);
-        vertices.push_back(0.0f);
 
-        vertices.push_back(i * spacing);
-        vertices.push_back(S * spacing);
-        vertices.push_back(0.0f);
+/**
+ * Update thread: turns input into camera movement and publishes a ViewSnapshot whenever something changed.<br>
+ * While animating it ticks UPDATE_RATE times a second, otherwise it sleeps until the next input.
+ * @param window source of input
+ * @param animate orbit the camera, toggled by space
+ */
+static void updateLoop( const std::atomic<bool> &running, glWindow &window, InputState input,
+                        TripleBuffer<ViewSnapshot> &snapshots, bool animate )
+{
+    OrbitCamera camera;
+    u64 sequence = 0;
+    u64 viewVersion = 0;
+    u64 inputSeen = 0;
+    bool viewChanged = true;
+
+    f64 lastTick = now();
+    f64 nextTick = lastTick;
+
+    while (running) {
+        // Read before fetching, so input arriving in between still ends the wait below
+        inputSeen = window.getInputCount();
+
+        bool inputChanged = false;
+        if (window.fetchInput()) {
+            const InputState &next = window.getInput();
+
+            if (input.buttons[0] && next.buttons[0] && (next.cursorX != input.cursorX || next.cursorY != input.cursorY)) {
+                camera.rotate((next.cursorX - input.cursorX) * DRAG_SPEED, (next.cursorY - input.cursorY) * DRAG_SPEED);
+                viewChanged = true;
+            }
+            if (next.scroll != input.scroll) {
+                camera.zoom(next.scroll - input.scroll);
+                viewChanged = true;
+            }
+            if ((next.keyPresses[GLFW_KEY_SPACE] - input.keyPresses[GLFW_KEY_SPACE]) % 2 == 1)
+                animate = !animate;
+
+            viewChanged |= next.width != input.width || next.height != input.height;
+            input = next;
+            inputChanged = true;
+        }
+
+        const f64 time = now();
+        if (animate) {
+            camera.rotate((time - lastTick) * ORBIT_SPEED, 0.0);
+            viewChanged = true;
+        }
+        lastTick = time;
+
+        if ((viewChanged || inputChanged) && input.width > 0 && input.height > 0) {
+            viewVersion += viewChanged ? 1 : 0;
+            snapshots.getWriteBuffer() = { sequence++, viewVersion, time, getFrame(camera, time, input.width, input.height), input };
+            snapshots.publish();
+            Invalidation::requestRedraw();
+            viewChanged = false;
+        }
+
+        if (animate) {
+            // Skip ticks instead of catching up after a stall
+            nextTick = std::max(nextTick + 1.0 / UPDATE_RATE, now());
+            sleepUntil(nextTick);
+        }
+        else {
+            // Nothing moves by itself, sleep until the input changes
+            window.waitForInput(inputSeen);
+            nextTick = now();
+        }
+    }
+}
 
-        vertices.push_back(-S * spacing);
-        vertices.push_back(i * spacing);
-        vertices.push_back(0.0f);
 
-        vertices.push_back(S * spacing);
-        vertices.push_back(i * spacing);
-        vertices.push_back(0.0f);
+/**
+ * Render thread: draws the newest snapshot every vsync, never waiting for the update or input thread.
+ * @param options onDemand: only draw after Invalidation requested a redraw. The scene is kept in an offscreen
+ *                image and only redrawn if the view or the content changed, otherwise the image is
+ *                just copied and the overlay drawn on top.<br>
+ *                tiles: drawn paged within options.budget.
+ */
+static void renderLoop( const std::atomic<bool> &running, glWindow &window, Scene &scene,
+                        GLFWwindow *sharedContext, TripleBuffer<ViewSnapshot> &snapshots, const Options &options )
+{
+    const bool onDemand = options.onDemand;
+    window.makeCurrent();
+    glfwSwapInterval(1);
 
+    {
+        SceneView view(scene);
+        view.setCpuBinning(options.densityCpu);
+        if (!options.tiles.empty())
+            view.addTiles(options.tiles, options.budget);
+        if (!options.stream.empty())
+            view.addStream(options.stream);
+
+        ReloadService reload(scene, sharedContext);
+        reload.watch(view.getSceneShader());
+        reload.watch(view.getLineShader());
+        reload.watch(view.getGridShader());
+        reload.watch(view.getStreamedShader());
+        reload.watch(view.getTubeShader());
+        reload.watch(view.getDensityShader());
+        reload.watch(view.getDensityMaxShader());
+        reload.watch(view.getDensityResolveShader());
+        reload.watchScene();
+
+        Profiler profiler;
+        ProfilerOverlay overlay(profiler);
+
+        std::unique_ptr<Framebuffer> cache;
+        u64 drawnContent = 0;
+        u64 drawnView = 0;
+
+        while (running && !snapshots.fetch())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        u64 requestsSeen = Invalidation::getRedrawRequests();
+        while (running) {
+            if (onDemand) {
+                Invalidation::waitForRedraw(requestsSeen);
+                requestsSeen = Invalidation::getRedrawRequests();
+                if (!running)
+                    break;
+            }
+
+            // Keeps drawing the previous snapshot if the update thread fell behind
+            snapshots.fetch();
+            const ViewSnapshot &snapshot = snapshots.getReadBuffer();
+            const int width = snapshot.input.width;
+            const int height = snapshot.input.height;
+
+            profiler.beginFrame();
+
+            {
+                const ProfileScope scope(profiler, "upload");
+                view.update(reload.applyPending());
+            }
+
+            if (onDemand) {
+                const u64 content = Invalidation::getContentVersion();
+                bool stale = content != drawnContent || snapshot.viewVersion != drawnView;
+
+                if (!cache || cache->getWidth() != width || cache->getHeight() != height) {
+                    cache = std::make_unique<Framebuffer>(width, height, options.samples);
+                    stale = true;
+                }
+
+                if (stale) {
+                    cache->bind();
+                    view.render(snapshot.frame, profiler);
+                    cache->resolve();
+                    drawnContent = content;
+                    drawnView = snapshot.viewVersion;
+                }
+
+                const ProfileScope scope(profiler, "blit");
+                glBlitNamedFramebuffer(cache->getReadID(), 0, 0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, width, height);
+            }
+            else {
+                glViewport(0, 0, width, height);
+                view.render(snapshot.frame, profiler);
+            }
+
+            {
+                const ProfileScope scope(profiler, "overlay");
+                const GpuProfileScope gpuScope(profiler, "overlay");
+                overlay.render(snapshot.input, snapshot.time);
+            }
+
+            {
+                const ProfileScope scope(profiler, "swap");
+                window.swap();
+            }
+
+            profiler.endFrame();
+        }
+    }
 
-        vertices.push_back(0.0f);
-        vertices.push_back(i * spacing);
-        vertices.push_back(-S * spacing);
+    glfwMakeContextCurrent(nullptr);
+}
+
+
+/**
+ * Runs input on the calling (main) thread, updates and rendering on their own threads.
+ */
+void run( glWindow &window, const Options &options )
+{
+    Scene scene;
+    if (!buildScene(scene, options))
+        return;
 
-        vertices.push_back(0.0f);
-        vertices.push_back(i * spacing);
-        vertices.push_back(S * spacing);
+    GLFWwindow *const sharedContext = window.createSharedContext();
+    glfwMakeContextCurrent(nullptr);
 
-        vertices.push_back(0.0f);
-        vertices.push_back(-S * spacing);
-        vertices.push_back(i * spacing);
+    std::atomic<bool> running(true);
+    TripleBuffer<ViewSnapshot> snapshots;
 
-        vertices.push_back(0.0f);
-        vertices.push_back(S * spacing);
-        vertices.push_back(i * spacing);
-    }
+    std::thread update(updateLoop, std::cref(running), std::ref(window), InputState{ }, std::ref(snapshots), !options.onDemand);
+    std::thread render(renderLoop, std::cref(running), std::ref(window), std::ref(scene), sharedContext, std::ref(snapshots), std::cref(options));
 
-    return {std::move(vertices), 3, GL_LINES};
+    // GLFW delivers events on the main thread only, this is the input thread from now on
+    while (!window.shouldClose())
+        glfwWaitEvents();
+
+    running = false;
+    window.wakeInputWaiters();
+    Invalidation::requestRedraw();
+    render.join();
+    update.join();
+
+    glfwDestroyWindow(sharedContext);
+    window.makeCurrent();
 }
 
 
-void run( glWindow &window )
+/**
+ * Renders options.frames frames into an offscreen framebuffer at a fixed 60 Hz time step
+ * and writes them to options.output.
+ */
+int runHeadless( const Options &options )
 {
-    std::vector<Mesh *> meshes;
-    CSVFile circleCSV("res/meshes/geodesicSphere.csv");
-    if (!circleCSV.read(','))
-        return;
+    const HeadlessContext context;
+    if (!context.isValid()) {
+        std::cerr << "Could not create a headless OpenGL context: " << context.getError() << std::endl;
+        return 1;
+    }
 
-    CSVFile spiralCSV("res/meshes/spiral.csv");
-    if (!spiralCSV.read(','))
-        return;
+    const int version = gladLoadGL(HeadlessContext::getProcAddress);
+    printf("GL Version %d.%d (%s)\n", GLAD_VERSION_MAJOR(version), GLAD_VERSION_MINOR(version), glGetString(GL_RENDERER));
+    Shader::enableParallelCompile();
 
-    CSVFile onfCSV("res/meshes/ONF.csv");
-    if (!onfCSV.read(','))
-        return;
+    Scene scene;
+    if (!buildScene(scene, options))
+        return 1;
+
+    SceneView view(scene);
+    view.setCpuBinning(options.densityCpu);
+    if (!options.tiles.empty() && !view.addTiles(options.tiles, options.budget))
+        return 1;
+    if (!options.stream.empty() && !view.addStream(options.stream))
+        return 1;
+    Framebuffer framebuffer(options.width, options.height, options.samples);
 
-    const std::vector<std::pair<std::string, f32>> columns = { { "X", 0.0f }, { "Y", 0.0f }, { "Z", 0.0f }, { "T", 1.0f } };
+    Profiler profiler(static_cast<u32>(std::min<u64>(options.frames, 1u << 16)));
 
-    SmoothICurve circle(circleCSV, columns, { "T", 1.0f }, true);
-    meshes.push_back(&circle);
+    // Destroyed in reverse order: readback delivers its last frames before the writer drains
+    FrameWriter writer(options.output, options.format);
+    FrameReadback readback(options.width, options.height, [&writer]( FramePixels &&pixels ) {
+        writer.write(std::move(pixels));
+    });
 
-    SmoothICurve spiral(spiralCSV, { "T", 1.0f }, { "X", 0.0f }, { "Y", 0.0f }, { "Z", 0.0f }, &circle, true);
-    meshes.push_back(&spiral);
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
 
-    Mesh tbnSpiral(onfCSV, { "T", 1.0f }, { "X", 0.0f }, { "Y", 0.0f }, { "Z", 0.0f }, &spiral, GL_LINES);
-    meshes.push_back(&tbnSpiral);
+    for (u64 f = 0; f < options.frames; f++) {
+        profiler.beginFrame();
 
-    for (Mesh *const mesh : meshes)
-        mesh->push();
+        framebuffer.bind();
+        const f64 time = static_cast<f64>(f) / 60.0;
+        view.render(getFrame(OrbitCamera(time * ORBIT_SPEED), time, options.width, options.height), profiler);
+        framebuffer.resolve();
 
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClearDepth(1.0);
+        {
+            const ProfileScope scope(profiler, "readback");
+            readback.read(framebuffer.getReadID(), f);
+        }
 
-    glfwSwapInterval(1);
+        profiler.endFrame();
+    }
+
+    const auto rendered = clock::now();
+    readback.finish();
+    writer.finish();
+    const auto written = clock::now();
+
+    const f64 renderSeconds = std::chrono::duration<f64>(rendered - start).count();
+    const f64 totalSeconds = std::chrono::duration<f64>(written - start).count();
+    const ProfileStatistics frameTime = profiler.getFrameStatistics();
+
+    std::cout << "[  INFO  ][Render ] " << options.frames << " frames " << options.width << 'x' << options.height
+              << ", render " << static_cast<f64>(options.frames) / renderSeconds << " fps"
+              << " (p50 " << frameTime.p50 * 1e3 << " ms, p95 " << frameTime.p95 * 1e3 << " ms)"
+              << ", written " << static_cast<f64>(writer.getWrittenCount()) / totalSeconds << " fps to \"" << options.output << '"' << std::endl;
+
+    if (!options.tiles.empty()) {
+        const ResidencyStatistics tiles = view.getTileStatistics();
+        std::cout << "[  INFO  ][Tiles  ] " << tiles.drawn << " of " << tiles.visible << " visible tiles drawn, "
+                  << tiles.ramTiles << " in RAM, " << tiles.vramTiles << " on the GPU, "
+                  << tiles.prefetched << " read, " << tiles.uploaded << " uploaded, " << tiles.evicted << " evicted" << std::endl;
+    }
+
+    for (const auto &stream : view.getStreams())
+        std::cout << "[  INFO  ][Stream ] " << stream->getReceived() << " rows received, " << stream->getLost() << " lost" << std::endl;
+
+    return writer.getWrittenCount() == options.frames ? 0 : 1;
+}
 
-    Shader cartesian("./res/shader/cartesian");
-    Shader cartesianSystem("./res/shader/cartesianSystem");
-    Mesh cartesianSystemGrid = createGridPlane(32, 0.5f);
-    cartesianSystemGrid.push();
-
-    constexpr glm::fvec3 up(0.0f, 1.0f, 0.0f);
-
-    glm::dvec3 position(3.0, 3.0, 3.0);
-    glm::dvec2 rotation(M_PI_4, -M_PI_4);
-    glm::dvec2 lastPosition;
-    bool leftClick = false;
-
-    GLFWwindow *const winPtr = window.getPointer();
-    glEnable(GL_MULTISAMPLE);
-    glEnable(GL_LINE_SMOOTH);
-    glEnable(GL_DEPTH_TEST);
-
-    while (!window.shouldClose()) {
-        const glm::dmat4 proj = glm::perspectiveFov<double>(glm::radians(45.0), window.getWidth(), window.getHeight(), 0.03, 1024.0);
-        constexpr glm::dvec3 X = { 1.0f, 0.0f, 0.0f };
-        constexpr glm::dvec3 Y = { 0.0f, 1.0f, 0.0f };
-
-        position.x = sin(glfwGetTime() * 0.125) * M_SQRT1_2 * 3.0;
-        position.y = M_SQRT1_2 * 3.0;
-        position.z = cos(glfwGetTime() * 0.125) * M_SQRT1_2 * 3.0;
-        rotation.x = glfwGetTime() * 0.125;
-
-        const glm::dmat4 ROT = glm::rotate(-rotation.y, X) * glm::rotate(-rotation.x, Y);
-
-        glm::fmat4 MVP = proj * ROT * glm::translate(-position);
-
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        // glDisable(GL_DEPTH_TEST);
-        glLineWidth(1.0f);
-        cartesianSystem.setMatrixFloat4("MVP", MVP);
-        cartesianSystem.Bind();
-        cartesianSystemGrid.render();
-
-        glClear(GL_DEPTH_BUFFER_BIT);
-        glLineWidth(4.0f);
-        render(window, MVP, cartesian, meshes);
-        window.swap();
-        glfwPollEvents();
+
+/**
+ * Parses value as MB into bytes, std::stoull throws if it is no number.
+ * @return false for negative values and ones too large for bytes
+ */
+static bool parseMegabytes( const char *value, u64 &bytes )
+{
+    const u64 megabytes = std::stoull(value);
+    if (value[0] == '-' || megabytes > (~0ull >> 20)) {
+        std::cerr << "Invalid budget " << value << ", expected MB" << std::endl;
+        return false;
+    }
+    bytes = megabytes << 20;
+    return true;
+}
+
+static bool parseOptions( const int argc, char **argv, Options &options )
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--on-demand") == 0) {
+            options.onDemand = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--density-cpu") == 0) {
+            options.densityCpu = true;
+            continue;
+        }
+
+        if (nullptr == value) {
+            std::cerr << "Unknown or incomplete option " << arg << std::endl;
+            return false;
+        }
+        i++;
+
+        try {
+            if (std::strcmp(arg, "--frames") == 0) {
+                options.frames = std::stoull(value);
+            }
+            else if (std::strcmp(arg, "--size") == 0) {
+                if (std::sscanf(value, "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 || options.height <= 0) {
+                    std::cerr << "Invalid size " << value << ", expected WIDTHxHEIGHT" << std::endl;
+                    return false;
+                }
+            }
+            else if (std::strcmp(arg, "--samples") == 0) {
+                options.samples = std::stoi(value);
+            }
+            else if (std::strcmp(arg, "--signal") == 0) {
+                options.signal = value;
+            }
+            else if (std::strcmp(arg, "--density") == 0) {
+                options.density = value;
+            }
+            else if (std::strcmp(arg, "--snapshot") == 0) {
+                options.snapshot = value;
+            }
+            else if (std::strcmp(arg, "--signal-value") == 0) {
+                options.signalValue = value;
+            }
+            else if (std::strcmp(arg, "--stream") == 0) {
+                options.stream = value;
+            }
+            else if (std::strcmp(arg, "--sweep") == 0) {
+                if (std::strcmp(value, "tube") == 0)
+                    options.sweep = MeshSpec::Sweep::Tube;
+                else if (std::strcmp(value, "ribbon") == 0)
+                    options.sweep = MeshSpec::Sweep::Ribbon;
+                else if (std::strcmp(value, "line") != 0) {
+                    std::cerr << "Unknown sweep " << value << ", expected line, tube or ribbon" << std::endl;
+                    return false;
+                }
+            }
+            else if (std::strcmp(arg, "--radius") == 0) {
+                options.radius = std::stof(value);
+                if (!(options.radius > 0.0f)) {
+                    std::cerr << "Invalid radius " << value << ", expected a positive number" << std::endl;
+                    return false;
+                }
+            }
+            else if (std::strcmp(arg, "--tiles") == 0) {
+                options.tiles = value;
+            }
+            else if (std::strcmp(arg, "--make-tiles") == 0) {
+                options.makeTiles = value;
+            }
+            else if (std::strcmp(arg, "--ram-budget") == 0) {
+                if (!parseMegabytes(value, options.budget.ram))
+                    return false;
+            }
+            else if (std::strcmp(arg, "--vram-budget") == 0) {
+                if (!parseMegabytes(value, options.budget.vram))
+                    return false;
+            }
+            else if (std::strcmp(arg, "--output") == 0) {
+                options.output = value;
+            }
+            else if (std::strcmp(arg, "--format") == 0) {
+                if (!FrameWriter::parseFormat(value, options.format)) {
+                    std::cerr << "Unknown frame format " << value << ", expected png or raw" << std::endl;
+                    return false;
+                }
+            }
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &) {
+            std::cerr << "No number for " << arg << ": " << value << std::endl;
+            return false;
+        }
     }
+    return true;
 }
 
 
-int main()
+int main( int argc, char **argv )
 {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--on-demand] [--sweep line|tube|ribbon [--radius R]] [--signal FILE [--signal-value EXPR]] [--density FILE [--density-cpu]] [--snapshot FILE] [--tiles FILE [--ram-budget MB] [--vram-budget MB]] [--stream NAME] [--make-tiles INPUT] [--headless] [--frames N] [--size WxH] [--samples N] [--output DIR] [--format png|raw]" << std::endl;
+        return 1;
+    }
+
+    // Converts INPUT next to it, e.g. data.csv into data.tiles
+    if (!options.makeTiles.empty()) {
+        std::filesystem::path output(options.makeTiles);
+        output.replace_extension(".tiles");
+        return TileFile::convert(options.makeTiles, output.string()) ? 0 : 1;
+    }
+
+    if (options.headless)
+        return runHeadless(options);
+
     if (glfwInit() != GLFW_TRUE) {
-        std::cerr << "Could not initialize GLFW" << std::endl;
+        std::cerr << "Could not initialize GLFW, use --headless without a display" << std::endl;
         return 1;
     }
 
-    glWindow window("Test");
+    // Lines are antialiased by their shader, MSAA only for the rest if asked for
+    glWindow window("Test", 1280, -1, false, 4, 6, options.samples);
 
     const int version = gladLoadGL(glfwGetProcAddress);
     printf("GL Version %d.%d\n", GLAD_VERSION_MAJOR(version), GLAD_VERSION_MINOR(version));
+    Shader::enableParallelCompile();
 
-    run(window);
+    run(window, options);
 
     glfwTerminate();
 
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IO/RingProducer.hpp"
+
+
+struct ProduceOptions {
+    std::string name;
+    f64 rate = 1e6;     // rows per second
+    f64 duration = 0.0; // seconds, 0 until interrupted
+    u64 capacity = 1 << 20;
+};
+
+// Rows are appended in batches this often
+constexpr f64 PRODUCE_INTERVAL = 1e-3;
+
+
+static f64 now()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration<f64>(steady_clock::now() - start).count();
+}
+
+/**
+ * Stand-in for a simulator: row (T, X, Y, Z) of a torus knot, T in seconds at rate rows per second.
+ */
+static void writeKnotRows( const u64 first, const u64 count, const f64 rate, std::vector<f32> &rows )
+{
+    rows.resize(4 * count);
+    for (u64 i = 0; i < count; i++) {
+        const f64 t = static_cast<f64>(first + i) / rate;
+        const f64 angle = 2.0 * std::numbers::pi * t;
+        const f64 radius = 1.0 + 0.3 * std::cos(7.0 * angle);
+        rows[4 * i + 0] = static_cast<f32>(t);
+        rows[4 * i + 1] = static_cast<f32>(radius * std::cos(2.0 * angle));
+        rows[4 * i + 2] = static_cast<f32>(radius * std::sin(2.0 * angle));
+        rows[4 * i + 3] = static_cast<f32>(0.3 * std::sin(7.0 * angle));
+    }
+}
+
+
+static bool parseOptions( const int argc, char **argv, ProduceOptions &options )
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (arg[0] != '-' && options.name.empty()) {
+            options.name = arg;
+            continue;
+        }
+        if (!value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        i++;
+
+        try {
+            if (std::strcmp(arg, "--rate") == 0) {
+                options.rate = std::max(std::stod(value), 1.0);
+            }
+            else if (std::strcmp(arg, "--duration") == 0) {
+                options.duration = std::stod(value);
+            }
+            else if (std::strcmp(arg, "--capacity") == 0) {
+                options.capacity = std::max(std::stoull(value), 2ull);
+            }
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &) {
+            std::cerr << "No number for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    return !options.name.empty();
+}
+
+
+/**
+ * Example of a simulator linking PlottyProducer: appends a torus knot to the SharedRing NAME at --rate rows per
+ * second, e.g. for <code>Plotty --stream NAME</code> in another process, and reports the rate reached every second.
+ */
+int main( int argc, char **argv )
+{
+    ProduceOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " NAME [--rate ROWS] [--duration S] [--capacity ROWS]" << std::endl;
+        return 1;
+    }
+
+    RingProducer producer(options.name, { "T", "X", "Y", "Z" }, options.capacity);
+    if (!producer.isValid())
+        return 1;
+
+    std::cout << "[  INFO  ][Stream ] Producing \"" << options.name << "\" at " << options.rate << " rows/s" << std::endl;
+
+    std::vector<f32> rows;
+    const f64 start = now();
+    f64 nextReport = start + 1.0;
+    u64 reported = 0;
+    for (f64 time = start; options.duration <= 0.0 || time - start < options.duration; time = now()) {
+        const u64 due = static_cast<u64>((time - start) * options.rate);
+        writeKnotRows(producer.getWritten(), due - producer.getWritten(), options.rate, rows);
+        producer.append(rows.data(), due - producer.getWritten());
+
+        if (time >= nextReport) {
+            std::cout << "[  INFO  ][Stream ] " << producer.getWritten() - reported << " rows/s, " << producer.getWritten() << " written" << std::endl;
+            reported = producer.getWritten();
+            nextReport += 1.0;
+        }
+        std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::duration<f64>(time + PRODUCE_INTERVAL - now()));
+    }
+    return 0;
+}